@@ -0,0 +1,120 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <vector>
+
+#include "Rect.h"
+
+/**
+ * Static bounding volume hierarchy of axis-aligned boxes.
+ *
+ * The tree is built once from a list of Rects, after which it can quickly find
+ * all Rects overlapping a given area; queries visit O(log n) nodes plus one per
+ * result, so large numbers of Rects can be stored without slowing down queries
+ * that only touch a few of them.
+ */
+class AabbTree
+{
+public:
+    AabbTree();
+
+    /**
+     * Builds the tree, replacing any previous contents.
+     */
+    void build(const std::vector<Rect>& rects);
+
+    bool isEmpty() const
+    {
+        return items.empty();
+    }
+
+    /**
+     * Calls `callback(const Rect&)` for every Rect that overlaps the given area.
+     *
+     * Rects that only touch the area's edges are not considered to overlap.
+     */
+    template <typename Callback>
+    void query(const Rect& area, Callback&& callback) const
+    {
+        if (nodes.empty())
+        {
+            return;
+        }
+
+        const glm::vec2 areaMin = area.pos - area.extents;
+        const glm::vec2 areaMax = area.pos + area.extents;
+
+        int stack[maxDepth];
+        int stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0)
+        {
+            const Node& node = nodes[stack[--stackSize]];
+            if (!overlaps(node.min, node.max, areaMin, areaMax))
+            {
+                continue;
+            }
+
+            if (node.count > 0)
+            {
+                // Leaf
+                for (int i = node.first; i < node.first + node.count; ++i)
+                {
+                    const Item& item = items[i];
+                    if (overlaps(item.min, item.max, areaMin, areaMax))
+                    {
+                        callback(item.rect);
+                    }
+                }
+            }
+            else
+            {
+                stack[stackSize++] = node.first;
+                stack[stackSize++] = node.first + 1;
+            }
+        }
+    }
+
+private:
+    struct Item
+    {
+        glm::vec2 min;
+        glm::vec2 max;
+        Rect rect;
+    };
+
+    struct Node
+    {
+        glm::vec2 min;
+        glm::vec2 max;
+
+        /** For leaves, the first item; otherwise, the first of 2 adjacent child nodes. */
+        int first;
+
+        /** Number of items in a leaf, or 0 for an internal node. */
+        int count;
+    };
+
+    static bool overlaps(glm::vec2 minA, glm::vec2 maxA, glm::vec2 minB, glm::vec2 maxB)
+    {
+        return minA.x < maxB.x && maxA.x > minB.x && minA.y < maxB.y && maxA.y > minB.y;
+    }
+
+    void buildNode(int nodeIndex, int first, int count);
+
+private:
+    /** Maximum number of items stored in a single leaf. */
+    static constexpr int maxItemsPerLeaf = 4;
+
+    /**
+     * Maximum depth of the tree.
+     *
+     * Nodes are always split in half, so this is enough for any realistic number of items.
+     */
+    static constexpr int maxDepth = 64;
+
+    std::vector<Item> items;
+    std::vector<Node> nodes;
+};
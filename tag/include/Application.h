@@ -3,9 +3,33 @@
 #include <glm/mat4x4.hpp>
 #include <glm/vec2.hpp>
 
+#include <array>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BloomEffect.h"
+#include "BotPlanner.h"
+#include "Camera.h"
+#include "Effects.h"
+#include "FrameLimiter.h"
+#include "FramePacer.h"
+#include "GameModes.h"
 #include "GameRenderer.h"
+#include "InputLatencyTracker.h"
+#include "InputMap.h"
+#include "Levels.h"
+#include "ParticleSystem.h"
 #include "Player.h"
+#include "Rect.h"
+#include "ScreenShake.h"
+#include "ThreadPool.h"
+#include "TimeUtils.h"
+#include "VideoRecorder.h"
 #include "World.h"
+#include "WorldFeed.h"
 
 struct GLFWwindow;
 
@@ -21,7 +45,7 @@ struct WindowProperties
 class Application
 {
 public:
-    Application(GLFWwindow* window, int numPlayers);
+    Application(GLFWwindow* window, int numPlayers, Levels::Level level);
 
     void run();
     bool isRunning() const;
@@ -31,17 +55,212 @@ public:
     void windowResized();
     void toggleFullscreen();
 
+    /**
+     * Starts publishing the world state to the named shared memory block.
+     *
+     * @throws std::runtime_error if the feed could not be created.
+     */
+    void enableWorldFeed(const std::string& name);
+
+    /**
+     * Sets the number of players that should be controlled by AI.
+     *
+     * Bots always control the highest-numbered players.
+     */
+    void setNumBots(int newNumBots);
+
+    /**
+     * Sets how the camera should frame the world.
+     *
+     * @param targetPlayerId Player to follow, for CameraMode::Player.
+     */
+    void setCameraMode(CameraMode mode, int targetPlayerId = 0);
+
+    /**
+     * Splits the screen into one view per player, each with its own camera.
+     */
+    void setSplitScreen(bool enabled);
+
+    /**
+     * Enables or disables the bloom post-process.
+     *
+     * @throws std::runtime_error if bloom could not be enabled.
+     */
+    void setBloomEnabled(bool enabled);
+
+    /**
+     * Starts capturing every rendered frame to the given video file.
+     *
+     * Recording stops when the application exits, or if the window is resized.
+     *
+     * @throws std::runtime_error if the file could not be opened.
+     */
+    void startRecording(const std::string& filename);
+
+    /**
+     * Sets how many frames the driver may queue ahead of the GPU.
+     *
+     * Lower values reduce input latency, at the cost of some throughput.
+     *
+     * @param maxFrames Maximum frames in flight, or 0 to let the driver decide.
+     */
+    void setMaxFramesInFlight(int maxFrames);
+
+    /**
+     * Delays the start of each frame until just before the next vsync, so that input is read as late as possible.
+     *
+     * This only helps with vsync enabled, and with the driver limited to one frame in flight.
+     */
+    void setFramePacingEnabled(bool enabled);
+
+    /**
+     * Sets the rules of the game, and restarts the match with them.
+     */
+    void setGameMode(GameMode mode);
+
+    /**
+     * Enables or disables power-up pickups, and restarts the match.
+     *
+     * Pickups are scattered across the level, and come back some time after being collected.
+     */
+    void setPowerUpsEnabled(bool enabled);
+
+    /**
+     * Replaces the player controls; takes effect from the next key press.
+     */
+    void setInputMap(const InputMap& newInputMap);
+
+    /**
+     * Starts measuring the latency from each player key press until its result is presented.
+     */
+    void enableInputLatencyTracking();
+
+    /**
+     * Gets the input latency measured so far, if tracking is enabled.
+     */
+    const InputLatencyTracker* getInputLatency() const
+    {
+        return inputLatency.get();
+    }
+
 private:
+    /**
+     * Player input waiting to be applied.
+     */
+    struct InputEvent
+    {
+        Direction dir;
+
+        /** Time at which the input was received, in seconds. */
+        double time;
+    };
+
     void restart();
     void tag(Player& a, Player& b);
 
+    /**
+     * Ticks every player under the rules of the given GameModes policy, and declares a winner if anyone runs out
+     * of time.
+     *
+     * @return false if the match has ended.
+     */
+    template <typename Mode>
+    bool movePlayers();
+    void updateBots();
+
+    /**
+     * Places pickups at regular intervals across the level, wherever there is space.
+     */
+    void spawnPickups();
+
+    /**
+     * Gives pickups to any players touching them.
+     */
+    void collectPickups();
+
+    /**
+     * Handles an event scheduled for this tick.
+     */
+    void onEvent(const GameEvent& event);
+
+    void applyPowerUp(Player& player, PowerUp powerUp);
+
+    /**
+     * Queues a direction change to be applied to a player on a later tick.
+     */
+    void queuePlayerInput(int playerId, Direction dir, double time);
+
+    /**
+     * Applies all queued input, in order.
+     */
+    void applyInput();
+
+    void resetWorld(int numPlayers);
+
+    /**
+     * Creates the cameras needed for the current view mode and number of players.
+     */
+    void layoutCameras();
+
+    static glm::ivec2 getWindowSize(GLFWwindow* window);
+
 private:
-    static constexpr glm::vec2 worldSize { 24.f, 18.f };
+    /**
+     * Time that bots may spend thinking each tick, shared between all bots.
+     */
+    static constexpr std::chrono::milliseconds botBudgetPerTick { 4 };
+
+    /**
+     * Maximum number of particles that can exist at once.
+     */
+    static constexpr int maxParticles = 1 << 17;
+
+    /**
+     * Distance between pickups, in world units.
+     */
+    static constexpr float pickupSpacing = 6.f;
+
+    /**
+     * Time after a pickup is collected before it comes back, in ticks.
+     */
+    static constexpr uint32_t pickupRespawnTicks = 10 * TimeUtils::fps;
+
+    /**
+     * Duration of a speed boost, in ticks.
+     */
+    static constexpr uint32_t speedBoostTicks = 3 * TimeUtils::fps;
 
     GLFWwindow* window;
     WindowProperties windowProps;
 
     World world;
+    std::vector<Camera> cameras;
+    CameraMode cameraMode = CameraMode::World;
+    int cameraTargetPlayerId = 0;
+    bool splitScreen = false;
+    ParticleSystem particles { maxParticles };
+    ScreenShake screenShake;
+    Effects effects { particles, screenShake };
     GameRenderer renderer;
+    std::unique_ptr<BloomEffect> bloom;
+    std::unique_ptr<VideoRecorder> recorder;
+    std::unique_ptr<FrameLimiter> frameLimiter;
+    std::unique_ptr<FramePacer> framePacer;
+    InputMap inputMap;
+
+    /** Input queued for each player, oldest first. */
+    std::array<std::deque<InputEvent>, World::maxPlayers> pendingInput;
+    std::unique_ptr<InputLatencyTracker> inputLatency;
+    std::unique_ptr<WorldFeed> worldFeed;
+    ThreadPool threadPool;
+    BotPlanner botPlanner { threadPool };
+    int numBots = 0;
     bool playing = true;
+    bool powerUpsEnabled = false;
+
+    /** Timer that ends each player's speed boost, so that it can be extended. */
+    std::array<TimerHandle, World::maxPlayers> speedBoostTimers;
+
+    /** Instantiation of movePlayers for the current match's game mode. */
+    bool (Application::*movePlayersFunction)() = &Application::movePlayers<GameModes::Classic>;
 };
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * Refers to an entity within an Archetype.
+ *
+ * Handles stay valid while the entity exists, even as other entities are
+ * spawned and despawned around it. Once the entity is despawned, its slot
+ * may be reused, but the slot's generation changes, so old handles to it
+ * are recognised as stale rather than referring to the new entity.
+ */
+struct EntityHandle
+{
+    static constexpr uint32_t invalidIndex = 0xffffffffu;
+
+    uint32_t index = invalidIndex;
+    uint32_t generation = 0;
+
+    bool operator==(const EntityHandle& other) const = default;
+};
+
+/**
+ * Collection of entities that all have the same set of components.
+ *
+ * Each component type is stored in its own dense array, so iterating over
+ * every entity touches contiguous memory only, with no gaps. Spawning
+ * appends to the arrays, and despawning moves the last entity into the gap,
+ * so both are O(1); entities therefore do not stay in spawn order.
+ *
+ * A sparse table of slots maps each handle to the entity's current position
+ * in the dense arrays.
+ */
+template <typename... Components>
+class Archetype
+{
+public:
+    /**
+     * Adds an entity with the given components.
+     */
+    EntityHandle spawn(Components... newComponents)
+    {
+        uint32_t slotIndex;
+        if (freeSlots.empty())
+        {
+            slotIndex = static_cast<uint32_t>(slots.size());
+            slots.push_back({});
+        }
+        else
+        {
+            slotIndex = freeSlots.back();
+            freeSlots.pop_back();
+        }
+
+        Slot& slot = slots[slotIndex];
+        slot.denseIndex = static_cast<uint32_t>(denseToSlot.size());
+        denseToSlot.push_back(slotIndex);
+        std::apply([&](auto&... arrays) { (arrays.push_back(std::move(newComponents)), ...); }, components);
+        ++version;
+
+        return { slotIndex, slot.generation };
+    }
+
+    /**
+     * Removes an entity.
+     *
+     * @return false if the handle was stale, in which case nothing is removed.
+     */
+    bool despawn(EntityHandle handle)
+    {
+        if (!contains(handle))
+        {
+            return false;
+        }
+
+        removeAt(slots[handle.index].denseIndex);
+        return true;
+    }
+
+    /**
+     * Determines whether the handle refers to an entity that still exists.
+     */
+    bool contains(EntityHandle handle) const
+    {
+        return handle.index < slots.size() && slots[handle.index].generation == handle.generation
+                && slots[handle.index].denseIndex != freeDenseIndex;
+    }
+
+    /**
+     * Gets one of an entity's components, or nullptr if the handle is stale.
+     */
+    template <typename Component>
+    Component* get(EntityHandle handle)
+    {
+        if (!contains(handle))
+        {
+            return nullptr;
+        }
+        return &std::get<std::vector<Component>>(components)[slots[handle.index].denseIndex];
+    }
+
+    /**
+     * Calls `callback(Components&...)` for every entity.
+     *
+     * Entities must not be spawned or despawned during iteration.
+     */
+    template <typename Callback>
+    void forEach(Callback&& callback)
+    {
+        for (size_t i = 0; i < denseToSlot.size(); ++i)
+        {
+            std::apply([&](auto&... arrays) { callback(arrays[i]...); }, components);
+        }
+    }
+
+    /**
+     * Calls `callback(const Components&...)` for every entity.
+     */
+    template <typename Callback>
+    void forEach(Callback&& callback) const
+    {
+        for (size_t i = 0; i < denseToSlot.size(); ++i)
+        {
+            std::apply([&](const auto&... arrays) { callback(arrays[i]...); }, components);
+        }
+    }
+
+    /**
+     * Calls `predicate(Components&...)` for every entity, and despawns those for which it returns true.
+     *
+     * Entities are visited from last to first, so that each removal only moves an entity that has already been
+     * visited.
+     */
+    template <typename Predicate>
+    void despawnIf(Predicate&& predicate)
+    {
+        for (size_t i = denseToSlot.size(); i-- > 0;)
+        {
+            bool remove = std::apply([&](auto&... arrays) { return predicate(arrays[i]...); }, components);
+            if (remove)
+            {
+                removeAt(static_cast<uint32_t>(i));
+            }
+        }
+    }
+
+    /**
+     * Removes every entity, invalidating all handles.
+     */
+    void clear()
+    {
+        while (!denseToSlot.empty())
+        {
+            removeAt(static_cast<uint32_t>(denseToSlot.size() - 1));
+        }
+    }
+
+    /**
+     * Allocates enough space for the given number of entities, so that spawning them never reallocates.
+     */
+    void reserve(size_t capacity)
+    {
+        std::apply([&](auto&... arrays) { (arrays.reserve(capacity), ...); }, components);
+        denseToSlot.reserve(capacity);
+        slots.reserve(capacity);
+        freeSlots.reserve(capacity);
+    }
+
+    int size() const
+    {
+        return static_cast<int>(denseToSlot.size());
+    }
+
+    bool empty() const
+    {
+        return denseToSlot.empty();
+    }
+
+    /**
+     * Incremented whenever an entity is spawned or despawned, so that anything built from the entities knows when
+     * to rebuild.
+     *
+     * Components modified in place do not change the version.
+     */
+    uint32_t getVersion() const
+    {
+        return version;
+    }
+
+private:
+    struct Slot
+    {
+        /** Position of the entity in the dense arrays, or freeDenseIndex if the slot is unused. */
+        uint32_t denseIndex = freeDenseIndex;
+
+        /** Incremented whenever the slot's entity is despawned. */
+        uint32_t generation = 0;
+    };
+
+    /**
+     * Removes the entity at the given position, by moving the last entity into its place.
+     */
+    void removeAt(uint32_t denseIndex)
+    {
+        uint32_t slotIndex = denseToSlot[denseIndex];
+        uint32_t lastIndex = static_cast<uint32_t>(denseToSlot.size() - 1);
+
+        if (denseIndex != lastIndex)
+        {
+            std::apply(
+                    [&](auto&... arrays) { ((arrays[denseIndex] = std::move(arrays[lastIndex])), ...); }, components);
+            denseToSlot[denseIndex] = denseToSlot[lastIndex];
+            slots[denseToSlot[denseIndex]].denseIndex = denseIndex;
+        }
+
+        std::apply([](auto&... arrays) { (arrays.pop_back(), ...); }, components);
+        denseToSlot.pop_back();
+
+        Slot& slot = slots[slotIndex];
+        slot.denseIndex = freeDenseIndex;
+        ++slot.generation;
+        freeSlots.push_back(slotIndex);
+        ++version;
+    }
+
+private:
+    static constexpr uint32_t freeDenseIndex = 0xffffffffu;
+
+    /** One dense array per component type. */
+    std::tuple<std::vector<Components>...> components;
+
+    /** Slot of the entity at each position in the dense arrays. */
+    std::vector<uint32_t> denseToSlot;
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    uint32_t version = 0;
+};
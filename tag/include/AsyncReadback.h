@@ -0,0 +1,71 @@
+#pragma once
+
+#include <gl/glew.h>
+
+#include <vector>
+
+#include "ImageUtils.h"
+
+/**
+ * Reads back the contents of the bound framebuffer without stalling the GPU.
+ *
+ * Each request copies the framebuffer into one of a ring of pixel buffers,
+ * and a fence records when the copy is complete. Results are collected later
+ * by polling, by which time the GPU has usually finished, so mapping the
+ * buffer does not need to wait.
+ *
+ * If every buffer is still waiting to be collected, new requests are dropped
+ * rather than waiting for the GPU.
+ */
+class AsyncReadback
+{
+public:
+    AsyncReadback(int width, int height, int numBuffers);
+
+    ~AsyncReadback();
+
+    // Disable moving / copying
+    AsyncReadback(const AsyncReadback& other) = delete;
+    AsyncReadback(AsyncReadback&& other) = delete;
+    AsyncReadback& operator=(const AsyncReadback& other) = delete;
+    AsyncReadback& operator=(AsyncReadback&& other) = delete;
+
+    /**
+     * Starts copying the bound framebuffer.
+     *
+     * @return False if the request was dropped because every buffer is in use.
+     */
+    bool request();
+
+    /**
+     * Collects the oldest outstanding request, if it is complete.
+     *
+     * @param image Receives the pixels, top row first.
+     * @param wait Whether to block until the oldest request is complete.
+     * @return True if an image was collected.
+     */
+    bool poll(Image& image, bool wait);
+
+    /**
+     * Gets the number of requests that have not yet been collected.
+     */
+    int getNumPending() const
+    {
+        return numPending;
+    }
+
+private:
+    struct Slot
+    {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+    };
+
+    int width;
+    int height;
+    std::vector<Slot> slots;
+
+    /** Index of the oldest outstanding request. */
+    int oldest = 0;
+    int numPending = 0;
+};
@@ -0,0 +1,81 @@
+/*
+ * C API for stepping many independent games at once, for training bots.
+ *
+ * A TagBatchEnv owns N worlds with the same number of players. Each call to
+ * tagEnvStep advances every world by one tick, reading actions from and
+ * writing results to caller-owned contiguous buffers. No memory is allocated
+ * after tagEnvCreate.
+ *
+ * Buffer layouts (all row-major):
+ *  - actions:      [numEnvs][numPlayers] values in [0, TAG_ENV_NUM_ACTIONS)
+ *  - observations: [numEnvs][numPlayers][TAG_ENV_OBS_PER_PLAYER]
+ *  - rewards:      [numEnvs][numPlayers]
+ *  - dones:        [numEnvs]
+ *
+ * Actions map to the Direction enum: 0 = none, 1 = up, 2 = down, 3 = left,
+ * 4 = right. Unlike the keyboard controls, actions are absolute, so repeating
+ * an action keeps the player moving.
+ *
+ * When a game finishes (or reaches TAG_ENV_MAX_EPISODE_TICKS), its done flag
+ * is set and it is reset immediately; the observations written for that
+ * environment are the first observations of the new game.
+ */
+
+#ifndef TAG_BATCH_ENV_H
+#define TAG_BATCH_ENV_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TAG_ENV_NUM_ACTIONS 5
+
+/*
+ * Observation values per player:
+ *  - x, y: position, normalized to [-1, 1] across the world
+ *  - speed: current speed relative to the base speed
+ *  - tagged: 1 if this player is "it", else 0
+ *  - timeRatio: fraction of this player's time remaining
+ */
+#define TAG_ENV_OBS_PER_PLAYER 5
+
+/* Games that last longer than this are cut short (2 minutes). */
+#define TAG_ENV_MAX_EPISODE_TICKS (60 * 120)
+
+typedef struct TagBatchEnv TagBatchEnv;
+
+/**
+ * Creates a batch of environments.
+ *
+ * Returns NULL if the arguments are invalid or memory could not be allocated.
+ */
+TagBatchEnv* tagEnvCreate(int numEnvs, int numPlayers, uint32_t seed);
+
+void tagEnvDestroy(TagBatchEnv* env);
+
+int tagEnvGetNumEnvs(const TagBatchEnv* env);
+
+int tagEnvGetNumPlayers(const TagBatchEnv* env);
+
+/**
+ * Resets every environment, and writes the initial observations.
+ */
+void tagEnvReset(TagBatchEnv* env, float* observations);
+
+/**
+ * Advances every environment by one tick.
+ *
+ * Rewards are given per player: the change in that player's score under the
+ * game mode's rules, as a fraction of the maximum time, plus 1 for winning or
+ * -1 for losing when the game ends. In Classic, the score change is the time
+ * that ran out this tick.
+ */
+void tagEnvStep(TagBatchEnv* env, const uint8_t* actions, float* observations, float* rewards, uint8_t* dones);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TAG_BATCH_ENV_H
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Performance benchmarks that can be run from the command line.
+ *
+ * These print their results to stdout. All but the render benchmark run without a window.
+ */
+namespace Benchmarks {
+
+/**
+ * Settings for the render benchmark.
+ */
+struct RenderOptions
+{
+    int numPlayers = 2;
+
+    /** Number of extra boxes to draw, to increase the load. */
+    int numDecorations = 0;
+
+    double durationSeconds = 10.0;
+
+    /** File to which results are written; if empty, results are written to stdout. */
+    std::string outputFilename;
+};
+
+/**
+ * Runs the named benchmark.
+ *
+ * @param renderOptions Settings used if the render benchmark is selected.
+ * @return Exit code for the application.
+ */
+int run(const std::string& name, const RenderOptions& renderOptions = {});
+
+/**
+ * Measures how many bot rollouts can be performed per second, for increasing numbers of threads.
+ */
+int runBotBenchmark();
+
+/**
+ * Measures how many environment steps per second the batch environment API can perform on one thread.
+ */
+int runBatchEnvBenchmark();
+
+/**
+ * Measures FlowField build and lookup costs for a range of grid sizes and agent counts.
+ */
+int runFlowFieldBenchmark();
+
+/**
+ * Measures the cost of moving players through mazes with increasing numbers of walls.
+ */
+int runObstacleBenchmark();
+
+/**
+ * Measures load times, streaming costs and memory use for level files of increasing size.
+ */
+int runLevelStreamBenchmark();
+
+/**
+ * Measures the cost of updating large numbers of particles.
+ */
+int runParticleBenchmark();
+
+/**
+ * Measures the cost of firing and cancelling large numbers of timers, and checks that timers due on the same tick
+ * can cancel each other.
+ */
+int runTimerBenchmark();
+
+/**
+ * Plays a scripted match in a window, as fast as possible, and reports frame, tick, render and swap time
+ * percentiles as JSON.
+ *
+ * Unlike the other benchmarks, this opens a window, since it measures the whole frame including presentation.
+ */
+int runRenderBenchmark(const RenderOptions& options);
+
+}  // namespace Benchmarks
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <gl/glew.h>
+
+/**
+ * Post-process that makes bright parts of the scene glow.
+ *
+ * The scene is rendered into an offscreen buffer. Its brightest parts are
+ * extracted at half resolution, blurred at half and quarter resolution,
+ * and then added back on top of the scene as it is drawn to the window.
+ * Working at reduced resolution keeps the cost low enough for software
+ * renderers.
+ *
+ * The GPU time spent on the effect is measured with timer queries, and
+ * reported periodically against a budget.
+ */
+class BloomEffect
+{
+public:
+    /**
+     * Constructs a BloomEffect for a window of the given size.
+     *
+     * @throws std::runtime_error if the offscreen buffers could not be created.
+     */
+    BloomEffect(int width, int height);
+
+    ~BloomEffect();
+
+    // Disable moving / copying
+    BloomEffect(const BloomEffect& other) = delete;
+    BloomEffect(BloomEffect&& other) = delete;
+    BloomEffect& operator=(const BloomEffect& other) = delete;
+    BloomEffect& operator=(BloomEffect&& other) = delete;
+
+    /**
+     * Recreates the offscreen buffers for a new window size.
+     *
+     * @throws std::runtime_error if the offscreen buffers could not be created.
+     */
+    void resize(int width, int height);
+
+    /**
+     * Redirects all rendering into the offscreen scene buffer.
+     */
+    void begin();
+
+    /**
+     * Applies bloom to everything rendered since `begin`, and draws the result to the window.
+     */
+    void end();
+
+    /**
+     * Gets the average GPU time spent on the effect over the last reporting period, in milliseconds.
+     */
+    double getGpuTimeMs() const
+    {
+        return lastGpuTimeMs;
+    }
+
+private:
+    struct RenderTarget
+    {
+        GLuint fbo = 0;
+        GLuint texture = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    static void createTarget(RenderTarget& target, int width, int height);
+    static void destroyTarget(RenderTarget& target);
+
+    /**
+     * Draws a fullscreen triangle into the given target, using whatever program is in use.
+     */
+    void drawToTarget(const RenderTarget& target) const;
+
+    /**
+     * Blurs the given target in place, using a scratch target of the same size.
+     */
+    void blur(const RenderTarget& target, const RenderTarget& scratch) const;
+
+    /**
+     * Collects the result of the oldest timer query, if it is ready, without stalling.
+     */
+    void collectGpuTime();
+
+private:
+    /**
+     * Brightness above which colours start to bloom.
+     *
+     * Colours are stored in floating-point, so overlapping additive effects can exceed 1.
+     */
+    static constexpr float threshold = 0.9f;
+
+    /**
+     * Range below the threshold over which bloom fades in.
+     */
+    static constexpr float knee = 0.3f;
+
+    /**
+     * Strength of the bloom when added back onto the scene.
+     */
+    static constexpr float strength = 0.8f;
+
+    /**
+     * GPU time that the effect should fit within, in milliseconds.
+     */
+    static constexpr double gpuBudgetMs = 1.0;
+
+    /**
+     * Number of frames between each GPU time report.
+     */
+    static constexpr int framesPerReport = 600;
+
+    /**
+     * Number of timer queries in flight, so that we read results from a few frames ago instead of waiting.
+     */
+    static constexpr int numTimerQueries = 4;
+
+    RenderTarget scene;
+    RenderTarget halfTarget;
+    RenderTarget halfScratch;
+    RenderTarget quarterTarget;
+    RenderTarget quarterScratch;
+
+    /**
+     * Empty VAO; the core profile needs one bound to draw, even without vertex attributes.
+     */
+    GLuint emptyVao;
+
+    GLuint timerQueries[numTimerQueries];
+    int frameIndex = 0;
+
+    double gpuTimeTotalMs = 0.0;
+    int numGpuTimeSamples = 0;
+    double lastGpuTimeMs = 0.0;
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "Player.h"
+#include "SimState.h"
+
+class ThreadPool;
+class World;
+
+/**
+ * Chooses directions for AI-controlled players using Monte Carlo rollouts.
+ *
+ * For each possible Direction, the planner clones the current state, applies
+ * that Direction, and plays the game forward for a short time using a simple
+ * policy for every player. The Direction with the best average outcome wins.
+ *
+ * Rollouts are shared between all threads in the pool, and continue until the
+ * time budget runs out, so the bots get stronger with more cores.
+ */
+class BotPlanner
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int numDirections = 5;
+
+    /** Number of frames to simulate in each rollout. */
+    static constexpr int rolloutLength = 90;
+
+    /** Number of frames for which the chosen Direction is held before the rollout policy takes over. */
+    static constexpr int commitLength = 12;
+
+    BotPlanner(ThreadPool& threadPool);
+
+    /**
+     * Sets the World whose FlowFields should guide the rollout policy.
+     *
+     * The fields must be kept up to date by the caller. Without a World, players
+     * in rollouts move in a straight line, ignoring any obstacles.
+     */
+    void setWorld(const World* newWorld);
+
+    /**
+     * Picks the best Direction for the given player.
+     *
+     * This blocks until the time budget has elapsed. If not every Direction
+     * could be evaluated in that time, the player's current Direction is kept.
+     */
+    Direction chooseDirection(const SimState& state, int playerIndex, Clock::duration budget);
+
+    /** Total number of rollouts performed so far. */
+    uint64_t getNumRollouts() const
+    {
+        return numRollouts;
+    }
+
+private:
+    struct ActionStats
+    {
+        std::array<double, numDirections> totalScore {};
+        std::array<int, numDirections> numSamples {};
+    };
+
+    /**
+     * Plays out a single rollout, returning a score in the range [-1, 1] from the point of view of the given player.
+     *
+     * The rollout is judged by the rules of the given GameModes policy.
+     */
+    template <typename Mode>
+    float rollout(SimState state, int playerIndex, Direction firstDir, uint32_t seed) const;
+
+    /**
+     * Cheap policy used to move every player during rollouts.
+     *
+     * The tagged player chases the nearest player; everyone else runs away from the tagged player.
+     * Some randomness is mixed in so that rollouts explore different futures.
+     *
+     * FlowFields are built from the real positions at the start of the tick, so
+     * they get less accurate as a rollout progresses, but this is good enough to
+     * steer around obstacles.
+     */
+    Direction rolloutPolicy(SimState& state, int playerIndex) const;
+
+    /**
+     * Scores a state in the range [-1, 1] from the point of view of the given player, by the player's lead under the
+     * given GameModes policy.
+     */
+    template <typename Mode>
+    static float evaluate(const SimState& state, int playerIndex);
+
+private:
+    ThreadPool& threadPool;
+    const World* world = nullptr;
+    std::atomic<uint64_t> numRollouts = 0;
+    uint32_t nextSeed = 1;
+};
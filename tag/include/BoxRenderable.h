@@ -9,6 +9,35 @@ struct Rect;
 
 class BoxRenderScope;
 
+/**
+ * Contiguous range of boxes within a BoxRenderable.
+ */
+struct BoxRange
+{
+    int firstBox = 0;
+    int numBoxes = 0;
+};
+
+/**
+ * Shape parameters for a box, evaluated per-pixel by the BoxShader.
+ *
+ * The default style is a plain, sharp-cornered box.
+ */
+struct BoxStyle
+{
+    /** Radius of the rounded corners, in world units. */
+    float cornerRadius = 0.f;
+
+    /** Width of the outline, in world units; if zero, the box is filled. */
+    float outlineWidth = 0.f;
+
+    /** Distance that the glow extends beyond the edge of the box, in world units. */
+    float glowRadius = 0.f;
+
+    /** Strength of the pulse (0-1), which brightens the box and its glow over time. */
+    float pulse = 0.f;
+};
+
 /**
  * Class that allows one or more coloured boxes to be rendered.
  *
@@ -21,6 +50,8 @@ class BoxRenderable
 public:
     static constexpr int numVertexDimensions = 2;  // x, y
     static constexpr int numColorDimensions = 4;   // r, g, b, a
+    static constexpr int numShapeDimensions = 4;   // local x, local y, half-width, half-height
+    static constexpr int numStyleDimensions = 4;   // corner radius, outline width, glow radius, pulse
     static constexpr int numVerticesPerBox = 4;
 
     /**
@@ -40,7 +71,12 @@ public:
 
     BoxRenderScope bind();
     void reset();
-    void addBox(const Rect& rect, const Color& color);
+    void addBox(const Rect& rect, const Color& color, const BoxStyle& style = {});
+
+    int getNumBoxes() const
+    {
+        return numBoxes;
+    }
 
 private:
     /*
@@ -62,10 +98,14 @@ private:
     GLuint vao;
     GLuint positionVbo;
     GLuint colorVbo;
+    GLuint shapeVbo;
+    GLuint styleVbo;
     GLuint ibo;
 
     std::vector<GLfloat> vertexData;
     std::vector<GLfloat> colorData;
+    std::vector<GLfloat> shapeData;
+    std::vector<GLfloat> styleData;
 
     GLenum drawMode;
 
@@ -73,6 +113,10 @@ private:
 
     int maxBoxes;
     int numBoxes = 0;
+
+    /** Scratch space used when drawing multiple ranges at once. */
+    std::vector<GLsizei> multiDrawCounts;
+    std::vector<const void*> multiDrawOffsets;
 };
 
 /**
@@ -90,6 +134,16 @@ public:
     void update() const;
     void render() const;
 
+    /**
+     * Renders a subset of the boxes.
+     */
+    void render(const BoxRange& range) const;
+
+    /**
+     * Renders several subsets of the boxes, in a single draw call.
+     */
+    void render(const std::vector<BoxRange>& ranges) const;
+
 private:
     BoxRenderScope(BoxRenderable* boxRenderable);
 
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include "Rect.h"
+
+class World;
+
+enum class CameraMode
+{
+    // Frames the whole world, which never moves
+    World,
+
+    // Follows every player, zooming out to keep them all in view
+    Group,
+
+    // Follows a single player
+    Player,
+};
+
+/**
+ * Decides which part of the world is on screen.
+ *
+ * The camera's frame is the area of the world it is looking at. Frames always
+ * have the same aspect ratio, so they can be rendered to a fixed viewport, but
+ * their size can change as the camera zooms in or out.
+ */
+class Camera
+{
+public:
+    Camera(glm::vec2 worldSize);
+
+    /**
+     * Switches mode, jumping straight to the new frame.
+     *
+     * @param targetPlayerId Player to follow, for CameraMode::Player.
+     */
+    void setMode(const World& world, CameraMode newMode, int targetPlayerId = 0);
+
+    CameraMode getMode() const
+    {
+        return mode;
+    }
+
+    /**
+     * Sets the shape of the frame when following players.
+     *
+     * In CameraMode::World, the frame always matches the shape of the world.
+     */
+    void setAspectRatio(float newAspectRatio);
+
+    /**
+     * Moves the camera towards its targets. This should be called once per tick.
+     */
+    void update(const World& world);
+
+    /**
+     * Moves the camera straight to its targets.
+     */
+    void snap(const World& world);
+
+    /**
+     * Gets the area of the world that the camera is looking at.
+     */
+    const Rect& getFrame() const
+    {
+        return frame;
+    }
+
+    /**
+     * Gets the frame size when the camera is fully zoomed in.
+     *
+     * This never changes, so it is a stable reference for laying out the UI.
+     */
+    glm::vec2 getBaseExtents() const
+    {
+        return baseExtents;
+    }
+
+    float getAspectRatio() const
+    {
+        return baseExtents.x / baseExtents.y;
+    }
+
+public:
+    /**
+     * Frame size used when following players, chosen to match the classic arena.
+     *
+     * The height is fixed, but the width changes to suit the aspect ratio.
+     */
+    static constexpr glm::vec2 followExtents { 12.f, 9.f };
+
+private:
+    /**
+     * Determines where the camera should be, given the current positions of its targets.
+     */
+    Rect findTargetFrame(const World& world) const;
+
+    void updateBaseExtents();
+
+private:
+    /**
+     * Space to keep clear around targets, in world units.
+     */
+    static constexpr float targetMargin = 3.f;
+
+    /**
+     * Furthest the camera may zoom out, relative to its base size.
+     */
+    static constexpr float maxZoom = 3.f;
+
+    /**
+     * Fraction of the remaining distance to the target frame covered each tick.
+     */
+    static constexpr float followRate = 0.15f;
+
+    glm::vec2 worldExtents;
+    CameraMode mode = CameraMode::World;
+    int targetPlayerId = 0;
+    float followAspectRatio = followExtents.x / followExtents.y;
+    glm::vec2 baseExtents;
+    Rect frame;
+};
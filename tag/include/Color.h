@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 struct Color
 {
     float r;
@@ -9,6 +11,13 @@ struct Color
 
     Color(float r, float g, float b, float a);
 
+    bool operator==(const Color& other) const = default;
+
+    /**
+     * Packs this colour into 4 bytes, for use with GL_UNSIGNED_BYTE RGBA vertex attributes.
+     */
+    uint32_t pack() const;
+
     static const Color white;
     static const Color red;
     static const Color green;
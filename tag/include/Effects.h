@@ -0,0 +1,86 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <random>
+
+#include "ParticleSystem.h"
+#include "Player.h"
+#include "ScreenShake.h"
+#include "World.h"
+
+/**
+ * Spawns particle effects, and shakes the screen, in response to gameplay events.
+ */
+class Effects
+{
+public:
+    Effects(ParticleSystem& particles, ScreenShake& screenShake);
+
+    /**
+     * Moves all effects forward by one tick.
+     *
+     * This should be called every tick, even if the game is not in progress.
+     */
+    void tick(const World& world);
+
+    /**
+     * Removes all effects, e.g. when the game is restarted.
+     */
+    void reset();
+
+    /**
+     * Called when a player becomes tagged.
+     *
+     * Particles burst from where the players touched, and the screen is knocked the way the tagged player was hit.
+     */
+    void onTag(const Player& tagger, const Player& taggedPlayer);
+
+    /**
+     * Called when a player wins the game.
+     */
+    void onWin(const Player& winner);
+
+private:
+    void emitTagPulse(const Player& taggedPlayer);
+    void emitCelebration(const Player& winner);
+
+private:
+    /**
+     * Number of ticks between each pulse around the tagged player.
+     */
+    static constexpr int ticksPerPulse = 30;
+
+    /**
+     * Number of ticks between each firework once a player has won.
+     */
+    static constexpr int ticksPerFirework = 12;
+
+    /**
+     * Distance from the winner at which fireworks may go off, in world units.
+     */
+    static constexpr float fireworkRange = 5.f;
+
+    /**
+     * Speed at which the screen is knocked when a player is tagged, in world units per second.
+     */
+    static constexpr float tagShakeImpulse = 12.f;
+
+    /**
+     * Speed at which the screen is knocked when a player wins, in world units per second.
+     */
+    static constexpr float winShakeImpulse = 20.f;
+
+    /**
+     * Strength of the border flash when a player is tagged.
+     */
+    static constexpr float tagFlashIntensity = 0.8f;
+
+    static constexpr int noWinner = -1;
+
+    ParticleSystem& particles;
+    ScreenShake& screenShake;
+    std::mt19937 rng;
+    int tickCount = 0;
+    int winnerId = noWinner;
+};
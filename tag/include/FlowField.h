@@ -0,0 +1,201 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "Player.h"
+#include "Rect.h"
+
+/**
+ * Grid that divides the world into cells, some of which may be blocked.
+ *
+ * Cells are addressed from the top-left corner of the world. Internally, the
+ * grid is surrounded by a border of blocked cells, so that searches never need
+ * to check whether a neighbour is in bounds; cell indices include this border.
+ */
+class NavGrid
+{
+public:
+    NavGrid(glm::vec2 worldSize, float cellSize);
+
+    void setBlocked(int cellX, int cellY, bool blocked);
+
+    /**
+     * Blocks every cell whose centre lies inside the given area.
+     */
+    void blockArea(const Rect& area);
+
+    /**
+     * Unblocks every cell.
+     */
+    void clear();
+
+    bool isBlocked(int cellIndex) const
+    {
+        return blocked[cellIndex] != 0;
+    }
+
+    /**
+     * Gets the index of the cell containing the given position, clamped to the grid.
+     */
+    int getCellIndex(glm::vec2 pos) const;
+
+    int getWidth() const
+    {
+        return width;
+    }
+
+    int getHeight() const
+    {
+        return height;
+    }
+
+    /**
+     * Gets the difference in index between vertically adjacent cells.
+     */
+    int getStride() const
+    {
+        return width + 2;
+    }
+
+    /**
+     * Gets the total number of cells, including the border.
+     */
+    int getNumCells() const
+    {
+        return (width + 2) * (height + 2);
+    }
+
+    /**
+     * Incremented whenever a cell changes, so that flow fields know when to rebuild.
+     */
+    uint32_t getVersion() const
+    {
+        return version;
+    }
+
+private:
+    glm::vec2 worldExtents;
+    float cellSize;
+    int width;
+    int height;
+    std::vector<uint8_t> blocked;
+    uint32_t version = 0;
+};
+
+/**
+ * Distance field over a NavGrid, leading towards a single target.
+ *
+ * This is built once per target (e.g. per tick), after which any number of
+ * agents can look up the best Direction to move in at constant cost. Since
+ * players only move along the axes, distances are measured in cell steps.
+ */
+class FlowField
+{
+public:
+    static constexpr uint32_t unreachable = UINT32_MAX;
+
+    FlowField(const NavGrid& grid);
+
+    /**
+     * Points the field at a new target position.
+     *
+     * Nothing is done unless the target has moved to a different cell, or the
+     * grid has changed, since the last update. While the target stays within
+     * `maxDrift` steps of the cell the field was last rebuilt from, only the
+     * cells near that anchor are re-searched; further cells keep leading to
+     * the anchor, from where the repaired area leads on to the target.
+     *
+     * @return True if the field was rebuilt or repaired.
+     */
+    bool update(glm::vec2 targetPos);
+
+    /**
+     * Forces the field to be rebuilt on the next update.
+     */
+    void invalidate();
+
+    /**
+     * Gets the Direction that leads towards the target from the given position.
+     *
+     * Returns Direction::NONE if the position is in the target cell or cannot reach it.
+     *
+     * If the target is in a blocked cell, the field leads to the nearest open cells instead.
+     */
+    Direction getDirectionTowards(glm::vec2 pos) const;
+
+    /**
+     * Gets the Direction that leads furthest away from the target from the given position.
+     */
+    Direction getDirectionAway(glm::vec2 pos) const;
+
+    /**
+     * Gets the number of cell steps from the given position to the target.
+     *
+     * After a repair, this is exact near the target, and elsewhere the length
+     * of the (possibly longer) route via the anchor.
+     */
+    uint32_t getDistance(glm::vec2 pos) const;
+
+private:
+    void rebuild();
+    void repair();
+    void clearRepair();
+
+    /**
+     * Finds the cells to start searching from: the target cell if it is open, otherwise the nearest open cells.
+     */
+    void findSeeds();
+
+    /**
+     * Labels each seed and adds it to the search queue.
+     *
+     * @return Number of cells queued.
+     */
+    int queueSeeds(std::vector<uint32_t>& seedDistances, std::vector<Direction>& seedDirections);
+
+    uint32_t getCellDistance(int cell) const;
+
+private:
+    static constexpr int noCell = -1;
+
+    /** How far (in cell steps) the target may move from the anchor before the whole field is rebuilt. */
+    static constexpr uint32_t maxDrift = 8;
+
+    /** Cells within this many steps of the anchor are re-searched when the field is repaired. */
+    static constexpr uint32_t repairRadius = 3 * maxDrift;
+
+    /**
+     * How far to look for open cells when the target is in a blocked cell, e.g. pressed against an obstacle.
+     */
+    static constexpr int maxSeedDistance = 4;
+
+    const NavGrid* grid;
+
+    int targetCell = noCell;
+    uint32_t gridVersion = 0;
+
+    /** Cell that the full field was last rebuilt from. */
+    int anchorCell = noCell;
+
+    /** Distance from the anchor to the target, added to the distance of every cell outside the repaired area. */
+    uint32_t anchorOffset = 0;
+
+    /** Distances and Directions towards the anchor, for every cell. */
+    std::vector<uint32_t> distances;
+    std::vector<Direction> directions;
+
+    /** Distances and Directions towards the target, only valid for cells in `repairedCells`. */
+    std::vector<uint32_t> repairedDistances;
+    std::vector<Direction> repairedDirections;
+    std::vector<int> repairedCells;
+
+    /** Open cells nearest the target, and their distance from it. */
+    std::vector<int> seeds;
+    uint32_t seedDistance = 0;
+
+    /** Scratch space for the breadth-first search, kept to avoid reallocating. */
+    std::vector<int> queue;
+};
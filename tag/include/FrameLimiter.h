@@ -0,0 +1,82 @@
+#pragma once
+
+#include <gl/glew.h>
+
+#include <chrono>
+#include <deque>
+
+/**
+ * Limits how many frames the driver may queue up ahead of the GPU.
+ *
+ * Drivers may buffer several frames after a swap, especially with vsync,
+ * so input can be shown much later than it was read. A fence is inserted
+ * after each frame, and before a new frame starts, we wait until the
+ * oldest frames have finished so that no more than the maximum are in
+ * flight.
+ *
+ * The latency from the start of each frame (when input is read) until the
+ * GPU has finished it is measured, and reported periodically. Completion
+ * is only observed at the start of a later frame, so this is an upper
+ * bound.
+ */
+class FrameLimiter
+{
+public:
+    /**
+     * @param maxFramesInFlight Number of frames that may be queued; 1 means the CPU never runs ahead of the GPU.
+     */
+    FrameLimiter(int maxFramesInFlight);
+
+    ~FrameLimiter();
+
+    // Disable moving / copying
+    FrameLimiter(const FrameLimiter& other) = delete;
+    FrameLimiter(FrameLimiter&& other) = delete;
+    FrameLimiter& operator=(const FrameLimiter& other) = delete;
+    FrameLimiter& operator=(FrameLimiter&& other) = delete;
+
+    /**
+     * Waits until a new frame may be started.
+     *
+     * This should be called before reading input for the frame.
+     */
+    void beginFrame();
+
+    /**
+     * Marks the end of the frame's GPU work; should be called after swapping buffers.
+     */
+    void endFrame();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Frame
+    {
+        GLsync fence;
+        Clock::time_point startTime;
+    };
+
+    /**
+     * Records the latency of the oldest frame, which has finished, and stops tracking it.
+     */
+    void retireOldestFrame(Clock::time_point now);
+
+    void report();
+
+private:
+    /**
+     * Number of frames between each latency report.
+     */
+    static constexpr int framesPerReport = 600;
+
+    int maxFramesInFlight;
+    std::deque<Frame> framesInFlight;
+    Clock::time_point frameStartTime;
+    int frameIndex = 0;
+
+    // Stats for the current reporting period
+    int numLatencySamples = 0;
+    double totalLatencyMs = 0.0;
+    double maxLatencyMs = 0.0;
+    double totalWaitMs = 0.0;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+ * Schedules the start of each frame as late as possible before the next vsync.
+ *
+ * Starting a frame immediately after the previous swap means input is read
+ * almost a whole refresh interval before the frame is shown. Instead, we
+ * predict when the next vsync will be and how long the frame will take, and
+ * start just early enough to be ready in time, so input is read at the last
+ * moment.
+ *
+ * Vsync times are predicted from the times at which swaps complete, which
+ * only line up with vsync if the driver is not allowed to queue frames (see
+ * FrameLimiter).
+ *
+ * All times are in seconds, on the same clock as glfwGetTime.
+ */
+class FramePacer
+{
+public:
+    /**
+     * @param refreshInterval Time between each vsync.
+     */
+    FramePacer(double refreshInterval);
+
+    /**
+     * Gets the time at which the next frame should start.
+     *
+     * This may be in the past, if we are running late.
+     */
+    double getNextFrameStartTime() const;
+
+    /**
+     * Records how long the CPU spent on a frame, from its start until the swap was requested.
+     */
+    void frameSubmitted(double workTime);
+
+    /**
+     * Records the time at which a swap completed, which is assumed to be just after a vsync.
+     */
+    void frameSwapped(double swapTime);
+
+private:
+    /**
+     * Time to leave spare before the predicted vsync, to absorb timer and scheduling jitter.
+     */
+    static constexpr double safetyMargin = 0.002;
+
+    /**
+     * Rate at which the work time estimate falls back towards recent frames, after a slow frame.
+     *
+     * The estimate jumps up immediately after a slow frame, but decays slowly, since missing a vsync is much worse
+     * than starting a little early.
+     */
+    static constexpr double workTimeDecay = 0.02;
+
+    double refreshInterval;
+    double lastVsyncTime = 0.0;
+    double workTimeEstimate = 0.0;
+};
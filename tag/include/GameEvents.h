@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Pickups.h"
+#include "Rect.h"
+
+/**
+ * Something that is scheduled to happen on a later tick.
+ */
+struct GameEvent
+{
+    enum class Type : uint8_t
+    {
+        /** A player's speed boost runs out. */
+        SpeedBoostEnd,
+
+        /** A collected pickup comes back. */
+        PickupRespawn,
+    };
+
+    Type type = Type::SpeedBoostEnd;
+
+    /** Player affected, for SpeedBoostEnd. */
+    int playerId = 0;
+
+    /** Pickup to bring back, for PickupRespawn. */
+    Rect bounds {};
+    PowerUp powerUp = PowerUp::SpeedBoost;
+};
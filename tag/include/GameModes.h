@@ -0,0 +1,97 @@
+#pragma once
+
+/**
+ * Sets of rules that a match can be played with.
+ */
+enum class GameMode
+{
+    /** Everyone but the tagged player counts down; the first to reach 0 wins. */
+    Classic,
+
+    /** Only the tagged player counts down; whoever reaches 0 loses, and the player with the most time left wins. */
+    Inverted,
+};
+
+/**
+ * Rule policies for each GameMode.
+ *
+ * The simulation is templated on these, so each mode's tick loop is
+ * compiled separately, with every rule inlined. The mode is chosen once,
+ * when a match starts, rather than checked every tick.
+ *
+ * Each policy provides:
+ *
+ *  - `accelerates(isTagged)`: whether a player's speed builds up this tick.
+ *  - `countsDown(isTagged)`: whether a player's timer runs down this tick.
+ *  - `chooseWinner(outOfTimePlayer, numPlayers, getTimeRemaining)`: picks
+ *    the winner once a player's time has run out.
+ *  - `score(timeRemaining)`: how well placed a player is before the match
+ *    ends; higher is better, and a difference in score is a difference in
+ *    seconds.
+ *
+ * Player, SimState and Application must all agree on the rules, so they all
+ * use these policies. BotPlanner and BatchEnv use `score` to judge matches
+ * that have not finished yet.
+ */
+namespace GameModes {
+
+struct Classic
+{
+    static constexpr bool accelerates(bool isTagged)
+    {
+        return isTagged;
+    }
+
+    static constexpr bool countsDown(bool isTagged)
+    {
+        return !isTagged;
+    }
+
+    template <typename GetTimeRemaining>
+    static int chooseWinner(int outOfTimePlayer, int /*numPlayers*/, GetTimeRemaining&& /*getTimeRemaining*/)
+    {
+        return outOfTimePlayer;
+    }
+
+    static constexpr float score(float timeRemaining)
+    {
+        // Racing to 0
+        return -timeRemaining;
+    }
+};
+
+struct Inverted
+{
+    static constexpr bool accelerates(bool isTagged)
+    {
+        return isTagged;
+    }
+
+    static constexpr bool countsDown(bool isTagged)
+    {
+        return isTagged;
+    }
+
+    template <typename GetTimeRemaining>
+    static int chooseWinner(int /*outOfTimePlayer*/, int numPlayers, GetTimeRemaining&& getTimeRemaining)
+    {
+        // Ties go to the lowest-numbered player
+        int winner = 0;
+        for (int i = 1; i < numPlayers; ++i)
+        {
+            if (getTimeRemaining(i) > getTimeRemaining(winner))
+            {
+                winner = i;
+            }
+        }
+        return winner;
+    }
+
+    static constexpr float score(float timeRemaining)
+    {
+        // Holding on to as much time as possible
+        return timeRemaining;
+    }
+};
+
+}  // namespace GameModes
@@ -4,34 +4,227 @@
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
+#include <gl/glew.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "BoxRenderable.h"
+#include "Camera.h"
+#include "Color.h"
+#include "ParticleRenderable.h"
+#include "ParticleSystem.h"
+#include "Player.h"
 #include "Rect.h"
+#include "Renderer.h"
+#include "ScreenShake.h"
+#include "TrailRenderable.h"
 #include "World.h"
 
-struct GLFWwindow;
-
-class GameRenderer
+/**
+ * Renders the world from the point of view of one or more cameras.
+ *
+ * Rendering goes to whichever framebuffer is bound, which may be a window or
+ * an offscreen target; the renderer only needs to know its size.
+ *
+ * With multiple cameras, the target is split between them. Each batch of boxes
+ * is uploaded once per frame at most, containing what every view needs, and
+ * each view then draws only its own part of the batch. Batches that rarely
+ * change are grouped by area of the world, and only re-uploaded when they do
+ * change; each view then draws the groups it can see.
+ */
+class GameRenderer : public Renderer
 {
 public:
-    GameRenderer(GLFWwindow* window, World* world);
-    void updateViewport(GLFWwindow* window);
-    void render();
+    /**
+     * Area of the target covered by a view, in pixels from the bottom-left corner.
+     */
+    struct Viewport
+    {
+        GLint x = 0;
+        GLint y = 0;
+        GLsizei width = 0;
+        GLsizei height = 0;
+    };
+
+    /**
+     * Placement of every view and the HUD within the target.
+     */
+    struct Layout
+    {
+        /** One viewport per camera. */
+        std::vector<Viewport> viewports;
+
+        Viewport hudViewport;
+
+        /** Size of the HUD frame, in HUD units. */
+        glm::vec2 hudExtents;
+    };
+
+    static constexpr int numBoxesForBorder = 4;
+
+    /**
+     * Constructs a GameRenderer.
+     *
+     * @param targetSize Size of the framebuffer being rendered to, in pixels.
+     * @param cameras One camera per view. `updateViewport` must be called whenever the number of cameras changes.
+     */
+    GameRenderer(
+            glm::ivec2 targetSize,
+            World* world,
+            const std::vector<Camera>* cameras,
+            const ParticleSystem* particles,
+            const ScreenShake* screenShake);
+
+    ~GameRenderer();
+
+    // Disable moving / copying
+    GameRenderer(const GameRenderer& other) = delete;
+    GameRenderer(GameRenderer&& other) = delete;
+    GameRenderer& operator=(const GameRenderer& other) = delete;
+    GameRenderer& operator=(GameRenderer&& other) = delete;
+
+    /**
+     * Recalculates the screen area covered by each view.
+     *
+     * @param targetSize Size of the framebuffer being rendered to, in pixels.
+     */
+    void updateViewport(glm::ivec2 targetSize) override;
+
+    /**
+     * Renders the world.
+     *
+     * @param time Time in seconds, used to animate effects.
+     */
+    void render(double time) override;
+
+    /**
+     * Removes all player trails; should be called whenever the world is reset.
+     */
+    void clearTrails();
+
+    /**
+     * Sets boxes to draw beneath the players, purely for decoration.
+     *
+     * These are uploaded once, and drawn in every view without culling.
+     */
+    void setDecorations(const std::vector<Rect>& rects, const Color& color);
+
+    /**
+     * Gets the aspect ratio of each view when the target is split between the given number of cameras.
+     */
+    static float getSplitScreenAspectRatio(glm::ivec2 targetSize, int numViews);
+
+    // The helpers below are shared with SoftwareRenderer, so that both renderers frame the world identically
+
+    /**
+     * Works out where each camera's view, and the HUD, should be drawn within the target.
+     */
+    static Layout makeLayout(glm::ivec2 targetSize, const std::vector<Camera>& cameras);
+
+    /**
+     * Determines the area of the world that is visible when showing the given camera frame.
+     */
+    static Rect makeVisibleRect(const Rect& frame);
+
+    /**
+     * Creates the Rects that make up the border around a world of the given size.
+     */
+    static std::array<Rect, numBoxesForBorder> makeBorderRects(glm::vec2 worldExtents);
+
+    /**
+     * Creates a Rect to represent a player's score, relative to the HUD frame.
+     */
+    static Rect makeScoreRect(const Player& player, int numPlayers, glm::vec2 hudExtents);
 
 private:
     /**
-     * Creates a view-projection matrix to frame the given Border.
+     * Groups of boxes within a batch, each with the bounds of the area it covers.
+     */
+    using CellRanges = std::vector<std::pair<Rect, BoxRange>>;
+
+    /**
+     * Everything needed to draw a single camera's view.
+     */
+    struct View
+    {
+        Viewport viewport;
+        glm::mat4 viewProjMatrix;
+        Rect visibleRect;
+
+        // Parts of each batch that are visible in this view
+        std::vector<BoxRange> obstacleRanges;
+        std::vector<BoxRange> tileRanges;
+        std::vector<BoxRange> pickupRanges;
+        BoxRange playerRange;
+    };
+
+    /**
+     * Creates a view-projection matrix to show the given camera frame, plus some space around it for the UI.
+     */
+    glm::mat4 makeViewProjectionMatrix(const Rect& frame) const;
+
+    /**
+     * Finds the largest viewport with the given aspect ratio that fits within the target, centred.
+     */
+    static Viewport fillTarget(glm::ivec2 targetSize, float aspectRatio);
+
+    /**
+     * Gets the number of rows and columns used to split the target between the given number of views.
+     */
+    static glm::ivec2 getSplitScreenLayout(int numViews);
+
+    static void setViewport(const Viewport& viewport);
+
+    /**
+     * Determines how a player should be drawn, to highlight who is tagged and who has won.
+     */
+    BoxStyle makePlayerStyle(const Player& player) const;
+
+    /**
+     * Writes this frame's values to the FrameUniforms buffer.
+     */
+    void updateFrameUniforms(double time);
+
+    /**
+     * Refills the obstacle batch with the border and every obstacle, in white so that they can be tinted when drawn.
+     */
+    void rebuildObstacles();
+
+    /**
+     * Refills the tile batch with every resident run of solid tiles, in white so that they can be tinted when drawn.
      */
-    glm::mat4 makeViewProjectionMatrix(const World& world);
+    void rebuildTiles(const TileMap& tileMap);
 
     /**
-     * Sets the viewport to fill the window, preserving the given aspect ratio.
+     * Sorts boxes by the cell of the world containing their centre, and appends a range for each cell.
+     *
+     * @param firstBox Position in the batch at which the boxes will be added.
+     */
+    static void groupByCell(std::vector<Rect>& rects, int firstBox, CellRanges& cellRanges);
+
+    /**
+     * Appends the ranges that overlap the visible area, merging any that are adjacent in the batch.
+     */
+    static void cullRanges(const CellRanges& cellRanges, const Rect& visibleRect, std::vector<BoxRange>& ranges);
+
+    /**
+     * Refills the pickup batch with every pickup, grouped by cell.
+     */
+    void rebuildPickups();
+
+    /**
+     * Refills the player batch with the players visible in each view.
      */
-    void fillWindow(GLFWwindow* window, float aspectRatio);
+    void rebuildPlayers();
 
     /**
-     * Creates a Rect to represent a player's score.
+     * Appends a trail segment for each player for every tick since the last frame.
      */
-    Rect makeScoreRect(const Player& player) const;
+    void updateTrails();
 
 private:
     /**
@@ -50,19 +243,16 @@ private:
     static constexpr glm::vec3 up = glm::vec3(0.f, -1.f, 0.f);
 
     /**
-     * Offset applied to the camera position to fit the UI in frame.
+     * Upwards offset applied to the camera position to fit the UI in frame, relative to the frame height.
      */
-    static constexpr glm::vec3 cameraOffset = 0.75f * up;
+    static constexpr float cameraOffsetRatio = 1.f / 12.f;
 
     /**
-     * Point in the world where the camera should look at.
-     */
-    static constexpr glm::vec3 cameraLookAt = glm::vec3(0.f, 0.f, 0.f) + cameraOffset;
-
-    /**
-     * Position of the camera in the world.
+     * Padding to add around the camera frame during rendering, relative to the frame size.
+     *
+     * This is applied equally to both axes, to prevent stretching.
      */
-    static constexpr glm::vec3 cameraPos = glm::vec3(0.f, 0.f, -1.f) + cameraOffset;
+    static constexpr float framePaddingRatio = 1.f / 3.f;
 
     /**
      * Thickness of the border, in world units.
@@ -70,14 +260,7 @@ private:
     static constexpr float borderThickness = 0.15f;
 
     /**
-     * Padding to add around the game border during rendering.
-     *
-     * This should match the aspect ratio of the world, to prevent stretching.
-     */
-    static constexpr glm::vec2 borderPadding { 4.f, 3.f };
-
-    /**
-     * Offset from the top of the game area at which to render scores.
+     * Offset from the top of the HUD frame at which to render scores.
      */
     static constexpr glm::vec2 scoreOffset = 2.f * up;
 
@@ -91,15 +274,122 @@ private:
      */
     static constexpr float scorePadding = 1.f;
 
-    static constexpr int numBoxesForBorder = 4;
-    static constexpr int numBoxesForPlayers = 2 * World::maxPlayers;
-    static constexpr int maxBoxesToRender = numBoxesForBorder + numBoxesForPlayers;
+    /**
+     * Style used for every player.
+     */
+    static constexpr BoxStyle playerStyle { .cornerRadius = 0.15f };
+
+    /**
+     * Style used for the tagged player, which glows and pulses so it is easy to spot.
+     */
+    static constexpr BoxStyle taggedPlayerStyle { .cornerRadius = 0.15f, .glowRadius = 0.6f, .pulse = 1.f };
 
-    Rect borderTop;
-    Rect borderLeft;
-    Rect borderBottom;
-    Rect borderRight;
+    /**
+     * Style used for the winner.
+     */
+    static constexpr BoxStyle winnerStyle { .cornerRadius = 0.15f, .glowRadius = 1.f, .pulse = 0.5f };
+
+    /**
+     * Style used for the score bars.
+     */
+    static constexpr BoxStyle scoreStyle { .cornerRadius = 0.5f };
+
+    /**
+     * Style used for pickups, which pulse to draw players towards them.
+     */
+    static constexpr BoxStyle pickupStyle {
+        .cornerRadius = 0.2f, .outlineWidth = 0.08f, .glowRadius = 0.3f, .pulse = 1.f
+    };
+
+    /**
+     * Half the width of a player trail, in world units.
+     */
+    static constexpr float trailHalfWidth = 0.3f;
+
+    /**
+     * Opacity of the newest part of a player trail.
+     */
+    static constexpr float trailAlpha = 0.4f;
+
+    /**
+     * Size of the cells that static boxes are grouped into for culling, in world units.
+     */
+    static constexpr float cullCellSize = 8.f;
+
+    /**
+     * Maximum number of views, which is enough for one per player.
+     */
+    static constexpr int maxViews = World::maxPlayers;
+
+    std::array<Rect, numBoxesForBorder> borderRects;
 
     World* world;
-    BoxRenderable boxRenderable { maxBoxesToRender };
+    const std::vector<Camera>* cameras;
+
+    /**
+     * Uniform buffer holding the FrameUniforms, bound for every shader that uses it.
+     */
+    GLuint frameUniformBuffer;
+    const ScreenShake* screenShake;
+    std::vector<View> views;
+
+    /**
+     * Area in which to draw the HUD, and the size of the HUD frame.
+     */
+    Viewport hudViewport;
+    glm::vec2 hudExtents;
+
+    /**
+     * Batch containing the border and every obstacle, grouped by cell.
+     *
+     * This is only re-uploaded when the obstacles are replaced; the tagged player's colour is applied as a tint.
+     */
+    std::unique_ptr<BoxRenderable> obstacleRenderable;
+    uint32_t obstacleVersion = 0;
+    bool obstaclesDirty = true;
+    std::vector<Rect> sortedObstacles;
+    CellRanges obstacleCellRanges;
+
+    /**
+     * Batch containing every solid tile that is currently streamed in, if the world has a TileMap.
+     *
+     * This is only re-uploaded when chunks are loaded or evicted; each view then draws the chunks it can see.
+     */
+    std::unique_ptr<BoxRenderable> tileRenderable;
+    uint32_t tileMapVersion = 0;
+    bool tilesDirty = true;
+    CellRanges tileChunkRanges;
+
+    /**
+     * Batch containing any decorative boxes, which never changes once set.
+     */
+    std::unique_ptr<BoxRenderable> decorationRenderable;
+
+    /**
+     * Batch containing every pickup, grouped by cell.
+     *
+     * This is only re-uploaded when a pickup is spawned or collected.
+     */
+    BoxRenderable pickupRenderable { World::maxPickups };
+    uint32_t pickupsVersion = 0;
+    std::vector<Rect> sortedPickups;
+    CellRanges pickupCellRanges;
+
+    BoxRenderable playerRenderable { World::maxPlayers * maxViews };
+
+    /**
+     * Ring of recent segments for each player's trail.
+     *
+     * Each segment joins 2 consecutive positions in the player's own trail, so one fewer segment is needed.
+     */
+    TrailRenderable trailRenderable { World::maxPlayers, Player::trailLength - 1 };
+    uint32_t trailTick = 0;
+
+    const ParticleSystem* particles;
+    ParticleRenderable particleRenderable;
+
+    /**
+     * Batch containing the HUD, which is drawn on top of everything else, independent of the cameras.
+     */
+    BoxRenderable hudRenderable { World::maxPlayers };
 };
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Renders a scripted match without a window.
+ *
+ * This exercises the full rendering path on machines without a display,
+ * e.g. build servers using Mesa's software renderer. Alternatively, the
+ * match can be drawn by SoftwareRenderer, which needs no GPU or driver.
+ *
+ * The match is entirely deterministic, so the final frame can be compared
+ * against a golden image.
+ */
+namespace Headless {
+
+struct Options
+{
+    int numFrames = 600;
+    int width = 800;
+    int height = 600;
+    int numPlayers = 4;
+
+    /** If set, the final frame is saved to this PPM file. */
+    std::string screenshotFilename;
+
+    /** If set, the final frame is compared against this PPM file. */
+    std::string goldenFilename;
+
+    /** Largest difference per colour channel that still matches the golden image. */
+    int tolerance = 2;
+
+    /** Whether to render on the CPU with SoftwareRenderer, in which case no OpenGL context is needed at all. */
+    bool software = false;
+};
+
+/**
+ * Runs the scripted match and prints how long rendering took.
+ *
+ * @return Exit code for the application; non-zero if the final frame does not match the golden image.
+ */
+int run(const Options& options);
+
+}  // namespace Headless
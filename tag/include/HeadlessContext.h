@@ -0,0 +1,45 @@
+#pragma once
+
+struct GLFWwindow;
+
+/**
+ * OpenGL context that does not need a display.
+ *
+ * When built with TAG_HEADLESS_EGL, this uses EGL with Mesa's surfaceless
+ * platform, which works on machines with no display server at all (e.g. with
+ * llvmpipe). Otherwise it falls back to a hidden GLFW window, which still
+ * needs a display but never appears on screen.
+ *
+ * Rendering must go to an offscreen framebuffer, since the context has no
+ * default framebuffer of its own.
+ *
+ * The context is made current on construction, and GLEW is initialised.
+ */
+class HeadlessContext
+{
+public:
+    /**
+     * @throws std::runtime_error if a context could not be created.
+     */
+    HeadlessContext();
+
+    ~HeadlessContext();
+
+    // Disable moving / copying
+    HeadlessContext(const HeadlessContext& other) = delete;
+    HeadlessContext(HeadlessContext&& other) = delete;
+    HeadlessContext& operator=(const HeadlessContext& other) = delete;
+    HeadlessContext& operator=(HeadlessContext&& other) = delete;
+
+private:
+    void destroy();
+
+private:
+#ifdef TAG_HEADLESS_EGL
+    // Stored as void* to keep EGL out of this header
+    void* display = nullptr;
+    void* context = nullptr;
+#else
+    GLFWwindow* window = nullptr;
+#endif
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * An RGBA image with 8 bits per channel, stored top row first.
+ */
+struct Image
+{
+    static constexpr int bytesPerPixel = 4;
+
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;
+};
+
+namespace ImageUtils {
+
+/**
+ * Result of comparing 2 images.
+ */
+struct ImageDiff
+{
+    /** Number of pixels where any colour channel differs by more than the tolerance. */
+    int numDifferentPixels = 0;
+
+    /** Largest difference found in any colour channel. */
+    int maxChannelDifference = 0;
+};
+
+/**
+ * Writes an image as a binary PPM file.
+ *
+ * PPM has no alpha channel, so alpha is dropped.
+ *
+ * @throws std::runtime_error if the file could not be written.
+ */
+void writePpm(const std::string& filename, const Image& image);
+
+/**
+ * Reads a binary PPM file with 8 bits per channel.
+ *
+ * Alpha is set to 255 throughout.
+ *
+ * @throws std::runtime_error if the file could not be read or is not a supported PPM file.
+ */
+Image readPpm(const std::string& filename);
+
+/**
+ * Compares the colour channels of 2 images; alpha is ignored.
+ *
+ * @param tolerance Largest difference per channel that is still considered a match.
+ * @throws std::invalid_argument if the images are different sizes.
+ */
+ImageDiff compare(const Image& a, const Image& b, int tolerance);
+
+}  // namespace ImageUtils
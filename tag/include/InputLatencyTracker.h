@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "LatencyHistogram.h"
+
+/**
+ * Measures how long player input takes to travel through the game loop.
+ *
+ * Each key press carries the time at which GLFW delivered it. From there we
+ * measure the latency until:
+ *
+ *  - the tick that applies it;
+ *  - the end of the first frame rendered after that tick;
+ *  - the return from the swap that presents that frame.
+ *
+ * With vsync, the swap returns once the frame has been queued for display,
+ * so this is the closest we can get to the time the result is seen without
+ * external hardware.
+ *
+ * A summary is printed periodically, and the distribution for the whole
+ * session can be written to a file.
+ *
+ * All times are in seconds, on the same clock as glfwGetTime.
+ */
+class InputLatencyTracker
+{
+public:
+    /**
+     * Records that a tick applied a key press received at the given time.
+     */
+    void inputApplied(double inputTime, double tickTime);
+
+    /**
+     * Records that every input applied since the last frame has now been rendered.
+     */
+    void frameRendered(double renderTime);
+
+    /**
+     * Records that the frame containing those inputs has been presented.
+     */
+    void frameSwapped(double swapTime);
+
+    /**
+     * Writes percentiles and the full distribution of each stage, for the whole session.
+     *
+     * @throws std::runtime_error if the file could not be written.
+     */
+    void writeReport(const std::string& filename) const;
+
+private:
+    /**
+     * Latency from input to each point in the pipeline.
+     */
+    struct Stages
+    {
+        LatencyHistogram tick;
+        LatencyHistogram render;
+        LatencyHistogram swap;
+    };
+
+    void report();
+
+private:
+    /**
+     * Number of frames between each latency report.
+     */
+    static constexpr int framesPerReport = 600;
+
+    /**
+     * Times at which each input applied since the last swap was received.
+     */
+    std::vector<double> pendingInputTimes;
+
+    /**
+     * Number of pending inputs that have been rendered.
+     */
+    size_t numRenderedInputs = 0;
+
+    int frameIndex = 0;
+
+    /** Stats for the current reporting period. */
+    Stages recent;
+
+    /** Stats for the whole session. */
+    Stages total;
+};
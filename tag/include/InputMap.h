@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+#include "Player.h"
+
+/**
+ * Maps keys to player controls.
+ *
+ * Every key has a slot in a flat table, so looking up a key press is a
+ * single index. Bindings can be changed at any time, or loaded from a
+ * controls file with one binding per line:
+ *
+ *     # player direction key
+ *     1 up UP
+ *     2 left A
+ *     3 down KP_5
+ *
+ * Players are numbered from 1, directions are "up", "down", "left" or
+ * "right", and keys are named as in the GLFW_KEY_* constants, without the
+ * prefix. Blank lines and lines starting with '#' are ignored. Keys reserved
+ * by the game cannot be bound; such a line leaves that control on its
+ * default key.
+ *
+ * Keys are GLFW key codes.
+ */
+class InputMap
+{
+public:
+    /**
+     * Action triggered by a key.
+     */
+    struct Binding
+    {
+        /** Player to control, or -1 if the key is unbound. */
+        int playerId = -1;
+
+        Direction dir = Direction::NONE;
+    };
+
+    /**
+     * Creates the default controls: arrow keys, WASD, the number pad and IJKL, for players 1 to 4 respectively.
+     */
+    InputMap();
+
+    /**
+     * Loads bindings from a controls file.
+     *
+     * Only the bindings in the file are used; the defaults are discarded.
+     *
+     * @throws std::runtime_error if the file could not be read, or contains an invalid binding.
+     */
+    static InputMap loadFile(const std::string& filename);
+
+    /**
+     * Binds a key to a player's direction.
+     *
+     * Any other key bound to the same control is unbound, so each control has exactly one key.
+     *
+     * @return False, leaving the bindings unchanged, if the key is unknown or reserved by the game.
+     */
+    bool bind(int key, int playerId, Direction dir);
+
+    void unbind(int key);
+
+    /**
+     * Removes every binding.
+     */
+    void clear();
+
+    /**
+     * Gets the binding for a key; unbound or unknown keys give a binding with no player.
+     */
+    Binding getBinding(int key) const
+    {
+        return isValidKey(key) ? bindings[key] : Binding {};
+    }
+
+    /**
+     * Determines if a key is handled by the game itself (restart, player count, fullscreen), and so cannot be bound.
+     */
+    static bool isReservedKey(int key);
+
+    /**
+     * Finds a key code from its name, e.g. "W", "UP" or "KP_8".
+     *
+     * @return Key code, or -1 if the name is not recognised.
+     */
+    static int findKey(const std::string& name);
+
+private:
+    static bool isValidKey(int key)
+    {
+        return key >= 0 && key < numKeys;
+    }
+
+private:
+    /**
+     * One more than the highest GLFW key code (GLFW_KEY_LAST).
+     */
+    static constexpr int numKeys = 349;
+
+    std::array<Binding, numKeys> bindings;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Records a distribution of latencies in constant memory, for percentiles that stay accurate however many samples
+ * are taken.
+ *
+ * Buckets are laid out in the style of an HdrHistogram: values below `subBucketCount` microseconds each get their
+ * own bucket, and above that, every power of 2 is split into `subBucketCount / 2` equal buckets. Every value is
+ * therefore stored to within 1/64 of its size, from 1 microsecond up to `maxValue`.
+ */
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    /**
+     * Records a single latency, in seconds.
+     *
+     * Negative latencies are treated as 0, and anything above `maxValue` is clamped.
+     */
+    void record(double seconds);
+
+    /**
+     * Adds every sample from another histogram.
+     */
+    void add(const LatencyHistogram& other);
+
+    /**
+     * Discards all samples.
+     */
+    void reset();
+
+    uint64_t getCount() const
+    {
+        return count;
+    }
+
+    /**
+     * Gets the latency below which the given fraction of samples lie, in milliseconds.
+     *
+     * This is the highest value that falls into the same bucket as the sample at that rank, so it is never an
+     * underestimate.
+     *
+     * @param fraction Fraction of samples, from 0 to 1.
+     */
+    double getPercentileMs(double fraction) const;
+
+    double getMinMs() const;
+    double getMeanMs() const;
+    double getMaxMs() const;
+
+    /**
+     * Calls `callback(double lowMs, double highMs, uint64_t count)` for every bucket holding at least one sample,
+     * from lowest to highest; both bounds are inclusive.
+     */
+    template <typename Callback>
+    void forEachBucket(Callback&& callback) const
+    {
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            if (counts[i] > 0)
+            {
+                uint64_t low = i == 0 ? 0 : getBucketMaxValue(static_cast<int>(i) - 1) + 1;
+                callback(low / 1000.0, getBucketMaxValue(static_cast<int>(i)) / 1000.0, counts[i]);
+            }
+        }
+    }
+
+private:
+    /**
+     * Finds the bucket that holds the given value, in microseconds.
+     */
+    static int getBucketIndex(uint64_t value);
+
+    /**
+     * Gets the highest value, in microseconds, that falls into the given bucket.
+     */
+    static uint64_t getBucketMaxValue(int index);
+
+private:
+    /**
+     * Number of bits of precision kept for each value.
+     */
+    static constexpr int precisionBits = 7;
+
+    static constexpr uint64_t subBucketCount = 1 << precisionBits;
+    static constexpr uint64_t subBucketHalfCount = subBucketCount / 2;
+
+    /**
+     * Largest value that can be recorded, in microseconds (just over 16 seconds).
+     */
+    static constexpr uint64_t maxValue = (uint64_t(1) << 24) - 1;
+
+    std::vector<uint64_t> counts;
+    uint64_t count = 0;
+    uint64_t minValue = 0;
+    uint64_t maxRecordedValue = 0;
+    double totalValue = 0.0;
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "MappedFile.h"
+
+/**
+ * Binary level file, divided into square chunks of tiles.
+ *
+ * Layout (all values little-endian):
+ *  - Header
+ *  - Chunk table: one ChunkEntry per chunk, in row-major order
+ *  - Chunk data: each chunk's tiles, run-length encoded as (count, tile) byte pairs
+ *
+ * The file is memory-mapped rather than read, so opening a level only touches
+ * the header; each chunk is validated and decoded when it is first needed.
+ */
+class LevelFile
+{
+public:
+    /** Identifies a level file ("TAGL"). */
+    static constexpr uint32_t magic = 0x4C474154u;
+
+    /** Incremented whenever the layout changes. */
+    static constexpr uint32_t version = 1;
+
+    /** Tile values. */
+    static constexpr uint8_t emptyTile = 0;
+    static constexpr uint8_t solidTile = 1;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t widthTiles;
+        uint32_t heightTiles;
+        uint32_t chunkSize;
+        float tileSize;
+    };
+
+    struct ChunkEntry
+    {
+        uint64_t offset;
+        uint32_t size;
+        uint32_t reserved;
+    };
+
+    /**
+     * Opens a level file.
+     *
+     * @throws std::runtime_error if the file could not be mapped or has an invalid header.
+     */
+    LevelFile(const std::string& filename);
+
+    /**
+     * Writes a level file, one chunk at a time.
+     *
+     * @param getTile Called as `getTile(tileX, tileY)` for every tile in the level.
+     * @throws std::runtime_error if the file could not be written.
+     */
+    static void write(
+            const std::string& filename,
+            int widthTiles,
+            int heightTiles,
+            int chunkSize,
+            float tileSize,
+            const std::function<uint8_t(int, int)>& getTile);
+
+    /**
+     * Decodes a chunk into `tiles`, which must hold `chunkSize * chunkSize` values.
+     *
+     * Tiles beyond the edge of the level (in chunks along the right or bottom edges) are left solid.
+     *
+     * @throws std::runtime_error if the chunk data is corrupt.
+     */
+    void decodeChunk(int chunkX, int chunkY, uint8_t* tiles) const;
+
+    int getWidthTiles() const
+    {
+        return widthTiles;
+    }
+
+    int getHeightTiles() const
+    {
+        return heightTiles;
+    }
+
+    int getChunkSize() const
+    {
+        return chunkSize;
+    }
+
+    float getTileSize() const
+    {
+        return tileSize;
+    }
+
+    int getNumChunksX() const
+    {
+        return numChunksX;
+    }
+
+    int getNumChunksY() const
+    {
+        return numChunksY;
+    }
+
+    int getNumChunks() const
+    {
+        return numChunksX * numChunksY;
+    }
+
+private:
+    MappedFile file;
+    const ChunkEntry* chunkTable;
+
+    int widthTiles;
+    int heightTiles;
+    int chunkSize;
+    float tileSize;
+    int numChunksX;
+    int numChunksY;
+};
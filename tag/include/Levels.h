@@ -0,0 +1,71 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Rect.h"
+#include "TileMap.h"
+
+/**
+ * Built-in level layouts, and levels loaded from file.
+ *
+ * Each built-in layout is a list of obstacles, positioned relative to the centre of the world.
+ */
+namespace Levels {
+
+/**
+ * Everything needed to construct a World.
+ */
+struct Level
+{
+    glm::vec2 size;
+    std::vector<Rect> obstacles;
+    std::unique_ptr<TileMap> tileMap;
+};
+
+/**
+ * Opens a level file (see LevelFile).
+ *
+ * The world is sized to fit the file; its tiles are streamed in as players move around.
+ *
+ * @throws std::runtime_error if the file could not be opened or is invalid.
+ */
+Level loadLevelFile(const std::string& filename);
+
+/**
+ * Writes a large level file containing a grid of rooms, for testing.
+ *
+ * The centre of the level is left clear, so that players never spawn inside a wall.
+ *
+ * @throws std::runtime_error if the file could not be written.
+ */
+void writeRoomsLevelFile(const std::string& filename, int widthTiles, int heightTiles, unsigned int seed);
+
+/**
+ * Creates the named level.
+ *
+ * @throws std::invalid_argument if there is no level with the given name.
+ */
+std::vector<Rect> makeLevel(const std::string& name, glm::vec2 worldSize);
+
+/**
+ * Empty arena with no obstacles.
+ */
+std::vector<Rect> makeOpen();
+
+/**
+ * Arena with a few pillars and walls, leaving the spawn points clear.
+ */
+std::vector<Rect> makePillars(glm::vec2 worldSize);
+
+/**
+ * Randomly generated grid of wall segments.
+ *
+ * This is mostly useful for stress-testing, since larger worlds produce thousands of walls.
+ */
+std::vector<Rect> makeMaze(glm::vec2 worldSize, float cellSize, unsigned int seed);
+
+}  // namespace Levels
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Read-only view of a file, mapped into memory.
+ *
+ * Pages are loaded by the OS on first access, so opening a file is cheap
+ * regardless of its size, and only the parts that are actually read take up
+ * physical memory.
+ */
+class MappedFile
+{
+public:
+    /**
+     * Maps the given file.
+     *
+     * @throws std::runtime_error if the file could not be opened or mapped.
+     */
+    MappedFile(const std::string& filename);
+
+    ~MappedFile();
+
+    // Disable moving / copying
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile(MappedFile&& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+    MappedFile& operator=(MappedFile&& other) = delete;
+
+    const uint8_t* getData() const
+    {
+        return data;
+    }
+
+    size_t getSize() const
+    {
+        return size;
+    }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    /** Platform-specific handles to the file and mapping. */
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <gl/glew.h>
+
+/**
+ * Framebuffer that can be rendered to without a window.
+ */
+class OffscreenTarget
+{
+public:
+    /**
+     * Constructs an OffscreenTarget with an RGBA colour buffer of the given size.
+     *
+     * @throws std::runtime_error if the framebuffer could not be created.
+     */
+    OffscreenTarget(int width, int height);
+
+    ~OffscreenTarget();
+
+    // Disable moving / copying
+    OffscreenTarget(const OffscreenTarget& other) = delete;
+    OffscreenTarget(OffscreenTarget&& other) = delete;
+    OffscreenTarget& operator=(const OffscreenTarget& other) = delete;
+    OffscreenTarget& operator=(OffscreenTarget&& other) = delete;
+
+    /**
+     * Directs all rendering and pixel reads to this target.
+     */
+    void bind() const;
+
+    glm::ivec2 getSize() const
+    {
+        return { width, height };
+    }
+
+private:
+    GLuint fbo;
+    GLuint colorRenderbuffer;
+    int width;
+    int height;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <gl/glew.h>
+
+class ParticleSystem;
+
+/**
+ * Class that renders every particle in a ParticleSystem with a single instanced draw call.
+ *
+ * Each of the ParticleSystem's arrays is uploaded directly into its own
+ * buffer, so no repacking is needed on the CPU.
+ */
+class ParticleRenderable
+{
+public:
+    /**
+     * Constructs a ParticleRenderable.
+     *
+     * @param maxParticles The maximum number of particles that can be drawn.
+     */
+    ParticleRenderable(int maxParticles);
+
+    ~ParticleRenderable();
+
+    // Disable moving / copying
+    ParticleRenderable(const ParticleRenderable& other) = delete;
+    ParticleRenderable(ParticleRenderable&& other) = delete;
+    ParticleRenderable& operator=(const ParticleRenderable& other) = delete;
+    ParticleRenderable& operator=(ParticleRenderable&& other) = delete;
+
+    /**
+     * Uploads the current state of the given particles.
+     */
+    void update(const ParticleSystem& particles);
+
+    /**
+     * Renders the particles from the last update.
+     *
+     * The ParticleShader must be in use.
+     */
+    void render() const;
+
+private:
+    static constexpr int numCornerDimensions = 2;  // x, y
+    static constexpr int numCorners = 4;
+
+    enum InstanceBuffer
+    {
+        PosXBuffer,
+        PosYBuffer,
+        AgeBuffer,
+        LifetimeBuffer,
+        SizeBuffer,
+        ColorBuffer,
+        NumInstanceBuffers
+    };
+
+    GLuint vao;
+    GLuint cornerVbo;
+    GLuint instanceVbos[NumInstanceBuffers];
+
+    int maxParticles;
+    int numParticles = 0;
+};
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "Color.h"
+
+/**
+ * Describes a group of particles emitted at once.
+ */
+struct ParticleBurst
+{
+    glm::vec2 pos {};
+    Color color = Color::white;
+    int count = 0;
+
+    /** Particles start at a random point within this distance of `pos`. */
+    float spawnRadius = 0.f;
+
+    /** Particles move outwards in random directions, at a random speed in this range. */
+    float minSpeed = 0.f;
+    float maxSpeed = 0.f;
+
+    float minLifetime = 1.f;
+    float maxLifetime = 1.f;
+
+    float size = 0.1f;
+};
+
+/**
+ * Fixed-size pool of short-lived particles.
+ *
+ * Particles are stored as a structure of arrays, so that the update can
+ * process several particles at once using SIMD instructions. Live particles
+ * are always packed at the start of each array; when a particle dies, the last
+ * particle is moved into its place.
+ *
+ * All storage is allocated up-front, so emitting and updating particles never
+ * allocates. If the pool is full, new particles are simply dropped.
+ */
+class ParticleSystem
+{
+public:
+    ParticleSystem(int capacity);
+
+    /**
+     * Spawns a group of particles.
+     */
+    void emit(const ParticleBurst& burst);
+
+    /**
+     * Moves all particles forward in time, removing any that have expired.
+     */
+    void update(float deltaTime);
+
+    /**
+     * Removes all particles.
+     */
+    void clear();
+
+    int getCount() const
+    {
+        return count;
+    }
+
+    int getCapacity() const
+    {
+        return capacity;
+    }
+
+    /**
+     * Determines whether `update` uses SIMD instructions on this platform.
+     */
+    static bool isSimdEnabled();
+
+    // Per-particle data, valid up to `getCount()`
+    const float* getPosX() const
+    {
+        return posX.data();
+    }
+
+    const float* getPosY() const
+    {
+        return posY.data();
+    }
+
+    const float* getAge() const
+    {
+        return age.data();
+    }
+
+    const float* getLifetime() const
+    {
+        return lifetime.data();
+    }
+
+    const float* getSize() const
+    {
+        return size.data();
+    }
+
+    /**
+     * Gets particle colours, packed as RGBA bytes.
+     */
+    const uint32_t* getColor() const
+    {
+        return color.data();
+    }
+
+private:
+    /**
+     * Integrates particles in the range [first, last) one at a time.
+     */
+    void integrateScalar(int first, int last, float deltaTime);
+
+    void removeExpired();
+
+    /**
+     * Gets 32 random bits.
+     */
+    uint32_t nextRandom();
+
+private:
+    /**
+     * Acceleration applied to every particle, in world units per second squared.
+     */
+    static constexpr glm::vec2 gravity { 0.f, 4.f };
+
+    /**
+     * Fraction of velocity lost per second.
+     */
+    static constexpr float drag = 1.5f;
+
+    /**
+     * Number of precomputed directions that particles can be emitted in.
+     *
+     * Looking these up is much cheaper than calling sin / cos for every particle. Must be a power of 2.
+     */
+    static constexpr int numDirections = 1024;
+
+    int capacity;
+    int count = 0;
+    uint32_t rngState = 0x9E3779B9u;
+
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> velX;
+    std::vector<float> velY;
+    std::vector<float> age;
+    std::vector<float> lifetime;
+    std::vector<float> size;
+    std::vector<uint32_t> color;
+
+    std::vector<glm::vec2> directions;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Archetype.h"
+#include "Rect.h"
+
+/**
+ * Effect given to a player who collects a pickup.
+ */
+enum class PowerUp : uint8_t
+{
+    /** Moves faster for a short time. */
+    SpeedBoost,
+};
+
+/**
+ * Items that players can collect: the area covered by each, and the power-up it gives.
+ */
+using Pickups = Archetype<Rect, PowerUp>;
@@ -2,9 +2,12 @@
 
 #include <glm/vec2.hpp>
 
+#include <array>
+#include <cstdint>
 #include <unordered_set>
 
 #include "Color.h"
+#include "GameModes.h"
 #include "Rect.h"
 
 class World;
@@ -20,10 +23,27 @@ enum class Direction : char
 
 class Player
 {
+    friend class SimState;
+
+public:
+    static constexpr glm::vec2 extents { 0.5f, 0.5f };
+
+    /**
+     * Number of recent positions kept for the player's trail, including the current one.
+     */
+    static constexpr int trailLength = 32;
+
 public:
     Player(int playerId, World* world, glm::vec2 pos, Color col);
 
+    /**
+     * Moves the player and updates their speed and timer, according to the rules of the given GameModes policy.
+     *
+     * This is instantiated for every policy in Player.cpp.
+     */
+    template <typename Mode>
     void tick();
+
     void endTick();
 
     glm::vec2 calculatePositionDelta(float delta) const;
@@ -32,11 +52,66 @@ public:
     void setPos(const glm::vec2& newPos);
     void resetSpeed();
 
+    /**
+     * Makes the player move faster, until the boost is removed.
+     */
+    void setSpeedBoosted(bool boosted)
+    {
+        speedBoosted = boosted;
+    }
+
+    bool hasSpeedBoost() const
+    {
+        return speedBoosted;
+    }
+
     bool wasIntersecting(const Player& other) const;
     void setIntersecting(const Player& other);
 
     float getTimeRemainingRatio() const;
-    bool hasWon() const;
+
+    float getTimeRemaining() const
+    {
+        return timeRemaining;
+    }
+
+    bool isOutOfTime() const
+    {
+        return timeRemaining == 0.f;
+    }
+
+    /**
+     * Marks this player as the winner of the match.
+     */
+    void setWon()
+    {
+        won = true;
+    }
+
+    bool hasWon() const
+    {
+        return won;
+    }
+
+    /**
+     * Gets the player's position at the end of an earlier tick.
+     *
+     * @param ticksAgo 0 for the current position, up to `getTrailSize() - 1`.
+     */
+    glm::vec2 getTrailPos(int ticksAgo) const;
+
+    /**
+     * Gets the number of positions currently held in the trail.
+     */
+    int getTrailSize() const;
+
+    /**
+     * Gets the number of times this player has been ticked since it was created.
+     */
+    uint32_t getNumTicks() const
+    {
+        return numTicks;
+    }
 
     const Rect getRect() const
     {
@@ -53,14 +128,21 @@ public:
         return playerId;
     }
 
+    Direction getDir() const
+    {
+        return dir;
+    }
+
 private:
-    static constexpr glm::vec2 extents { 0.5f, 0.5f };
     static constexpr float baseSpeed = 10.f;
     static constexpr float maxSpeed = 12.5f;
     static constexpr float timeTilMaxSpeed = 7.f;
     static constexpr float acceleration = (maxSpeed - baseSpeed) / timeTilMaxSpeed;
     static constexpr float maxTime = 40.f;
 
+    /** Factor applied to the player's speed while boosted. */
+    static constexpr float speedBoostMultiplier = 1.3f;
+
     int playerId;
     World* world = nullptr;
     Rect rect;
@@ -69,6 +151,16 @@ private:
     glm::vec2 dirVector { 0.f, 0.f };
     float speed = baseSpeed;
     float timeRemaining = maxTime;
+    bool speedBoosted = false;
+    bool won = false;
+
+    /**
+     * Circular buffer of recent positions, indexed by tick number.
+     *
+     * The spawn position is stored as tick 0.
+     */
+    std::array<glm::vec2, trailLength> trail;
+    uint32_t numTicks = 0;
 
     std::unordered_set<int> intersectingPlayers;
     std::unordered_set<int> intersectingPlayersLastFrame;
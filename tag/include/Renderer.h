@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+/**
+ * Draws the world from the point of view of one or more cameras.
+ *
+ * GameRenderer draws with OpenGL and SoftwareRenderer on the CPU; code that
+ * only drives a renderer, like the headless runner, works with either.
+ */
+class Renderer
+{
+public:
+    virtual ~Renderer() = default;
+
+    /**
+     * Recalculates the area of the target covered by each view.
+     *
+     * This must be called whenever the target is resized or the number of cameras changes.
+     *
+     * @param targetSize Size of the target, in pixels.
+     */
+    virtual void updateViewport(glm::ivec2 targetSize) = 0;
+
+    /**
+     * Renders the world.
+     *
+     * @param time Time in seconds, used to animate effects.
+     */
+    virtual void render(double time) = 0;
+};
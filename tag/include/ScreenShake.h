@@ -0,0 +1,82 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+/**
+ * Screen shake and flash, in response to gameplay events.
+ *
+ * Shake is modelled as a damped spring pulling the view back to rest: each
+ * kick adds velocity, and the view overshoots a few times before settling.
+ * The results are only ever applied by the shaders, so nothing needs to be
+ * rebuilt when the screen shakes.
+ */
+class ScreenShake
+{
+public:
+    /**
+     * Moves the spring and the flash forward by one tick.
+     */
+    void tick(float dt);
+
+    /**
+     * Returns everything to rest.
+     */
+    void reset();
+
+    /**
+     * Knocks the view in the given direction.
+     *
+     * @param impulse Change in velocity, in world units per second.
+     */
+    void kick(glm::vec2 impulse);
+
+    /**
+     * Starts a flash, replacing any weaker flash already in progress.
+     *
+     * @param intensity Initial strength of the flash (0-1).
+     */
+    void flash(float intensity);
+
+    /**
+     * Gets the current displacement of the view, in world units.
+     */
+    glm::vec2 getOffset() const
+    {
+        return offset;
+    }
+
+    /**
+     * Gets the current strength of the flash (0-1).
+     */
+    float getFlashIntensity() const
+    {
+        return flashIntensity;
+    }
+
+private:
+    /**
+     * Spring stiffness, per second squared.
+     */
+    static constexpr float stiffness = 300.f;
+
+    /**
+     * Spring damping, per second.
+     *
+     * This is well below critical damping (2 * sqrt(stiffness)), so the view wobbles briefly before settling.
+     */
+    static constexpr float damping = 12.f;
+
+    /**
+     * Furthest the view can be displaced, in world units, so that repeated kicks never throw it off-screen.
+     */
+    static constexpr float maxOffset = 1.f;
+
+    /**
+     * Rate at which the flash fades, per second.
+     */
+    static constexpr float flashDecay = 6.f;
+
+    glm::vec2 offset { 0.f, 0.f };
+    glm::vec2 velocity { 0.f, 0.f };
+    float flashIntensity = 0.f;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+
+#include "Camera.h"
+#include "Effects.h"
+#include "ParticleSystem.h"
+#include "ScreenShake.h"
+#include "World.h"
+
+/**
+ * A match where every player follows a fixed script, so that every run looks the same.
+ *
+ * Players take turns being tagged regardless of where they are, so that tag
+ * effects appear at predictable times. This is used wherever rendering
+ * needs to be repeatable, e.g. headless golden-image runs and benchmarks.
+ */
+class ScriptedMatch
+{
+public:
+    ScriptedMatch(int numPlayers);
+
+    /**
+     * Advances the match by one tick.
+     */
+    void tick();
+
+    /**
+     * Starts the script again from the beginning.
+     */
+    void restart();
+
+    /**
+     * Determines whether a player has won.
+     */
+    bool isFinished() const
+    {
+        return !playing;
+    }
+
+private:
+    /**
+     * Passes the tag to the next player in turn.
+     */
+    void passTag();
+
+public:
+    World world;
+    std::vector<Camera> cameras;
+    ParticleSystem particles { maxParticles };
+    ScreenShake screenShake;
+    Effects effects { particles, screenShake };
+
+private:
+    /** Number of ticks between each change of direction. */
+    static constexpr int ticksPerTurn = 40;
+
+    /** Number of ticks between each pass of the tag. */
+    static constexpr int ticksPerTag = 120;
+
+    static constexpr int maxParticles = 1 << 14;
+
+    int tickCount = 0;
+    bool playing = true;
+};
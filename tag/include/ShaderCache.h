@@ -0,0 +1,56 @@
+#pragma once
+
+#include <gl/glew.h>
+
+#include <cstdint>
+
+/**
+ * On-disk cache of linked shader programs.
+ *
+ * Compiling and linking GLSL can take a long time on some drivers, so linked
+ * program binaries are saved after the first run and loaded directly on later
+ * runs. Each binary is keyed by a hash of its source code and the driver's
+ * vendor, renderer and version strings, so a driver update never loads a
+ * binary built by an older driver. Even so, drivers may reject a binary at
+ * any time, in which case the caller should compile from source again.
+ *
+ * If the driver does not support program binaries, loads always fail and saves
+ * do nothing.
+ */
+namespace ShaderCache {
+
+/**
+ * Calculates the cache key for a program built from the given sources on the current driver.
+ */
+uint64_t makeKey(const char* vertShaderSource, const char* fragShaderSource);
+
+/**
+ * Sets any hints that are needed before linking a program that will later be saved.
+ */
+void prepareForLink(GLuint programId);
+
+/**
+ * Creates a program from the cached binary with the given key.
+ *
+ * @return The new program, or 0 if there is no usable binary.
+ */
+GLuint load(uint64_t key);
+
+/**
+ * Saves the binary of a successfully linked program under the given key.
+ *
+ * Failures are ignored, since the cache only makes startup faster.
+ */
+void save(uint64_t key, GLuint programId);
+
+/**
+ * Gets the number of programs that have been loaded from the cache.
+ */
+int getNumHits();
+
+/**
+ * Gets the number of programs that could not be loaded from the cache.
+ */
+int getNumMisses();
+
+}  // namespace ShaderCache
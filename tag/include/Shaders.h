@@ -12,6 +12,41 @@ namespace Shaders {
 static constexpr GLint vertexAttribIndex = 0;
 static constexpr GLint colorAttribIndex = 1;
 
+// Per-vertex attribute indices used by the BoxShader.
+static constexpr GLint boxShapeAttribIndex = 2;
+static constexpr GLint boxStyleAttribIndex = 3;
+
+// Per-instance attribute indices used by the ParticleShader.
+// Particle data is stored as separate arrays, so each value gets its own attribute.
+static constexpr GLint particlePosXAttribIndex = 2;
+static constexpr GLint particlePosYAttribIndex = 3;
+static constexpr GLint particleAgeAttribIndex = 4;
+static constexpr GLint particleLifetimeAttribIndex = 5;
+static constexpr GLint particleSizeAttribIndex = 6;
+
+// Per-vertex attribute index used by the TrailShader: the tick at which the vertex was written.
+static constexpr GLint trailTickAttribIndex = 2;
+
+// Binding point of the FrameUniforms block, shared by every shader that uses it.
+static constexpr GLuint frameUniformsBinding = 0;
+
+/**
+ * Values that change once per frame, shared between shaders.
+ *
+ * This matches the std140 layout of the FrameUniforms block in the shader sources.
+ */
+struct FrameUniforms
+{
+    /** Time since startup, in seconds, for animations. */
+    GLfloat time;
+
+    /** Strength of the screen flash (0-1). */
+    GLfloat flashIntensity;
+
+    /** Displacement of the world due to screen shake, in world units. */
+    GLfloat shakeOffset[2];
+};
+
 ///////////////////////////////////////////////////////////////////////////
 // Shader base class
 ///////////////////////////////////////////////////////////////////////////
@@ -22,11 +57,13 @@ public:
     virtual std::string getName() const = 0;
     bool validateVertexAttribute(GLint attributeLoc, std::string attributeName) const;
     bool validateUniform(GLint uniformLoc, std::string uniformName) const;
+    bool validateUniformBlock(GLuint blockIndex, std::string blockName) const;
 };
 
 ///////////////////////////////////////////////////////////////////////////
-// TextureShader:
-// Renders a texture in 2D space (no depth).
+// BoxShader:
+// Renders boxes in 2D space (no depth), using a signed distance field to
+// draw rounded corners, outlines, glow and pulses per-pixel.
 ///////////////////////////////////////////////////////////////////////////
 
 class BoxShader : public Shader
@@ -36,6 +73,14 @@ public:
 
     // Vertex shader uniform locations
     GLint viewProjMatrixUniformLoc;
+    GLint shakeWeightUniformLoc;
+    GLint tintUniformLoc;
+
+    // Fragment shader uniform locations
+    GLint flashWeightUniformLoc;
+
+    // Uniform block index, shared by both stages
+    GLuint frameUniformsBlockIndex;
 
     // Vertex shader attribute locations
     GLint vertexAttribLoc;
@@ -53,12 +98,165 @@ public:
 
 extern BoxShader boxShader;
 
+///////////////////////////////////////////////////////////////////////////
+// ParticleShader:
+// Renders one instanced quad per particle, fading out over its lifetime.
+///////////////////////////////////////////////////////////////////////////
+
+class ParticleShader : public Shader
+{
+public:
+    GLuint programId;
+
+    // Vertex shader uniform locations
+    GLint viewProjMatrixUniformLoc;
+
+    // Vertex shader uniform block index
+    GLuint frameUniformsBlockIndex;
+
+    static void init();
+
+    bool isValid() const;
+
+    std::string getName() const override
+    {
+        return "ParticleShader";
+    }
+};
+
+extern ParticleShader particleShader;
+
+///////////////////////////////////////////////////////////////////////////
+// TrailShader:
+// Renders trail segments, fading out each vertex based on its age in ticks.
+///////////////////////////////////////////////////////////////////////////
+
+class TrailShader : public Shader
+{
+public:
+    GLuint programId;
+
+    // Vertex shader uniform locations
+    GLint viewProjMatrixUniformLoc;
+    GLint currentTickUniformLoc;
+    GLint fadeTicksUniformLoc;
+
+    // Vertex shader uniform block index
+    GLuint frameUniformsBlockIndex;
+
+    static void init();
+
+    bool isValid() const;
+
+    std::string getName() const override
+    {
+        return "TrailShader";
+    }
+};
+
+extern TrailShader trailShader;
+
+///////////////////////////////////////////////////////////////////////////
+// BrightPassShader:
+// Keeps only the brightest parts of a texture, for bloom.
+// This and the other post-process shaders draw a single fullscreen triangle,
+// and need no vertex attributes.
+///////////////////////////////////////////////////////////////////////////
+
+class BrightPassShader : public Shader
+{
+public:
+    GLuint programId;
+
+    // Fragment shader uniform locations
+    GLint sourceUniformLoc;
+    GLint thresholdUniformLoc;
+    GLint kneeUniformLoc;
+
+    static void init();
+
+    bool isValid() const;
+
+    std::string getName() const override
+    {
+        return "BrightPassShader";
+    }
+};
+
+extern BrightPassShader brightPassShader;
+
+///////////////////////////////////////////////////////////////////////////
+// BlurShader:
+// Applies one direction of a separable Gaussian blur.
+///////////////////////////////////////////////////////////////////////////
+
+class BlurShader : public Shader
+{
+public:
+    GLuint programId;
+
+    // Fragment shader uniform locations
+    GLint sourceUniformLoc;
+    GLint texelStepUniformLoc;
+
+    static void init();
+
+    bool isValid() const;
+
+    std::string getName() const override
+    {
+        return "BlurShader";
+    }
+};
+
+extern BlurShader blurShader;
+
+///////////////////////////////////////////////////////////////////////////
+// CompositeShader:
+// Adds the blurred bloom textures back on top of the scene.
+///////////////////////////////////////////////////////////////////////////
+
+class CompositeShader : public Shader
+{
+public:
+    GLuint programId;
+
+    // Fragment shader uniform locations
+    GLint sceneUniformLoc;
+    GLint bloomHalfUniformLoc;
+    GLint bloomQuarterUniformLoc;
+    GLint strengthUniformLoc;
+
+    static void init();
+
+    bool isValid() const;
+
+    std::string getName() const override
+    {
+        return "CompositeShader";
+    }
+};
+
+extern CompositeShader compositeShader;
+
 ///////////////////////////////////////////////////////////////////////////
 // Generic methods
 ///////////////////////////////////////////////////////////////////////////
 
 void initializeShaders();
 
+/**
+ * Compiles and links a program from source, without using the cache.
+ *
+ * @return The new program, or 0 on failure.
+ */
+GLuint compileProgram(const char* vertShader, const char* fragShader);
+
+/**
+ * Creates a program from the given sources, loading it from the ShaderCache if possible.
+ *
+ * @return The new program, or 0 on failure.
+ */
 GLuint createShader(const char* vertShader, const char* fragShader);
 
 }  // namespace Shaders
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * A named block of memory that other processes can map.
+ *
+ * This creates (or opens) the block on construction, and unmaps it on
+ * destruction. On POSIX systems the name is also unlinked, since we always
+ * act as the owner.
+ */
+class SharedMemory
+{
+public:
+    /**
+     * Creates a SharedMemory block.
+     *
+     * @param name Name of the block, without any platform-specific prefix.
+     * @param size Size of the block, in bytes.
+     *
+     * @throws std::runtime_error if the block could not be created.
+     */
+    SharedMemory(const std::string& name, size_t size);
+
+    ~SharedMemory();
+
+    // Disable moving / copying
+    SharedMemory(const SharedMemory& other) = delete;
+    SharedMemory(SharedMemory&& other) = delete;
+    SharedMemory& operator=(const SharedMemory& other) = delete;
+    SharedMemory& operator=(SharedMemory&& other) = delete;
+
+    void* getData() const
+    {
+        return data;
+    }
+
+    size_t getSize() const
+    {
+        return size;
+    }
+
+private:
+    std::string name;
+    size_t size;
+    void* data = nullptr;
+
+    /** Platform-specific handle to the mapping. */
+    void* handle = nullptr;
+};
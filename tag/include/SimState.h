@@ -0,0 +1,141 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "GameModes.h"
+#include "Player.h"
+#include "World.h"
+
+/**
+ * Lightweight copy of the game state, for running lookahead simulations.
+ *
+ * Unlike World, this owns no heap allocations and is trivially copyable, so
+ * it can be cloned for the cost of a memcpy. It follows the same rules as
+ * Player::tick and Application::tick, using the World's GameModes policy; the
+ * three must be kept in sync.
+ *
+ * The only pointers are non-owning, read-only references to data shared by
+ * every clone: the World used for collision detection (if it has obstacles),
+ * and the tick function for the World's game mode. Clones deliberately alias
+ * these, so the World must outlive the SimState and every copy of it.
+ */
+class SimState
+{
+public:
+    struct SimPlayer
+    {
+        glm::vec2 pos;
+        Direction dir;
+        float speed;
+        float timeRemaining;
+    };
+
+    /** Value of taggedPlayer / winner when there isn't one. */
+    static constexpr int noPlayer = -1;
+
+    /**
+     * Creates a SimState that matches the current state of the World.
+     */
+    static SimState capture(const World& world);
+
+    /**
+     * Sets the direction of a player.
+     *
+     * Unlike Player::setDir, this does not toggle; Direction::NONE stops the player.
+     */
+    void setDir(int playerIndex, Direction dir);
+
+    /**
+     * Advances the simulation by one frame.
+     */
+    void tick();
+
+    /**
+     * Resets the simulation's random state.
+     */
+    void setSeed(uint32_t seed);
+
+    /**
+     * Gets a random number in the range [0, max), advancing the simulation's random state.
+     */
+    uint32_t random(uint32_t max);
+
+    bool isFinished() const
+    {
+        return winner != noPlayer;
+    }
+
+    int getWinner() const
+    {
+        return winner;
+    }
+
+    int getTaggedPlayer() const
+    {
+        return taggedPlayer;
+    }
+
+    int getNumPlayers() const
+    {
+        return numPlayers;
+    }
+
+    GameMode getGameMode() const
+    {
+        return gameMode;
+    }
+
+    const SimPlayer& getPlayer(int playerIndex) const
+    {
+        return players[playerIndex];
+    }
+
+    static glm::vec2 getDirVector(Direction dir);
+
+    static constexpr float getBaseSpeed()
+    {
+        return Player::baseSpeed;
+    }
+
+    static constexpr float getMaxTime()
+    {
+        return Player::maxTime;
+    }
+
+private:
+    /**
+     * Advances the simulation by one frame, under the rules of the given GameModes policy.
+     */
+    template <typename Mode>
+    void tickWith();
+
+    void tag(int a, int b);
+
+    static int pairIndex(int a, int b);
+
+private:
+    std::array<SimPlayer, World::maxPlayers> players;
+    int numPlayers = 0;
+    int taggedPlayer = noPlayer;
+    int winner = noPlayer;
+    glm::vec2 worldExtents;
+    GameMode gameMode = GameMode::Classic;
+
+    /** Tick function for the World's game mode, chosen once when the state is captured. */
+    void (SimState::*tickFunction)() = &SimState::tickWith<GameModes::Classic>;
+
+    /** World to use for collision detection, if it has any obstacles. */
+    const World* collisionWorld = nullptr;
+
+    /** Bit per pair of players that were intersecting at the end of the last tick. */
+    uint16_t intersectingLastTick = 0;
+
+    /** xorshift32 state. */
+    uint32_t rngState;
+};
+
+static_assert(std::is_trivially_copyable_v<SimState>, "SimState is cloned with memcpy");
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "Camera.h"
+#include "ImageUtils.h"
+#include "Rect.h"
+#include "Renderer.h"
+#include "ScreenShake.h"
+#include "ThreadPool.h"
+#include "World.h"
+
+/**
+ * Renders the world on the CPU, for machines without a GPU.
+ *
+ * This uses the same layout as GameRenderer, so the same cameras frame the
+ * world identically. Every box is drawn as a flat, sharp-cornered
+ * rectangle; box styles, trails and particles are not drawn.
+ *
+ * Each frame, every box is first clipped and converted to pixel bounds. The
+ * image is then split into horizontal bands, which can be filled in
+ * parallel since no 2 bands share a pixel. Spans are filled with AVX2 where
+ * the CPU supports it.
+ */
+class SoftwareRenderer : public Renderer
+{
+public:
+    /**
+     * Constructs a SoftwareRenderer.
+     *
+     * @param targetSize Size of the image to render, in pixels.
+     * @param cameras One camera per view. `updateViewport` must be called whenever the number of cameras changes.
+     * @param threadPool Pool used to fill bands in parallel, if any.
+     */
+    SoftwareRenderer(
+            glm::ivec2 targetSize,
+            const World* world,
+            const std::vector<Camera>* cameras,
+            const ScreenShake* screenShake,
+            ThreadPool* threadPool = nullptr);
+
+    /**
+     * Resizes the image and recalculates the area covered by each view.
+     *
+     * @param targetSize Size of the image to render, in pixels.
+     */
+    void updateViewport(glm::ivec2 targetSize) override;
+
+    /**
+     * Renders the world.
+     *
+     * @param time Time in seconds; unused, since nothing drawn is animated.
+     */
+    void render(double time) override;
+
+    /**
+     * Gets the most recently rendered image.
+     */
+    const Image& getImage() const
+    {
+        return image;
+    }
+
+private:
+    /**
+     * Area of the image, in pixels from the top-left corner; the right and bottom edges are exclusive.
+     */
+    struct PixelRect
+    {
+        int left = 0;
+        int top = 0;
+        int right = 0;
+        int bottom = 0;
+    };
+
+    struct ScreenBox
+    {
+        PixelRect bounds;
+        uint32_t color;
+    };
+
+    /**
+     * Maps world co-ordinates to pixels for a single view.
+     */
+    struct ViewTransform
+    {
+        PixelRect area;
+        glm::vec2 origin;
+        glm::vec2 scale;
+    };
+
+    /**
+     * Creates the transform that shows the given part of the world in the given area of the image.
+     */
+    static ViewTransform makeViewTransform(const PixelRect& area, const Rect& visibleRect);
+
+    /**
+     * Appends a box to be filled this frame, if any part of it is visible.
+     */
+    void addBox(const ViewTransform& transform, const Rect& rect, uint32_t color);
+
+    /**
+     * Clears and fills every row of the image within the given band.
+     */
+    void fillBand(int band);
+
+    /**
+     * Sets `count` consecutive pixels to the same colour.
+     */
+    static void fillSpan(uint32_t* dest, int count, uint32_t color);
+
+private:
+    /**
+     * Height of each band of pixels that is filled as one task.
+     *
+     * Small enough to share work evenly, but large enough that each task skips most boxes cheaply.
+     */
+    static constexpr int bandHeight = 32;
+
+    const World* world;
+    const std::vector<Camera>* cameras;
+    const ScreenShake* screenShake;
+    ThreadPool* threadPool;
+
+    std::vector<PixelRect> viewAreas;
+    PixelRect hudArea;
+    glm::vec2 hudExtents;
+
+    /** Boxes to fill this frame, in draw order. */
+    std::vector<ScreenBox> boxes;
+
+    Image image;
+};
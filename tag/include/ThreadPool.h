@@ -0,0 +1,71 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed-size pool of worker threads.
+ *
+ * Work is submitted as a batch of numbered tasks which are shared between the
+ * workers and the calling thread.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * Constructs a ThreadPool.
+     *
+     * @param numWorkers Number of background threads to create. If negative,
+     *     one thread is created per hardware thread, minus one for the caller.
+     */
+    ThreadPool(int numWorkers = -1);
+
+    ~ThreadPool();
+
+    // Disable moving / copying
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool(ThreadPool&& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+    ThreadPool& operator=(ThreadPool&& other) = delete;
+
+    /**
+     * Runs `task(i)` for every i in [0, numTasks), and waits for them all to complete.
+     *
+     * Only one batch may be in progress at a time.
+     */
+    void parallelFor(int numTasks, const std::function<void(int)>& task);
+
+    /**
+     * Gets the number of threads that will work on a batch, including the caller.
+     */
+    int getNumThreads() const
+    {
+        return static_cast<int>(workers.size()) + 1;
+    }
+
+private:
+    void workerLoop();
+
+    /** Claims and runs tasks from the current batch until none are left. */
+    void runTasks();
+
+private:
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable batchReady;
+    std::condition_variable batchDone;
+
+    const std::function<void(int)>* currentTask = nullptr;
+    int numTasks = 0;
+    int nextTask = 0;
+    int numTasksRemaining = 0;
+
+    /** Incremented for each batch, so that workers can tell when there is new work. */
+    unsigned int batchId = 0;
+
+    bool stopping = false;
+};
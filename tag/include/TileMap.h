@@ -0,0 +1,203 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <algorithm>  // clamp
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "LevelFile.h"
+#include "Rect.h"
+
+/**
+ * Grid of solid / empty tiles, streamed in chunks from a LevelFile.
+ *
+ * Only chunks near a focus point (typically a player) are decoded. These live
+ * in a fixed pool of slots, so memory use depends on the number of focus points
+ * rather than the size of the level; chunks are decoded when a focus point
+ * comes within `loadRadius` chunks, and released once every focus point is
+ * more than `evictRadius` chunks away.
+ *
+ * Chunks that are not resident are treated as solid, since we cannot know what
+ * they contain.
+ *
+ * Queries are read-only, so they may be made from multiple threads as long as
+ * `update` is not running at the same time.
+ */
+class TileMap
+{
+public:
+    /**
+     * Creates a TileMap with enough chunk slots for the given number of focus points.
+     *
+     * No chunks are decoded until the first call to `update`.
+     */
+    TileMap(std::unique_ptr<LevelFile> file, int maxFocusPoints);
+
+    /**
+     * Loads chunks near the given positions, and evicts chunks that are no longer near any of them.
+     *
+     * @throws std::runtime_error if a chunk could not be decoded.
+     */
+    void update(const std::vector<glm::vec2>& focusPoints);
+
+    /**
+     * Determines whether the given tile is solid.
+     *
+     * Tiles outside the level, or in chunks that are not resident, are considered solid.
+     */
+    bool isSolid(int tileX, int tileY) const;
+
+    /**
+     * Calls `callback(const Rect&)` for every solid tile that overlaps the given area.
+     *
+     * Tiles outside the level are ignored; tiles that only touch the area's edges are not considered to overlap.
+     */
+    template <typename Callback>
+    void forEachSolidTile(const Rect& area, Callback&& callback) const
+    {
+        glm::vec2 areaMin = (area.pos - area.extents + worldExtents) / tileSize;
+        glm::vec2 areaMax = (area.pos + area.extents + worldExtents) / tileSize;
+        int minX = std::clamp(static_cast<int>(std::floor(areaMin.x)), 0, file->getWidthTiles());
+        int minY = std::clamp(static_cast<int>(std::floor(areaMin.y)), 0, file->getHeightTiles());
+        int maxX = std::clamp(static_cast<int>(std::ceil(areaMax.x)), 0, file->getWidthTiles());
+        int maxY = std::clamp(static_cast<int>(std::ceil(areaMax.y)), 0, file->getHeightTiles());
+
+        for (int y = minY; y < maxY; ++y)
+        {
+            for (int x = minX; x < maxX; ++x)
+            {
+                if (isSolid(x, y))
+                {
+                    callback(makeTileRect(x, y, 1));
+                }
+            }
+        }
+    }
+
+    /**
+     * Calls `callback(const Rect& bounds, const std::vector<Rect>& runs)` for every resident chunk.
+     *
+     * `runs` contains each horizontal run of solid tiles in the chunk. In total,
+     * there are never more than `getMaxResidentRuns()` of these.
+     */
+    template <typename Callback>
+    void forEachResidentChunk(Callback&& callback) const
+    {
+        for (const Chunk& chunk : chunks)
+        {
+            if (chunk.chunkIndex != noChunk)
+            {
+                callback(chunk.bounds, chunk.runs);
+            }
+        }
+    }
+
+    int getMaxResidentRuns() const;
+
+    /**
+     * Gets the size of the whole level, in world units.
+     */
+    glm::vec2 getWorldSize() const
+    {
+        return worldExtents * 2.f;
+    }
+
+    float getTileSize() const
+    {
+        return tileSize;
+    }
+
+    int getChunkSize() const
+    {
+        return chunkSize;
+    }
+
+    int getNumResidentChunks() const
+    {
+        return numResidentChunks;
+    }
+
+    int getMaxResidentChunks() const
+    {
+        return static_cast<int>(chunks.size());
+    }
+
+    /**
+     * Gets the total number of chunks decoded so far, including any that were later evicted.
+     */
+    uint64_t getNumChunksDecoded() const
+    {
+        return numChunksDecoded;
+    }
+
+    /**
+     * Incremented whenever the set of resident chunks changes.
+     */
+    uint32_t getVersion() const
+    {
+        return version;
+    }
+
+public:
+    /**
+     * Chunks within this distance of a focus point (in chunks, along either axis) are loaded.
+     */
+    static constexpr int loadRadius = 2;
+
+    /**
+     * Chunks further than this distance from every focus point are evicted.
+     *
+     * This is larger than `loadRadius` so that walking back and forth across a
+     * chunk boundary does not repeatedly decode and evict the same chunks.
+     */
+    static constexpr int evictRadius = 3;
+
+private:
+    static constexpr int noChunk = -1;
+
+    struct Chunk
+    {
+        int chunkIndex = noChunk;
+        uint64_t lastUsed = 0;
+        Rect bounds;
+        std::vector<uint8_t> tiles;
+        std::vector<Rect> runs;
+    };
+
+    /**
+     * Decodes a chunk into a free slot. Corrupt chunks are logged and loaded as solid tiles, rather than thrown.
+     */
+    void loadChunk(int chunkX, int chunkY);
+
+    /**
+     * Finds a slot for a new chunk, evicting the least-recently used chunk if necessary.
+     */
+    int findFreeSlot();
+
+    void evictSlot(int slot);
+
+    Rect makeTileRect(int tileX, int tileY, int numTiles) const;
+
+private:
+    std::unique_ptr<LevelFile> file;
+    glm::vec2 worldExtents;
+    float tileSize;
+    int chunkSize;
+
+    /** Fixed pool of decoded chunks. */
+    std::vector<Chunk> chunks;
+
+    /** Slot holding each chunk in the level, or noChunk. */
+    std::vector<int> chunkSlots;
+
+    /** Chunk containing each focus point, refilled by every update. */
+    std::vector<glm::ivec2> focusChunks;
+
+    int numResidentChunks = 0;
+    uint64_t numChunksDecoded = 0;
+    uint64_t updateCount = 0;
+    uint32_t version = 0;
+};
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Refers to a timer within a TimerWheel.
+ *
+ * Once the timer has fired or been cancelled, the handle becomes stale, and
+ * cancelling it again does nothing, even if its storage has been reused.
+ */
+struct TimerHandle
+{
+    static constexpr uint32_t invalidIndex = 0xffffffffu;
+
+    uint32_t index = invalidIndex;
+    uint32_t generation = 0;
+
+    bool operator==(const TimerHandle& other) const = default;
+};
+
+/**
+ * Schedules events to fire on specific ticks.
+ *
+ * Timers are kept in a hierarchy of wheels, each with 256 slots. The first
+ * wheel has a slot for each of the next 256 ticks; each wheel after that
+ * covers 256 times the range of the one before, with one slot per turn of
+ * the previous wheel. Whenever a wheel completes a turn, the next slot of
+ * the wheel above is emptied into it, so each timer moves down at most 3
+ * times before it fires.
+ *
+ * Each slot is an intrusive doubly-linked list of timers, so scheduling and
+ * cancelling are O(1), and advancing only touches the timers that are due
+ * (plus the occasional cascade), however many are pending.
+ *
+ * Timer storage is pooled, so once the pool has grown, scheduling does not
+ * allocate.
+ */
+template <typename Event>
+class TimerWheel
+{
+public:
+    TimerWheel()
+    {
+        slotHeads.fill(noTimer);
+    }
+
+    /**
+     * Schedules an event to fire on the given tick.
+     *
+     * Ticks that have already passed fire on the next call to `advance`.
+     */
+    TimerHandle schedule(uint32_t dueTick, const Event& event)
+    {
+        uint32_t index;
+        if (freeTimers.empty())
+        {
+            index = static_cast<uint32_t>(timers.size());
+            timers.push_back({});
+        }
+        else
+        {
+            index = freeTimers.back();
+            freeTimers.pop_back();
+        }
+
+        Timer& timer = timers[index];
+        timer.event = event;
+        timer.dueTick = dueTick - nextTick < maxDelay ? dueTick : nextTick;
+        timer.active = true;
+        link(index);
+        ++numPending;
+
+        return { index, timer.generation };
+    }
+
+    /**
+     * Stops a timer from firing.
+     *
+     * @return false if the timer had already fired or been cancelled.
+     */
+    bool cancel(TimerHandle handle)
+    {
+        if (!isPending(handle))
+        {
+            return false;
+        }
+
+        unlink(handle.index);
+        release(handle.index);
+        return true;
+    }
+
+    /**
+     * Determines whether a timer has yet to fire.
+     */
+    bool isPending(TimerHandle handle) const
+    {
+        return handle.index < timers.size() && timers[handle.index].generation == handle.generation
+                && timers[handle.index].active;
+    }
+
+    /**
+     * Moves forward by one tick, and calls `callback(const Event&)` for every event due on that tick.
+     *
+     * The callback may schedule or cancel timers, including other timers due on this tick that have not fired yet;
+     * anything it schedules for the current tick fires on the next call instead.
+     */
+    template <typename Callback>
+    void advance(Callback&& callback)
+    {
+        const uint32_t tick = nextTick;
+
+        // Whenever a wheel completes a turn, bring down the timers for the next turn from the wheel above
+        for (int level = 1; level < numLevels; ++level)
+        {
+            uint32_t previousSlot = (tick >> ((level - 1) * bitsPerLevel)) & slotMask;
+            if (previousSlot != 0)
+            {
+                break;
+            }
+            cascade(level, (tick >> (level * bitsPerLevel)) & slotMask);
+        }
+
+        // Move the due timers to their own list before firing any, so that the callback can schedule new timers
+        // without them firing this tick, and can cancel due timers that have not fired yet
+        uint32_t& head = slotHeads[tick & slotMask];
+        for (uint32_t index = head; index != noTimer; index = timers[index].next)
+        {
+            timers[index].slot = firingSlot;
+        }
+        slotHeads[firingSlot] = head;
+        head = noTimer;
+        ++nextTick;
+
+        // Each timer is removed before its callback runs, so its handle is already stale by then
+        while (slotHeads[firingSlot] != noTimer)
+        {
+            uint32_t index = slotHeads[firingSlot];
+            unlink(index);
+            Event event = timers[index].event;
+            release(index);
+            callback(event);
+        }
+    }
+
+    /**
+     * Cancels every timer, and starts counting from tick 0 again.
+     */
+    void clear()
+    {
+        for (uint32_t i = 0; i < timers.size(); ++i)
+        {
+            if (timers[i].active)
+            {
+                release(i);
+            }
+        }
+        slotHeads.fill(noTimer);
+        nextTick = 0;
+    }
+
+    /**
+     * Gets the number of ticks that have been advanced.
+     */
+    uint32_t getCurrentTick() const
+    {
+        return nextTick;
+    }
+
+    int getNumPending() const
+    {
+        return numPending;
+    }
+
+private:
+    struct Timer
+    {
+        Event event {};
+        uint32_t dueTick = 0;
+
+        /** Neighbours within the slot's list. */
+        uint32_t prev = noTimer;
+        uint32_t next = noTimer;
+
+        /** Slot containing this timer, across all levels, or firingSlot once it is due. */
+        uint32_t slot = 0;
+
+        /** Incremented whenever the timer fires or is cancelled. */
+        uint32_t generation = 0;
+
+        bool active = false;
+    };
+
+    /**
+     * Adds a timer to the slot for its due tick, relative to the next tick to be processed.
+     */
+    void link(uint32_t index)
+    {
+        Timer& timer = timers[index];
+        uint32_t delay = timer.dueTick - nextTick;
+
+        int level = 0;
+        while (level + 1 < numLevels && delay >= (1u << ((level + 1) * bitsPerLevel)))
+        {
+            ++level;
+        }
+
+        timer.slot = level * slotsPerLevel + ((timer.dueTick >> (level * bitsPerLevel)) & slotMask);
+        timer.prev = noTimer;
+        timer.next = slotHeads[timer.slot];
+        if (timer.next != noTimer)
+        {
+            timers[timer.next].prev = index;
+        }
+        slotHeads[timer.slot] = index;
+    }
+
+    void unlink(uint32_t index)
+    {
+        Timer& timer = timers[index];
+        if (timer.prev != noTimer)
+        {
+            timers[timer.prev].next = timer.next;
+        }
+        else
+        {
+            slotHeads[timer.slot] = timer.next;
+        }
+        if (timer.next != noTimer)
+        {
+            timers[timer.next].prev = timer.prev;
+        }
+    }
+
+    /**
+     * Re-files every timer in the given slot, which moves each one down to a lower level.
+     */
+    void cascade(int level, uint32_t slot)
+    {
+        uint32_t& head = slotHeads[level * slotsPerLevel + slot];
+        uint32_t index = head;
+        head = noTimer;
+
+        while (index != noTimer)
+        {
+            uint32_t next = timers[index].next;
+            link(index);
+            index = next;
+        }
+    }
+
+    /**
+     * Returns a timer's storage to the pool; the timer must already be unlinked from its slot.
+     */
+    void release(uint32_t index)
+    {
+        Timer& timer = timers[index];
+        timer.active = false;
+        timer.event = {};
+        ++timer.generation;
+        freeTimers.push_back(index);
+        --numPending;
+    }
+
+private:
+    static constexpr uint32_t noTimer = 0xffffffffu;
+    static constexpr int bitsPerLevel = 8;
+    static constexpr int numLevels = 4;
+    static constexpr uint32_t slotsPerLevel = 1u << bitsPerLevel;
+    static constexpr uint32_t slotMask = slotsPerLevel - 1;
+
+    /**
+     * Extra slot after every wheel, holding the timers that are firing during `advance`.
+     */
+    static constexpr uint32_t firingSlot = numLevels * slotsPerLevel;
+
+    /**
+     * Longest delay that can be scheduled; anything further ahead is treated as already due.
+     */
+    static constexpr uint32_t maxDelay = 0x80000000u;
+
+    std::vector<Timer> timers;
+    std::vector<uint32_t> freeTimers;
+    std::array<uint32_t, firingSlot + 1> slotHeads;
+    int numPending = 0;
+
+    /** Next tick to be processed. */
+    uint32_t nextTick = 0;
+};
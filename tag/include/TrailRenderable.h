@@ -0,0 +1,82 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <gl/glew.h>
+
+#include <cstdint>
+
+struct Color;
+
+/**
+ * Class that renders a number of fading trails with a single draw call.
+ *
+ * Each trail is a ring of segments stored on the GPU. Adding a segment
+ * overwrites the oldest one in that trail, so only one segment is uploaded per
+ * trail per tick, however long the trails are. Every vertex records the tick
+ * at which it was written, and the TrailShader fades it out based on its age.
+ */
+class TrailRenderable
+{
+public:
+    /**
+     * Constructs a TrailRenderable.
+     *
+     * @param maxTrails The maximum number of trails that can be drawn.
+     * @param segmentsPerTrail The number of segments kept in each trail.
+     */
+    TrailRenderable(int maxTrails, int segmentsPerTrail);
+
+    ~TrailRenderable();
+
+    // Disable moving / copying
+    TrailRenderable(const TrailRenderable& other) = delete;
+    TrailRenderable(TrailRenderable&& other) = delete;
+    TrailRenderable& operator=(const TrailRenderable& other) = delete;
+    TrailRenderable& operator=(TrailRenderable&& other) = delete;
+
+    /**
+     * Removes every segment from every trail.
+     */
+    void clear();
+
+    /**
+     * Writes the segment for the given tick, replacing the oldest segment in the trail.
+     *
+     * The segment covers a box of the given half-width swept from `from` to `to`.
+     * Its `from` end is treated as being one tick older than its `to` end, so
+     * that the fade is smooth along the length of the trail.
+     */
+    void addSegment(int trailIndex, uint32_t tick, glm::vec2 from, glm::vec2 to, float halfWidth, const Color& color);
+
+    /**
+     * Renders every trail.
+     *
+     * The TrailShader must be in use.
+     */
+    void render() const;
+
+    int getSegmentsPerTrail() const
+    {
+        return segmentsPerTrail;
+    }
+
+private:
+    struct Vertex
+    {
+        GLfloat x;
+        GLfloat y;
+        uint32_t color;
+        GLuint tick;
+    };
+
+    static constexpr int numVerticesPerSegment = 4;
+    static constexpr int numIndicesPerSegment = 6;
+
+    GLuint vao;
+    GLuint vbo;
+    GLuint ibo;
+
+    int maxTrails;
+    int segmentsPerTrail;
+};
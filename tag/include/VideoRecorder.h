@@ -0,0 +1,122 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AsyncReadback.h"
+#include "ImageUtils.h"
+
+/**
+ * Captures every rendered frame to a video file.
+ *
+ * Frames are read back asynchronously, and collected a few frames later once
+ * the GPU has finished with them, so the render loop never waits for a read.
+ * Encoding and disk writes happen on a separate thread.
+ *
+ * Files ending in ".y4m" are written as YUV4MPEG2 (4:4:4, BT.601), which most
+ * video tools can read directly. Anything else is written as raw RGBA frames,
+ * top row first.
+ *
+ * If the GPU or the disk cannot keep up, frames are dropped rather than
+ * slowing down the game, and the number dropped is reported at the end.
+ */
+class VideoRecorder
+{
+public:
+    /**
+     * Constructs a VideoRecorder that captures frames of the given size.
+     *
+     * @throws std::runtime_error if the file could not be opened.
+     */
+    VideoRecorder(const std::string& filename, int width, int height, int fps);
+
+    /**
+     * Waits for all outstanding frames to be written.
+     *
+     * The OpenGL context must still be current.
+     */
+    ~VideoRecorder();
+
+    // Disable moving / copying
+    VideoRecorder(const VideoRecorder& other) = delete;
+    VideoRecorder(VideoRecorder&& other) = delete;
+    VideoRecorder& operator=(const VideoRecorder& other) = delete;
+    VideoRecorder& operator=(VideoRecorder&& other) = delete;
+
+    /**
+     * Captures the contents of the framebuffer bound for reading.
+     *
+     * This should be called once per frame, after rendering and before swapping buffers.
+     */
+    void captureFrame();
+
+    glm::ivec2 getSize() const
+    {
+        return { width, height };
+    }
+
+private:
+    /**
+     * Hands any completed readbacks to the writer thread.
+     *
+     * @param wait Whether to wait for readbacks that are still in progress.
+     */
+    void collectFrames(bool wait);
+
+    /**
+     * Gets an image from the pool, if one is free.
+     */
+    bool takeFreeImage(Image& image);
+
+    void writerLoop();
+    void writeFrame(const Image& image);
+
+private:
+    /**
+     * Number of frames that can be read back at once.
+     *
+     * Frames are normally collected 2 frames after they are captured, so 3 buffers avoid dropping frames.
+     */
+    static constexpr int numReadbackBuffers = 3;
+
+    /**
+     * Number of frames that can wait for the writer thread before new frames are dropped.
+     */
+    static constexpr int maxQueuedFrames = 16;
+
+    std::string filename;
+    std::ofstream file;
+    bool y4m;
+    int width;
+    int height;
+    AsyncReadback readback;
+
+    int numFramesCaptured = 0;
+    int numFramesDropped = 0;
+
+    /**
+     * Images that are not currently in use.
+     *
+     * Every image is allocated up-front, which also bounds the number of frames in the queue.
+     */
+    std::vector<Image> freeImages;
+
+    /** Frames waiting to be written, oldest first. */
+    std::deque<Image> queuedFrames;
+
+    std::mutex mutex;
+    std::condition_variable frameQueued;
+    bool stopping = false;
+
+    /** Buffer used by the writer thread to build each frame before writing it. */
+    std::vector<uint8_t> frameData;
+
+    std::thread writer;
+};
@@ -3,18 +3,84 @@
 #include <glm/mat4x4.hpp>
 #include <glm/vec2.hpp>
 
+#include <memory>
 #include <vector>
 
+#include "AabbTree.h"
+#include "FlowField.h"
+#include "GameEvents.h"
+#include "GameModes.h"
+#include "Pickups.h"
 #include "Player.h"
 #include "Rect.h"
+#include "TileMap.h"
+#include "TimerWheel.h"
 
 class World
 {
 public:
-    World(glm::vec2 size, int numPlayers);
+    World(glm::vec2 size,
+            int numPlayers,
+            std::vector<Rect> obstacles = {},
+            std::unique_ptr<TileMap> tileMap = nullptr);
 
     glm::vec2 keepInBounds(const glm::vec2& objPos, const glm::vec2& objExtents) const;
 
+    /**
+     * Moves an object from one position towards another, stopping at any obstacles or the edge of the world.
+     *
+     * Each axis is resolved separately, so objects can slide along walls.
+     */
+    glm::vec2 resolveMovement(const glm::vec2& oldPos, const glm::vec2& newPos, const glm::vec2& objExtents) const;
+
+    /**
+     * Replaces the static level geometry.
+     */
+    void setObstacles(std::vector<Rect> newObstacles);
+
+    const std::vector<Rect>& getObstacles() const
+    {
+        return obstacles;
+    }
+
+    /**
+     * Incremented whenever the obstacles are replaced, so that renderers know when to rebuild.
+     */
+    uint32_t getObstacleVersion() const
+    {
+        return obstacleVersion;
+    }
+
+    /**
+     * Calls `callback(const Rect&)` for every obstacle that overlaps the given area.
+     */
+    template <typename Callback>
+    void forEachObstacleIn(const Rect& area, Callback&& callback) const
+    {
+        obstacleTree.query(area, callback);
+    }
+
+    /**
+     * Gets the streamed tile layer, if any.
+     */
+    TileMap* getTileMap()
+    {
+        return tileMap.get();
+    }
+
+    const TileMap* getTileMap() const
+    {
+        return tileMap.get();
+    }
+
+    /**
+     * Determines whether anything in the world can block movement, other than its edges.
+     */
+    bool hasObstacles() const
+    {
+        return !obstacles.empty() || tileMap;
+    }
+
     float getAspectRatio() const;
 
     const glm::vec2& getSize() const
@@ -32,31 +98,143 @@ public:
         return players;
     }
 
+    const std::vector<Player>& getPlayers() const
+    {
+        return players;
+    }
+
+    Pickups& getPickups()
+    {
+        return pickups;
+    }
+
+    const Pickups& getPickups() const
+    {
+        return pickups;
+    }
+
+    /**
+     * Gets the scheduler for events on later ticks; it is advanced once per tick, and cleared when the world is
+     * reset.
+     */
+    TimerWheel<GameEvent>& getTimers()
+    {
+        return timers;
+    }
+
+    /**
+     * Determines whether any obstacle overlaps the given area.
+     */
+    bool isBlocked(const Rect& area) const;
+
     Player* getTaggedPlayer()
     {
         return taggedPlayer;
     }
 
+    const Player* getTaggedPlayer() const
+    {
+        return taggedPlayer;
+    }
+
     void setTaggedPlayer(Player* player)
     {
         taggedPlayer = player;
     }
 
+    GameMode getGameMode() const
+    {
+        return gameMode;
+    }
+
+    /**
+     * Sets the rules for the match; only takes effect when the match is (re)started.
+     */
+    void setGameMode(GameMode newGameMode)
+    {
+        gameMode = newGameMode;
+    }
+
     void reset();
     void reset(int numPlayers);
 
+    /**
+     * Streams in the tiles around each player, and releases tiles that are no longer needed.
+     *
+     * This must not be called while other threads are resolving movement.
+     */
+    void updateTileMap();
+
+    /**
+     * Points each player's FlowField at their current position.
+     *
+     * Fields are only rebuilt for players who have moved to a new cell.
+     */
+    void updateFlowFields();
+
+    /**
+     * Gets the FlowField leading towards the given player.
+     */
+    const FlowField& getFlowField(int playerId) const
+    {
+        return flowFields[playerId];
+    }
+
+    NavGrid& getNavGrid()
+    {
+        return navGrid;
+    }
+
 public:
     static constexpr int minPlayers = 2;
     static constexpr int maxPlayers = 4;
 
+    /** Size of the built-in levels, in world units. */
+    static constexpr glm::vec2 defaultSize { 24.f, 18.f };
+
+    /** Maximum number of pickups that can exist at once. */
+    static constexpr int maxPickups = 512;
+
+private:
+    /**
+     * Moves an object along a single axis, stopping at the first obstacle in the way.
+     */
+    float sweepAxis(const glm::vec2& from, float to, int axis, const glm::vec2& objExtents) const;
+
 private:
     /**
      * Absolute (positive) position of a player's spawn location.
      */
     static constexpr glm::vec2 playerOrigin = { 4.f, 3.f };
 
+    /**
+     * Size of each NavGrid cell, in world units.
+     */
+    static constexpr float navCellSize = 0.5f;
+
+    /**
+     * Maximum number of NavGrid cells along either axis.
+     *
+     * Larger worlds use bigger cells, so that flow fields stay cheap to build.
+     */
+    static constexpr int maxNavGridSize = 256;
+
     glm::vec2 size;
     glm::vec2 extents;
     std::vector<Player> players;
     Player* taggedPlayer = nullptr;
+    Pickups pickups;
+    TimerWheel<GameEvent> timers;
+    GameMode gameMode = GameMode::Classic;
+
+    std::vector<Rect> obstacles;
+    uint32_t obstacleVersion = 0;
+    AabbTree obstacleTree;
+    std::unique_ptr<TileMap> tileMap;
+
+    /** Position of each player, refilled whenever the TileMap is updated. */
+    std::vector<glm::vec2> focusPoints;
+
+    NavGrid navGrid;
+    std::vector<FlowField> flowFields;
 };
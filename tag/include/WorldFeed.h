@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "SharedMemory.h"
+#include "WorldFeedFormat.h"
+
+class World;
+
+/**
+ * Publishes the state of the World to shared memory once per tick.
+ *
+ * External tools can map the feed and read it using the helpers in
+ * WorldFeedFormat.h. Publishing never blocks, regardless of how many readers
+ * there are or what they are doing.
+ */
+class WorldFeed
+{
+public:
+    /**
+     * Creates a WorldFeed.
+     *
+     * @param name Name of the shared memory block to publish to.
+     *
+     * @throws std::runtime_error if the shared memory could not be created.
+     */
+    WorldFeed(const std::string& name);
+
+    /**
+     * Writes the current state of the World to the next frame in the ring.
+     */
+    void publish(const World& world);
+
+private:
+    SharedMemory sharedMemory;
+    TagFeedHeader* header;
+
+    /** Tick of the last published frame. */
+    uint64_t tick = 0;
+};
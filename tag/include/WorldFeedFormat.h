@@ -0,0 +1,191 @@
+/*
+ * Layout of the shared-memory world feed.
+ *
+ * This header is plain C so that external tools (overlays, stream widgets,
+ * etc.) can include it without depending on anything else in the game.
+ *
+ * The game publishes one TagFeedFrame per tick into a ring of frames. Each
+ * frame is guarded by its own sequence counter (a "seqlock"):
+ *  - The writer makes the sequence odd, writes the frame, then makes the
+ *    sequence even again.
+ *  - A reader copies the frame and then checks that the sequence was even and
+ *    unchanged throughout; otherwise, the copy was torn and should be retried.
+ *
+ * The writer never waits for readers, and readers never make syscalls after
+ * the initial mapping. A reader that falls more than TAG_FEED_RING_SIZE ticks
+ * behind will find that the frame it wanted has been overwritten.
+ *
+ * See docs/world-feed.md for an example reader.
+ */
+
+#ifndef TAG_WORLD_FEED_FORMAT_H
+#define TAG_WORLD_FEED_FORMAT_H
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+
+/*
+ * MSVC has no acquire load in C. Plain volatile loads are only acquires on
+ * x86 / x64 with /volatile:ms, so we load with __iso_volatile_load* and add
+ * whatever barrier the target needs afterwards.
+ */
+#if defined(_M_X64) || defined(_M_IX86)
+/* x86 never reorders a load with later loads or stores, so only the compiler needs stopping */
+#define TAG_FEED_ACQUIRE_BARRIER() _ReadWriteBarrier()
+#elif defined(_M_ARM64)
+#define TAG_FEED_ACQUIRE_BARRIER() __dmb(_ARM64_BARRIER_ISHLD)
+#else
+#error "WorldFeedFormat.h does not know how to order loads on this architecture"
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Identifies a valid feed ("TFED"). */
+#define TAG_FEED_MAGIC 0x44454654u
+
+/** Incremented whenever the layout below changes. */
+#define TAG_FEED_VERSION 1u
+
+/** Maximum number of players that can appear in a frame. */
+#define TAG_FEED_MAX_PLAYERS 4
+
+/** Number of frames kept in the ring. Must be a power of 2. */
+#define TAG_FEED_RING_SIZE 64
+
+/** Value of taggedPlayerId when no-one has been tagged yet. */
+#define TAG_FEED_NO_PLAYER (-1)
+
+typedef struct TagFeedPlayer
+{
+    int32_t playerId;
+    float x;
+    float y;
+    float r;
+    float g;
+    float b;
+    float a;
+    float timeRemainingRatio;
+} TagFeedPlayer;
+
+typedef struct TagFeedFrame
+{
+    /* Seqlock counter; odd while the frame is being written. */
+    uint32_t sequence;
+    int32_t numPlayers;
+    uint64_t tick;
+    int32_t taggedPlayerId;
+    int32_t reserved;
+    TagFeedPlayer players[TAG_FEED_MAX_PLAYERS];
+} TagFeedFrame;
+
+typedef struct TagFeedHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t frameSize;
+    uint32_t ringSize;
+
+    /* Tick of the most recently completed frame (0 if nothing has been published yet). */
+    uint64_t latestTick;
+
+    TagFeedFrame frames[TAG_FEED_RING_SIZE];
+} TagFeedHeader;
+
+/*
+ * Memory-ordering helpers. Readers need acquire semantics on the sequence
+ * loads; the writer side lives in WorldFeed.cpp.
+ */
+static inline uint32_t tagFeedLoadAcquire32(const uint32_t* ptr)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    uint32_t val = (uint32_t) __iso_volatile_load32((const volatile __int32*) ptr);
+    TAG_FEED_ACQUIRE_BARRIER();
+    return val;
+#else
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline uint64_t tagFeedLoadAcquire64(const uint64_t* ptr)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    uint64_t val = (uint64_t) __iso_volatile_load64((const volatile __int64*) ptr);
+    TAG_FEED_ACQUIRE_BARRIER();
+    return val;
+#else
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void tagFeedFenceAcquire(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    TAG_FEED_ACQUIRE_BARRIER();
+#else
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * Returns the tick of the most recently published frame.
+ */
+static inline uint64_t tagFeedLatestTick(const TagFeedHeader* feed)
+{
+    return tagFeedLoadAcquire64(&feed->latestTick);
+}
+
+/**
+ * Copies the frame for the given tick into `out`.
+ *
+ * Returns 1 on success, or 0 if the frame is not available (not yet written,
+ * already overwritten, or continuously being rewritten).
+ */
+static inline int tagFeedReadFrame(const TagFeedHeader* feed, uint64_t tick, TagFeedFrame* out)
+{
+    const TagFeedFrame* frame = &feed->frames[tick & (TAG_FEED_RING_SIZE - 1)];
+    int attempt;
+
+    for (attempt = 0; attempt < 16; ++attempt)
+    {
+        uint32_t before = tagFeedLoadAcquire32(&frame->sequence);
+        if (before & 1u)
+        {
+            // Writer is mid-update
+            continue;
+        }
+
+        memcpy(out, frame, sizeof(TagFeedFrame));
+
+        tagFeedFenceAcquire();
+        uint32_t after = tagFeedLoadAcquire32(&frame->sequence);
+        if (before == after)
+        {
+            return out->tick == tick;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Copies the most recently published frame into `out`.
+ *
+ * Returns 1 on success, or 0 if nothing has been published yet.
+ */
+static inline int tagFeedReadLatest(const TagFeedHeader* feed, TagFeedFrame* out)
+{
+    uint64_t tick = tagFeedLatestTick(feed);
+    return tick != 0 && tagFeedReadFrame(feed, tick, out);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TAG_WORLD_FEED_FORMAT_H
@@ -0,0 +1,70 @@
+#include "AabbTree.h"
+
+#include <glm/common.hpp>
+
+#include <algorithm>  // nth_element
+
+AabbTree::AabbTree() {}
+
+void AabbTree::build(const std::vector<Rect>& rects)
+{
+    items.clear();
+    nodes.clear();
+
+    if (rects.empty())
+    {
+        return;
+    }
+
+    items.reserve(rects.size());
+    for (const Rect& rect : rects)
+    {
+        items.push_back({ rect.pos - rect.extents, rect.pos + rect.extents, rect });
+    }
+
+    // A binary tree with at least 1 item per leaf has fewer than 2n nodes
+    nodes.reserve(2 * items.size());
+    nodes.push_back({});
+    buildNode(0, 0, static_cast<int>(items.size()));
+}
+
+void AabbTree::buildNode(int nodeIndex, int first, int count)
+{
+    // Calculate bounds
+    glm::vec2 min = items[first].min;
+    glm::vec2 max = items[first].max;
+    for (int i = first + 1; i < first + count; ++i)
+    {
+        min = glm::min(min, items[i].min);
+        max = glm::max(max, items[i].max);
+    }
+    nodes[nodeIndex].min = min;
+    nodes[nodeIndex].max = max;
+
+    if (count <= maxItemsPerLeaf)
+    {
+        nodes[nodeIndex].first = first;
+        nodes[nodeIndex].count = count;
+        return;
+    }
+
+    // Split at the median along the longest axis
+    glm::vec2 size = max - min;
+    int axis = size.x >= size.y ? 0 : 1;
+    int half = count / 2;
+    std::nth_element(
+            items.begin() + first,
+            items.begin() + first + half,
+            items.begin() + first + count,
+            [axis](const Item& a, const Item& b) { return a.rect.pos[axis] < b.rect.pos[axis]; });
+
+    // Children must be adjacent
+    int childIndex = static_cast<int>(nodes.size());
+    nodes.push_back({});
+    nodes.push_back({});
+    nodes[nodeIndex].first = childIndex;
+    nodes[nodeIndex].count = 0;
+
+    buildNode(childIndex, first, half);
+    buildNode(childIndex + 1, first + half, count - half);
+}
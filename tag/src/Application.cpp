@@ -4,18 +4,22 @@
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 
+#include <algorithm>  // max
 #include <iostream>
 #include <random>
 #include <vector>
 
 #include "Rect.h"
+#include "SimState.h"
 #include "TimeUtils.h"
 
-Application::Application(GLFWwindow* window, int numPlayers)
+Application::Application(GLFWwindow* window, int numPlayers, Levels::Level level)
     : window(window)
-    , world(worldSize, numPlayers)
-    , renderer(window, &world)
+    , world(level.size, numPlayers, std::move(level.obstacles), std::move(level.tileMap))
+    , cameras(1, Camera(level.size))
+    , renderer(getWindowSize(window), &world, &cameras, &particles, &screenShake)
 {
+    botPlanner.setWorld(&world);
 }
 
 void Application::run()
@@ -27,32 +31,89 @@ void Application::run()
     double lastUpdateTime = glfwGetTime();
     while (isRunning())
     {
+        // When pacing frames, sleep until the last moment that still lets this frame make the next vsync
+        if (framePacer)
+        {
+            double timeUntilFrameStart = framePacer->getNextFrameStartTime() - glfwGetTime();
+            if (timeUntilFrameStart > 0.0)
+            {
+                timer.wait(static_cast<float>(timeUntilFrameStart));
+            }
+        }
+
         // Measure time
         double nowTime = glfwGetTime();
         float deltaTime = static_cast<float>(nowTime - lastUpdateTime);
 
-        // Is an update due?
-        if (deltaTime > TimeUtils::frameTime)
+        // Is an update due? Paced frames are always rendered, since they were timed to meet a vsync.
+        if (deltaTime > TimeUtils::frameTime || framePacer)
         {
-            lastUpdateTime = nowTime;
-            int numUpdatesPerformed = 0;
+            // Don't let the driver queue up too many frames
+            if (frameLimiter)
+            {
+                frameLimiter->beginFrame();
+            }
 
-            // Process GLFW event queue
+            // Process GLFW event queue as late as possible, so input is as fresh as possible
             glfwPollEvents();
+            double inputTime = glfwGetTime();
 
             // Update according to our desired FPS.
             // This may update more than once if we are falling behind.
-            while (deltaTime > TimeUtils::frameTime && numUpdatesPerformed < TimeUtils::maxUpdatesPerRender)
+            int numUpdatesPerformed = 0;
+            while (inputTime - lastUpdateTime > TimeUtils::frameTime
+                    && numUpdatesPerformed < TimeUtils::maxUpdatesPerRender)
             {
-                tick();
-                deltaTime -= TimeUtils::frameTime;
+                lastUpdateTime += TimeUtils::frameTime;
                 ++numUpdatesPerformed;
+
+                // Input that arrives while we are catching up goes to the next tick, rather than the next frame.
+                // GLFW does not say when each event happened, so input can never go to an earlier tick than this.
+                if (numUpdatesPerformed > 1)
+                {
+                    glfwPollEvents();
+                }
+                applyInput();
+
+                tick();
+                if (worldFeed)
+                {
+                    worldFeed->publish(world);
+                }
+            }
+
+            // If we are still behind, stop trying to catch up; the game will appear to slow down
+            if (inputTime - lastUpdateTime > TimeUtils::frameTime)
+            {
+                lastUpdateTime = inputTime;
             }
 
             render();
 
+            if (inputLatency)
+            {
+                inputLatency->frameRendered(glfwGetTime());
+            }
+            if (framePacer)
+            {
+                framePacer->frameSubmitted(glfwGetTime() - nowTime);
+            }
+
             // If vsync is enabled, this blocks until the next screen refresh
             glfwSwapBuffers(window);
+
+            if (frameLimiter)
+            {
+                frameLimiter->endFrame();
+            }
+            if (framePacer)
+            {
+                framePacer->frameSwapped(glfwGetTime());
+            }
+            if (inputLatency)
+            {
+                inputLatency->frameSwapped(glfwGetTime());
+            }
         }
         else
         {
@@ -61,6 +122,10 @@ void Application::run()
             timer.wait(timeUntilNextTick);
         }
     }
+
+    // Write any frames still in flight while the context still exists
+    recorder.reset();
+    frameLimiter.reset();
 }
 
 bool Application::isRunning() const
@@ -70,25 +135,41 @@ bool Application::isRunning() const
 
 void Application::tick()
 {
+    // Effects keep playing after the game has ended
+    effects.tick(world);
+    screenShake.tick(TimeUtils::frameTime);
+
     if (!playing)
     {
         return;
     }
 
-    // Move all players
-    std::vector<Player>& players = world.getPlayers();
-    for (Player& player : players)
+    // Make sure players never reach the edge of the loaded area
+    world.updateTileMap();
+
+    // Catch up with wherever players moved last tick
+    for (Camera& camera : cameras)
     {
-        player.tick();
+        camera.update(world);
+    }
 
-        if (player.hasWon())
-        {
-            playing = false;
-            return;
-        }
+    // Let the AI decide where to go
+    updateBots();
+
+    // Fire any events that are due
+    world.getTimers().advance([&](const GameEvent& event) { onEvent(event); });
+
+    // Move all players
+    if (!(this->*movePlayersFunction)())
+    {
+        playing = false;
+        return;
     }
 
+    collectPickups();
+
     // Check for collisions between all players
+    std::vector<Player>& players = world.getPlayers();
     for (int i = 0; i < players.size(); ++i)
     {
         Player& player = players[i];
@@ -117,9 +198,150 @@ void Application::tick()
     }
 }
 
+template <typename Mode>
+bool Application::movePlayers()
+{
+    std::vector<Player>& players = world.getPlayers();
+    for (Player& player : players)
+    {
+        player.tick<Mode>();
+
+        if (player.isOutOfTime())
+        {
+            int numPlayers = static_cast<int>(players.size());
+            Player& winner = players[Mode::chooseWinner(
+                    player.getPlayerId(), numPlayers, [&](int i) { return players[i].getTimeRemaining(); })];
+            winner.setWon();
+
+            effects.onWin(winner);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Application::spawnPickups()
+{
+    // Tiles far from the players are not loaded, so we can't tell where there is space for pickups
+    if (world.getTileMap())
+    {
+        return;
+    }
+
+    const glm::vec2 worldExtents = world.getExtents();
+    const glm::ivec2 numSpots(
+            static_cast<int>(world.getSize().x / pickupSpacing), static_cast<int>(world.getSize().y / pickupSpacing));
+    const glm::vec2 pickupExtents = Player::extents * 0.6f;
+
+    for (int y = 0; y < numSpots.y; ++y)
+    {
+        for (int x = 0; x < numSpots.x; ++x)
+        {
+            if (world.getPickups().size() >= World::maxPickups)
+            {
+                return;
+            }
+
+            // Centre the grid of pickups within the world
+            glm::vec2 pos(
+                    (x + 0.5f) * world.getSize().x / numSpots.x - worldExtents.x,
+                    (y + 0.5f) * world.getSize().y / numSpots.y - worldExtents.y);
+            Rect bounds { pos, pickupExtents };
+
+            // Don't hand anyone a power-up before they have moved
+            bool blocked = world.isBlocked(bounds);
+            for (const Player& player : world.getPlayers())
+            {
+                blocked = blocked || player.getRect().intersects(bounds);
+            }
+
+            if (!blocked)
+            {
+                world.getPickups().spawn(bounds, PowerUp::SpeedBoost);
+            }
+        }
+    }
+}
+
+void Application::collectPickups()
+{
+    TimerWheel<GameEvent>& timers = world.getTimers();
+    std::vector<Player>& players = world.getPlayers();
+
+    world.getPickups().despawnIf([&](const Rect& bounds, PowerUp powerUp) {
+        for (Player& player : players)
+        {
+            if (player.getRect().intersects(bounds))
+            {
+                applyPowerUp(player, powerUp);
+
+                GameEvent respawn { .type = GameEvent::Type::PickupRespawn, .bounds = bounds, .powerUp = powerUp };
+                timers.schedule(timers.getCurrentTick() + pickupRespawnTicks, respawn);
+                return true;
+            }
+        }
+        return false;
+    });
+}
+
+void Application::applyPowerUp(Player& player, PowerUp powerUp)
+{
+    switch (powerUp)
+    {
+    case PowerUp::SpeedBoost:
+    {
+        // Collecting another boost extends the current one, rather than adding to it
+        TimerWheel<GameEvent>& timers = world.getTimers();
+        TimerHandle& timer = speedBoostTimers[player.getPlayerId()];
+        timers.cancel(timer);
+
+        player.setSpeedBoosted(true);
+        GameEvent boostEnd { .type = GameEvent::Type::SpeedBoostEnd, .playerId = player.getPlayerId() };
+        timer = timers.schedule(timers.getCurrentTick() + speedBoostTicks, boostEnd);
+        break;
+    }
+    }
+}
+
+void Application::onEvent(const GameEvent& event)
+{
+    switch (event.type)
+    {
+    case GameEvent::Type::SpeedBoostEnd:
+    {
+        std::vector<Player>& players = world.getPlayers();
+        if (event.playerId < static_cast<int>(players.size()))
+        {
+            players[event.playerId].setSpeedBoosted(false);
+        }
+        break;
+    }
+    case GameEvent::Type::PickupRespawn:
+        world.getPickups().spawn(event.bounds, event.powerUp);
+        break;
+    }
+}
+
 void Application::render()
 {
-    renderer.render();
+    if (bloom)
+    {
+        bloom->begin();
+    }
+
+    renderer.render(glfwGetTime());
+
+    if (bloom)
+    {
+        bloom->end();
+    }
+
+    // Capture the finished frame from the back buffer, before it is swapped
+    if (recorder)
+    {
+        recorder->captureFrame();
+    }
 }
 
 void Application::keyPressed(int key, int mods)
@@ -148,140 +370,255 @@ void Application::keyPressed(int key, int mods)
     // Add / remove players
     if (key == GLFW_KEY_F2)
     {
-        world.reset(2);
+        resetWorld(2);
         return;
     }
     if (key == GLFW_KEY_F3)
     {
-        world.reset(3);
+        resetWorld(3);
         return;
     }
     if (key == GLFW_KEY_F4)
     {
-        world.reset(4);
+        resetWorld(4);
         return;
     }
 
-    // Player 1
-    if (key == GLFW_KEY_UP)
-    {
-        world.getPlayers()[0].setDir(Direction::UP);
-        return;
-    }
-    if (key == GLFW_KEY_DOWN)
+    // Ignore keys for players that are not in this match
+    InputMap::Binding binding = inputMap.getBinding(key);
+    if (binding.playerId < 0 || binding.playerId >= static_cast<int>(world.getPlayers().size()))
     {
-        world.getPlayers()[0].setDir(Direction::DOWN);
-        return;
-    }
-    if (key == GLFW_KEY_LEFT)
-    {
-        world.getPlayers()[0].setDir(Direction::LEFT);
-        return;
-    }
-    if (key == GLFW_KEY_RIGHT)
-    {
-        world.getPlayers()[0].setDir(Direction::RIGHT);
         return;
     }
 
-    // Player 2
-    if (key == GLFW_KEY_W)
-    {
-        world.getPlayers()[1].setDir(Direction::UP);
-        return;
-    }
-    if (key == GLFW_KEY_S)
+    // Players only see input when they next tick
+    queuePlayerInput(binding.playerId, binding.dir, glfwGetTime());
+}
+
+void Application::queuePlayerInput(int playerId, Direction dir, double time)
+{
+    pendingInput[playerId].push_back({ dir, time });
+}
+
+void Application::applyInput()
+{
+    std::vector<Player>& players = world.getPlayers();
+    for (size_t i = 0; i < players.size(); ++i)
     {
-        world.getPlayers()[1].setDir(Direction::DOWN);
-        return;
+        std::deque<InputEvent>& playerInput = pendingInput[i];
+        while (!playerInput.empty())
+        {
+            players[i].setDir(playerInput.front().dir);
+            if (inputLatency)
+            {
+                inputLatency->inputApplied(playerInput.front().time, glfwGetTime());
+            }
+            playerInput.pop_front();
+        }
     }
-    if (key == GLFW_KEY_A)
+}
+
+void Application::windowResized()
+{
+    layoutCameras();
+
+    glm::ivec2 windowSize = getWindowSize(window);
+    if (bloom)
     {
-        world.getPlayers()[1].setDir(Direction::LEFT);
-        return;
+        bloom->resize(windowSize.x, windowSize.y);
     }
-    if (key == GLFW_KEY_D)
+
+    // Every frame in a video must be the same size
+    if (recorder && recorder->getSize() != windowSize)
     {
-        world.getPlayers()[1].setDir(Direction::RIGHT);
-        return;
+        recorder.reset();
+        std::cout << "Recording stopped because the window was resized\n";
     }
+}
+
+void Application::toggleFullscreen()
+{
+    bool wasFullscreen = windowProps.fullscreen;
+    windowProps.fullscreen = !windowProps.fullscreen;
 
-    // Player 3
-    if (key == GLFW_KEY_KP_8)
+    if (wasFullscreen)
     {
-        world.getPlayers()[2].setDir(Direction::UP);
-        return;
+        // Exit fullscreen - restore previous window settings
+        glfwSetWindowMonitor(window, nullptr, windowProps.x, windowProps.y, windowProps.width, windowProps.height, 0);
     }
-    if (key == GLFW_KEY_KP_5)
+    else
     {
-        world.getPlayers()[2].setDir(Direction::DOWN);
-        return;
+        // Enter fullscreen - remember current window settings
+        GLFWmonitor* monitor = glfwGetPrimaryMonitor();
+        const GLFWvidmode* vidMode = glfwGetVideoMode(monitor);
+        glfwGetWindowSize(window, &windowProps.width, &windowProps.height);
+        glfwGetWindowPos(window, &windowProps.x, &windowProps.y);
+        glfwSetWindowMonitor(window, monitor, 0, 0, vidMode->width, vidMode->height, vidMode->refreshRate);
     }
-    if (key == GLFW_KEY_KP_4)
+}
+
+void Application::enableWorldFeed(const std::string& name)
+{
+    worldFeed = std::make_unique<WorldFeed>(name);
+}
+
+void Application::setNumBots(int newNumBots)
+{
+    numBots = newNumBots;
+}
+
+void Application::setBloomEnabled(bool enabled)
+{
+    if (!enabled)
     {
-        world.getPlayers()[2].setDir(Direction::LEFT);
+        bloom.reset();
         return;
     }
-    if (key == GLFW_KEY_KP_6)
+
+    glm::ivec2 windowSize = getWindowSize(window);
+    bloom = std::make_unique<BloomEffect>(windowSize.x, windowSize.y);
+}
+
+void Application::startRecording(const std::string& filename)
+{
+    glm::ivec2 windowSize = getWindowSize(window);
+    recorder = std::make_unique<VideoRecorder>(filename, windowSize.x, windowSize.y, TimeUtils::fps);
+}
+
+void Application::setMaxFramesInFlight(int maxFrames)
+{
+    if (maxFrames <= 0)
     {
-        world.getPlayers()[2].setDir(Direction::RIGHT);
+        frameLimiter.reset();
         return;
     }
 
-    // Player 4
-    if (key == GLFW_KEY_I)
+    frameLimiter = std::make_unique<FrameLimiter>(maxFrames);
+}
+
+void Application::setFramePacingEnabled(bool enabled)
+{
+    if (!enabled)
     {
-        world.getPlayers()[3].setDir(Direction::UP);
+        framePacer.reset();
         return;
     }
-    if (key == GLFW_KEY_K)
+
+    // Pace to whichever monitor we are shown on
+    GLFWmonitor* monitor = glfwGetWindowMonitor(window);
+    if (!monitor)
     {
-        world.getPlayers()[3].setDir(Direction::DOWN);
-        return;
+        monitor = glfwGetPrimaryMonitor();
     }
-    if (key == GLFW_KEY_J)
+    const GLFWvidmode* videoMode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+    int refreshRate = videoMode && videoMode->refreshRate > 0 ? videoMode->refreshRate : TimeUtils::fps;
+    framePacer = std::make_unique<FramePacer>(1.0 / refreshRate);
+}
+
+void Application::setGameMode(GameMode mode)
+{
+    world.setGameMode(mode);
+    restart();
+}
+
+void Application::setPowerUpsEnabled(bool enabled)
+{
+    powerUpsEnabled = enabled;
+    restart();
+}
+
+void Application::setInputMap(const InputMap& newInputMap)
+{
+    inputMap = newInputMap;
+}
+
+void Application::enableInputLatencyTracking()
+{
+    inputLatency = std::make_unique<InputLatencyTracker>();
+}
+
+void Application::setCameraMode(CameraMode mode, int targetPlayerId)
+{
+    cameraMode = mode;
+    cameraTargetPlayerId = targetPlayerId;
+    layoutCameras();
+}
+
+void Application::setSplitScreen(bool enabled)
+{
+    splitScreen = enabled;
+    layoutCameras();
+}
+
+void Application::layoutCameras()
+{
+    if (!splitScreen)
     {
-        world.getPlayers()[3].setDir(Direction::LEFT);
+        cameras.resize(1, Camera(world.getSize()));
+        cameras[0].setMode(world, cameraMode, cameraTargetPlayerId);
+        renderer.updateViewport(getWindowSize(window));
         return;
     }
-    if (key == GLFW_KEY_L)
+
+    // One camera per player, shaped to fit their part of the screen
+    int numPlayers = static_cast<int>(world.getPlayers().size());
+    float aspectRatio = GameRenderer::getSplitScreenAspectRatio(getWindowSize(window), numPlayers);
+    cameras.resize(numPlayers, Camera(world.getSize()));
+    for (int i = 0; i < numPlayers; ++i)
     {
-        world.getPlayers()[3].setDir(Direction::RIGHT);
-        return;
+        cameras[i].setAspectRatio(aspectRatio);
+        cameras[i].setMode(world, CameraMode::Player, i);
     }
+    renderer.updateViewport(getWindowSize(window));
 }
 
-void Application::windowResized()
+glm::ivec2 Application::getWindowSize(GLFWwindow* window)
 {
-    renderer.updateViewport(window);
+    int width;
+    int height;
+    glfwGetWindowSize(window, &width, &height);
+    return { width, height };
 }
 
-void Application::toggleFullscreen()
+void Application::restart()
 {
-    bool wasFullscreen = windowProps.fullscreen;
-    windowProps.fullscreen = !windowProps.fullscreen;
+    resetWorld(static_cast<int>(world.getPlayers().size()));
 
-    if (wasFullscreen)
+    playing = true;
+}
+
+void Application::resetWorld(int numPlayers)
+{
+    world.reset(numPlayers);
+
+    // The rules only change between matches, so pick them once here rather than every tick
+    movePlayersFunction = world.getGameMode() == GameMode::Inverted ? &Application::movePlayers<GameModes::Inverted>
+                                                                    : &Application::movePlayers<GameModes::Classic>;
+    effects.reset();
+    screenShake.reset();
+    renderer.clearTrails();
+
+    // Pickups start afresh with the new players; resetting the world has already cancelled every timer
+    speedBoostTimers.fill({});
+    if (powerUpsEnabled)
     {
-        // Exit fullscreen - restore previous window settings
-        glfwSetWindowMonitor(window, nullptr, windowProps.x, windowProps.y, windowProps.width, windowProps.height, 0);
+        spawnPickups();
     }
-    else
+
+    // Input from before the reset no longer applies, and may be for a player that no longer exists
+    for (std::deque<InputEvent>& playerInput : pendingInput)
     {
-        // Enter fullscreen - remember current window settings
-        GLFWmonitor* monitor = glfwGetPrimaryMonitor();
-        const GLFWvidmode* vidMode = glfwGetVideoMode(monitor);
-        glfwGetWindowSize(window, &windowProps.width, &windowProps.height);
-        glfwGetWindowPos(window, &windowProps.x, &windowProps.y);
-        glfwSetWindowMonitor(window, monitor, 0, 0, vidMode->width, vidMode->height, vidMode->refreshRate);
+        playerInput.clear();
     }
-}
 
-void Application::restart()
-{
-    world.reset();
+    // Split-screen needs a different layout if the number of players has changed
+    if (splitScreen)
+    {
+        layoutCameras();
+        return;
+    }
 
-    playing = true;
+    cameras[0].snap(world);
 }
 
 void Application::tag(Player& a, Player& b)
@@ -296,6 +633,7 @@ void Application::tag(Player& a, Player& b)
         std::uniform_real_distribution<float> dist(0.f, 1.f);
         taggedPlayer = dist(rng) < 0.5f ? &a : &b;
         world.setTaggedPlayer(taggedPlayer);
+        effects.onTag(taggedPlayer == &a ? b : a, *taggedPlayer);
         return;
     }
 
@@ -304,9 +642,38 @@ void Application::tag(Player& a, Player& b)
     if (taggedPlayer == &a)
     {
         world.setTaggedPlayer(&b);
+        effects.onTag(a, b);
     }
     else if (taggedPlayer == &b)
     {
         world.setTaggedPlayer(&a);
+        effects.onTag(b, a);
+    }
+}
+
+void Application::updateBots()
+{
+    std::vector<Player>& players = world.getPlayers();
+    int numPlayers = static_cast<int>(players.size());
+    int firstBot = std::max(numPlayers - numBots, 0);
+    if (firstBot == numPlayers)
+    {
+        return;
+    }
+
+    // Bots share one FlowField per player, so build them up-front
+    world.updateFlowFields();
+
+    // All bots plan from the same snapshot, so no bot gets to react to another's decision
+    SimState state = SimState::capture(world);
+    std::chrono::nanoseconds budget = botBudgetPerTick / (numPlayers - firstBot);
+
+    for (int i = firstBot; i < numPlayers; ++i)
+    {
+        Direction dir = botPlanner.chooseDirection(state, i, budget);
+        if (dir != players[i].getDir())
+        {
+            players[i].setDir(dir);
+        }
     }
 }
@@ -0,0 +1,97 @@
+#include "AsyncReadback.h"
+
+#include <cstring>  // memcpy
+
+AsyncReadback::AsyncReadback(int width, int height, int numBuffers)
+    : width(width)
+    , height(height)
+    , slots(numBuffers)
+{
+    const GLsizeiptr bufferSize = static_cast<GLsizeiptr>(width) * height * Image::bytesPerPixel;
+    for (Slot& slot : slots)
+    {
+        glGenBuffers(1, &slot.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, bufferSize, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+AsyncReadback::~AsyncReadback()
+{
+    for (Slot& slot : slots)
+    {
+        if (slot.fence)
+        {
+            glDeleteSync(slot.fence);
+        }
+        glDeleteBuffers(1, &slot.pbo);
+    }
+}
+
+bool AsyncReadback::request()
+{
+    if (numPending == static_cast<int>(slots.size()))
+    {
+        return false;
+    }
+
+    Slot& slot = slots[(oldest + numPending) % slots.size()];
+
+    // With a pack buffer bound, this returns immediately and the copy happens on the GPU
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    ++numPending;
+    return true;
+}
+
+bool AsyncReadback::poll(Image& image, bool wait)
+{
+    if (numPending == 0)
+    {
+        return false;
+    }
+
+    Slot& slot = slots[oldest];
+
+    // Flush on the first check, otherwise the fence may never be submitted
+    constexpr GLuint64 waitTimeout = 1'000'000;  // 1ms
+    GLenum result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? waitTimeout : 0);
+    while (wait && result == GL_TIMEOUT_EXPIRED)
+    {
+        result = glClientWaitSync(slot.fence, 0, waitTimeout);
+    }
+    if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+    {
+        return false;
+    }
+
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    oldest = (oldest + 1) % slots.size();
+    --numPending;
+
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(static_cast<size_t>(width) * height * Image::bytesPerPixel);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    const uint8_t* src = static_cast<const uint8_t*>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+    if (src)
+    {
+        // OpenGL stores the bottom row first
+        const size_t rowSize = static_cast<size_t>(width) * Image::bytesPerPixel;
+        for (int y = 0; y < height; ++y)
+        {
+            std::memcpy(&image.pixels[y * rowSize], src + (height - 1 - y) * rowSize, rowSize);
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    return src != nullptr;
+}
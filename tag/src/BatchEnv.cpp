@@ -0,0 +1,169 @@
+#include "BatchEnv.h"
+
+#include <new>
+#include <vector>
+
+#include "SimState.h"
+#include "World.h"
+
+struct TagBatchEnv
+{
+    int numEnvs;
+    int numPlayers;
+
+    /** State that every environment is reset to (apart from its random seed). */
+    SimState initialState;
+
+    std::vector<SimState> states;
+    std::vector<int> episodeTicks;
+
+    uint32_t nextSeed;
+};
+
+static void resetEnv(TagBatchEnv* env, int envIndex)
+{
+    SimState& state = env->states[envIndex];
+    state = env->initialState;
+    state.setSeed(env->nextSeed++);
+    env->episodeTicks[envIndex] = 0;
+}
+
+static void writeObservations(const TagBatchEnv* env, int envIndex, float* observations)
+{
+    const SimState& state = env->states[envIndex];
+    const glm::vec2 worldExtents = World::defaultSize / 2.f;
+
+    float* out = observations + envIndex * env->numPlayers * TAG_ENV_OBS_PER_PLAYER;
+    for (int i = 0; i < env->numPlayers; ++i)
+    {
+        const SimState::SimPlayer& player = state.getPlayer(i);
+        *out++ = player.pos.x / worldExtents.x;
+        *out++ = player.pos.y / worldExtents.y;
+        *out++ = player.speed / SimState::getBaseSpeed();
+        *out++ = state.getTaggedPlayer() == i ? 1.f : 0.f;
+        *out++ = player.timeRemaining / SimState::getMaxTime();
+    }
+}
+
+/**
+ * Advances every environment by one tick, rewarding players under the rules of the given GameModes policy.
+ */
+template <typename Mode>
+static void stepEnvs(TagBatchEnv* env, const uint8_t* actions, float* observations, float* rewards, uint8_t* dones)
+{
+    const int numPlayers = env->numPlayers;
+
+    for (int envIndex = 0; envIndex < env->numEnvs; ++envIndex)
+    {
+        SimState& state = env->states[envIndex];
+        const uint8_t* envActions = actions + envIndex * numPlayers;
+        float* envRewards = rewards + envIndex * numPlayers;
+
+        // Apply actions, remembering everyone's score so we can reward any change
+        float scoreBefore[World::maxPlayers];
+        for (int i = 0; i < numPlayers; ++i)
+        {
+            uint8_t action = envActions[i];
+            state.setDir(i, action < TAG_ENV_NUM_ACTIONS ? static_cast<Direction>(action) : Direction::NONE);
+            scoreBefore[i] = Mode::score(state.getPlayer(i).timeRemaining);
+        }
+
+        state.tick();
+        ++env->episodeTicks[envIndex];
+
+        for (int i = 0; i < numPlayers; ++i)
+        {
+            envRewards[i] = (Mode::score(state.getPlayer(i).timeRemaining) - scoreBefore[i]) / SimState::getMaxTime();
+        }
+
+        bool done = state.isFinished() || env->episodeTicks[envIndex] >= TAG_ENV_MAX_EPISODE_TICKS;
+        if (state.isFinished())
+        {
+            for (int i = 0; i < numPlayers; ++i)
+            {
+                envRewards[i] += state.getWinner() == i ? 1.f : -1.f;
+            }
+        }
+
+        dones[envIndex] = done ? 1 : 0;
+        if (done)
+        {
+            resetEnv(env, envIndex);
+        }
+
+        writeObservations(env, envIndex, observations);
+    }
+}
+
+TagBatchEnv* tagEnvCreate(int numEnvs, int numPlayers, uint32_t seed)
+{
+    if (numEnvs <= 0 || numPlayers < World::minPlayers || numPlayers > World::maxPlayers)
+    {
+        return nullptr;
+    }
+
+    TagBatchEnv* env = new (std::nothrow) TagBatchEnv;
+    if (!env)
+    {
+        return nullptr;
+    }
+
+    try
+    {
+        World world(World::defaultSize, numPlayers);
+        env->numEnvs = numEnvs;
+        env->numPlayers = numPlayers;
+        env->initialState = SimState::capture(world);
+        env->states.resize(numEnvs);
+        env->episodeTicks.resize(numEnvs);
+        env->nextSeed = seed;
+    }
+    catch (const std::bad_alloc&)
+    {
+        delete env;
+        return nullptr;
+    }
+
+    for (int i = 0; i < numEnvs; ++i)
+    {
+        resetEnv(env, i);
+    }
+
+    return env;
+}
+
+void tagEnvDestroy(TagBatchEnv* env)
+{
+    delete env;
+}
+
+int tagEnvGetNumEnvs(const TagBatchEnv* env)
+{
+    return env->numEnvs;
+}
+
+int tagEnvGetNumPlayers(const TagBatchEnv* env)
+{
+    return env->numPlayers;
+}
+
+void tagEnvReset(TagBatchEnv* env, float* observations)
+{
+    for (int i = 0; i < env->numEnvs; ++i)
+    {
+        resetEnv(env, i);
+        writeObservations(env, i, observations);
+    }
+}
+
+void tagEnvStep(TagBatchEnv* env, const uint8_t* actions, float* observations, float* rewards, uint8_t* dones)
+{
+    if (env->initialState.getGameMode() == GameMode::Inverted)
+    {
+        stepEnvs<GameModes::Inverted>(env, actions, observations, rewards, dones);
+    }
+    else
+    {
+        stepEnvs<GameModes::Classic>(env, actions, observations, rewards, dones);
+    }
+}
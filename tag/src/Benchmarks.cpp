@@ -0,0 +1,734 @@
+#include "Benchmarks.h"
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>  // min, sort
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Application.h"
+#include "BatchEnv.h"
+#include "BotPlanner.h"
+#include "FlowField.h"
+#include "GameRenderer.h"
+#include "LevelFile.h"
+#include "Levels.h"
+#include "ParticleSystem.h"
+#include "ScriptedMatch.h"
+#include "Shaders.h"
+#include "SimState.h"
+#include "ThreadPool.h"
+#include "TimeUtils.h"
+#include "TimerWheel.h"
+#include "World.h"
+
+namespace Benchmarks {
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+/**
+ * Distribution of a set of timings, in milliseconds.
+ */
+struct TimingSummary
+{
+    double min = 0.0;
+    double avg = 0.0;
+    double p50 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+    double max = 0.0;
+};
+
+TimingSummary summarize(std::vector<double> samples)
+{
+    TimingSummary summary;
+    if (samples.empty())
+    {
+        return summary;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    // Nearest-rank percentiles, so every reported value is a real sample
+    auto percentile = [&](double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p * samples.size()));
+        return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+    };
+
+    double total = 0.0;
+    for (double sample : samples)
+    {
+        total += sample;
+    }
+
+    summary.min = samples.front();
+    summary.avg = total / samples.size();
+    summary.p50 = percentile(0.5);
+    summary.p99 = percentile(0.99);
+    summary.p999 = percentile(0.999);
+    summary.max = samples.back();
+    return summary;
+}
+
+/**
+ * Escapes a string for use within a JSON string literal.
+ */
+std::string escapeJson(const std::string& str)
+{
+    std::string escaped;
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        if (static_cast<unsigned char>(c) >= 0x20)
+        {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+void writeJson(std::ostream& out, const char* name, const TimingSummary& summary)
+{
+    out << "    \"" << name << "\": { \"min\": " << summary.min << ", \"avg\": " << summary.avg
+        << ", \"p50\": " << summary.p50 << ", \"p99\": " << summary.p99 << ", \"p99.9\": " << summary.p999
+        << ", \"max\": " << summary.max << " }";
+}
+
+std::string getGlString(GLenum name)
+{
+    const GLubyte* str = glGetString(name);
+    return str ? reinterpret_cast<const char*>(str) : "";
+}
+
+/**
+ * Scatters small boxes across the world, the same way every time.
+ */
+std::vector<Rect> makeDecorations(int count, glm::vec2 worldSize)
+{
+    constexpr float maxExtents = 0.4f;
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> xDist(-worldSize.x / 2.f, worldSize.x / 2.f);
+    std::uniform_real_distribution<float> yDist(-worldSize.y / 2.f, worldSize.y / 2.f);
+    std::uniform_real_distribution<float> extentsDist(0.05f, maxExtents);
+
+    std::vector<Rect> decorations;
+    decorations.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        decorations.push_back({ { xDist(rng), yDist(rng) }, { extentsDist(rng), extentsDist(rng) } });
+    }
+    return decorations;
+}
+
+}  // namespace
+
+int run(const std::string& name, const RenderOptions& renderOptions)
+{
+    if (name == "bots")
+    {
+        return runBotBenchmark();
+    }
+    if (name == "batchenv")
+    {
+        return runBatchEnvBenchmark();
+    }
+    if (name == "flowfield")
+    {
+        return runFlowFieldBenchmark();
+    }
+    if (name == "obstacles")
+    {
+        return runObstacleBenchmark();
+    }
+    if (name == "levelstream")
+    {
+        return runLevelStreamBenchmark();
+    }
+    if (name == "particles")
+    {
+        return runParticleBenchmark();
+    }
+    if (name == "timers")
+    {
+        return runTimerBenchmark();
+    }
+    if (name == "render")
+    {
+        return runRenderBenchmark(renderOptions);
+    }
+
+    std::cerr << "Unknown benchmark: " << name << "\n";
+    return -1;
+}
+
+int runBotBenchmark()
+{
+    static constexpr int numDecisions = 20;
+    static constexpr std::chrono::milliseconds budgetPerDecision { 50 };
+
+    // Set up a mid-game state so that rollouts exercise all the rules
+    World world(World::defaultSize, World::maxPlayers);
+    world.setTaggedPlayer(&world.getPlayers()[0]);
+    world.getPlayers()[1].setDir(Direction::LEFT);
+    world.getPlayers()[2].setDir(Direction::UP);
+    SimState state = SimState::capture(world);
+
+    int maxThreads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+
+    for (int numThreads = 1; numThreads <= maxThreads; numThreads = std::min(numThreads * 2, maxThreads))
+    {
+        ThreadPool threadPool(numThreads - 1);
+        BotPlanner planner(threadPool);
+
+        Clock::time_point startTime = Clock::now();
+        for (int i = 0; i < numDecisions; ++i)
+        {
+            planner.chooseDirection(state, 0, budgetPerDecision);
+        }
+        std::chrono::duration<double> elapsed = Clock::now() - startTime;
+
+        double rolloutsPerSec = planner.getNumRollouts() / elapsed.count();
+        std::cout << "threads: " << numThreads << ", rollouts/sec: " << static_cast<long long>(rolloutsPerSec) << "\n";
+
+        if (numThreads == maxThreads)
+        {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+int runBatchEnvBenchmark()
+{
+    static constexpr int numEnvs = 256;
+    static constexpr int numPlayers = World::maxPlayers;
+    static constexpr int numSteps = 4000;
+
+    // Agents change direction at random every so often
+    static constexpr int numActionSets = 64;
+    static constexpr int stepsPerActionSet = 30;
+
+    TagBatchEnv* env = tagEnvCreate(numEnvs, numPlayers, 1234);
+    if (!env)
+    {
+        std::cerr << "Failed to create batch environment\n";
+        return -1;
+    }
+
+    // Allocate all buffers up-front, as a training job would
+    std::vector<uint8_t> actions(numActionSets * numEnvs * numPlayers);
+    std::vector<float> observations(numEnvs * numPlayers * TAG_ENV_OBS_PER_PLAYER);
+    std::vector<float> rewards(numEnvs * numPlayers);
+    std::vector<uint8_t> dones(numEnvs);
+
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> actionDist(0, TAG_ENV_NUM_ACTIONS - 1);
+    for (uint8_t& action : actions)
+    {
+        action = static_cast<uint8_t>(actionDist(rng));
+    }
+
+    tagEnvReset(env, observations.data());
+
+    long long numEpisodes = 0;
+    Clock::time_point startTime = Clock::now();
+    for (int step = 0; step < numSteps; ++step)
+    {
+        int actionSet = (step / stepsPerActionSet) % numActionSets;
+        const uint8_t* stepActions = actions.data() + actionSet * numEnvs * numPlayers;
+        tagEnvStep(env, stepActions, observations.data(), rewards.data(), dones.data());
+
+        for (uint8_t done : dones)
+        {
+            numEpisodes += done;
+        }
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - startTime;
+
+    tagEnvDestroy(env);
+
+    double stepsPerSec = static_cast<double>(numEnvs) * numSteps / elapsed.count();
+    std::cout << "envs: " << numEnvs << ", players: " << numPlayers << ", episodes: " << numEpisodes
+              << ", env-steps/sec: " << static_cast<long long>(stepsPerSec) << "\n";
+
+    return 0;
+}
+
+int runFlowFieldBenchmark()
+{
+    static constexpr int gridSizes[] = { 64, 256, 1024 };
+    static constexpr int agentCounts[] = { 100, 500 };
+    static constexpr int numTicks = 50;
+
+    // Fraction of cells that are blocked
+    static constexpr float obstacleDensity = 0.2f;
+
+    for (int gridSize : gridSizes)
+    {
+        // One world unit per cell
+        glm::vec2 worldSize(static_cast<float>(gridSize), static_cast<float>(gridSize));
+        glm::vec2 worldExtents = worldSize / 2.f;
+        NavGrid grid(worldSize, 1.f);
+
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> unitDist(0.f, 1.f);
+        for (int y = 0; y < gridSize; ++y)
+        {
+            for (int x = 0; x < gridSize; ++x)
+            {
+                grid.setBlocked(x, y, unitDist(rng) < obstacleDensity);
+            }
+        }
+
+        // Keep the centre clear, for a target that doesn't move
+        grid.setBlocked(gridSize / 2, gridSize / 2, false);
+
+        FlowField field(grid);
+        std::uniform_real_distribution<float> posDist(-worldExtents.x, worldExtents.x);
+
+        // Pick targets up-front, avoiding blocked cells
+        std::vector<glm::vec2> targets;
+        while (targets.size() < numTicks)
+        {
+            glm::vec2 target { posDist(rng), posDist(rng) };
+            if (!grid.isBlocked(grid.getCellIndex(target)))
+            {
+                targets.push_back(target);
+            }
+        }
+
+        // Rebuild: the target moves to a new cell every tick
+        Clock::time_point startTime = Clock::now();
+        for (const glm::vec2& target : targets)
+        {
+            field.update(target);
+        }
+        std::chrono::duration<double, std::milli> rebuildTime = (Clock::now() - startTime) / numTicks;
+
+        // Repair: the target wanders into a neighbouring cell every tick
+        glm::vec2 targetPos { 0.f, 0.f };
+        std::vector<glm::vec2> walk { targetPos };
+        std::uniform_int_distribution<int> stepDist(0, 3);
+        static constexpr glm::vec2 steps[] = { { 0.f, -1.f }, { 0.f, 1.f }, { -1.f, 0.f }, { 1.f, 0.f } };
+        while (walk.size() <= numTicks)
+        {
+            glm::vec2 next = walk.back() + steps[stepDist(rng)];
+            if (std::abs(next.x) < worldExtents.x && std::abs(next.y) < worldExtents.y
+                    && !grid.isBlocked(grid.getCellIndex(next)))
+            {
+                walk.push_back(next);
+            }
+        }
+        field.update(walk.front());
+        startTime = Clock::now();
+        for (int tick = 1; tick <= numTicks; ++tick)
+        {
+            field.update(walk[tick]);
+        }
+        std::chrono::duration<double, std::micro> repairTime = (Clock::now() - startTime) / numTicks;
+
+        // Reuse: the target stays in the same cell
+        field.update(targetPos);
+        startTime = Clock::now();
+        for (int tick = 0; tick < numTicks; ++tick)
+        {
+            field.update(targetPos);
+        }
+        std::chrono::duration<double, std::micro> reuseTime = (Clock::now() - startTime) / numTicks;
+
+        std::cout << "grid: " << gridSize << "x" << gridSize << ", rebuild: " << rebuildTime.count()
+                  << " ms, repair: " << repairTime.count() << " us, reuse: " << reuseTime.count() << " us\n";
+
+        // Lookups: every agent reads the field once per tick
+        for (int numAgents : agentCounts)
+        {
+            std::vector<glm::vec2> agents(numAgents);
+            for (glm::vec2& agent : agents)
+            {
+                agent = { posDist(rng), posDist(rng) };
+            }
+
+            int numMoving = 0;
+            startTime = Clock::now();
+            for (int tick = 0; tick < numTicks; ++tick)
+            {
+                for (const glm::vec2& agent : agents)
+                {
+                    numMoving += field.getDirectionTowards(agent) != Direction::NONE;
+                }
+            }
+            std::chrono::duration<double, std::micro> lookupTime = (Clock::now() - startTime) / numTicks;
+
+            std::cout << "    agents: " << numAgents << ", lookups per tick: " << lookupTime.count()
+                      << " us (" << numMoving / numTicks << " agents can reach the target)\n";
+        }
+    }
+
+    return 0;
+}
+
+int runObstacleBenchmark()
+{
+    static constexpr float worldSizes[] = { 24.f, 96.f, 384.f, 1536.f };
+    static constexpr float mazeCellSize = 3.f;
+    static constexpr int numMoves = 1000000;
+
+    for (float worldSize : worldSizes)
+    {
+        glm::vec2 size(worldSize, worldSize * 0.75f);
+        std::vector<Rect> walls = Levels::makeMaze(size, mazeCellSize, 1234);
+        size_t numWalls = walls.size();
+
+        Clock::time_point startTime = Clock::now();
+        World world(size, World::minPlayers, std::move(walls));
+        std::chrono::duration<double, std::milli> buildTime = Clock::now() - startTime;
+
+        // Move from random positions in random directions, at the maximum speed a player can reach
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> xDist(-size.x / 2.f, size.x / 2.f);
+        std::uniform_real_distribution<float> yDist(-size.y / 2.f, size.y / 2.f);
+        std::uniform_int_distribution<int> dirDist(1, 4);
+        std::vector<glm::vec2> starts(1024);
+        std::vector<glm::vec2> deltas(starts.size());
+        for (size_t i = 0; i < starts.size(); ++i)
+        {
+            starts[i] = { xDist(rng), yDist(rng) };
+            deltas[i] = SimState::getDirVector(static_cast<Direction>(dirDist(rng))) * 0.25f;
+        }
+
+        float checksum = 0.f;
+        startTime = Clock::now();
+        for (int i = 0; i < numMoves; ++i)
+        {
+            size_t index = i % starts.size();
+            glm::vec2 pos = world.resolveMovement(starts[index], starts[index] + deltas[index], Player::extents);
+            checksum += pos.x;
+        }
+        std::chrono::duration<double, std::nano> moveTime = (Clock::now() - startTime) / numMoves;
+
+        std::cout << "walls: " << numWalls << ", build: " << buildTime.count() << " ms, move: " << moveTime.count()
+                  << " ns (checksum " << checksum << ")\n";
+    }
+
+    return 0;
+}
+
+int runLevelStreamBenchmark()
+{
+    static constexpr int levelSizes[] = { 1024, 4096, 16384 };
+    static constexpr int numTicks = 20000;
+
+    std::filesystem::path filename = std::filesystem::temp_directory_path() / "tag-benchmark.tagl";
+
+    for (int levelSize : levelSizes)
+    {
+        Clock::time_point startTime = Clock::now();
+        Levels::writeRoomsLevelFile(filename.string(), levelSize, levelSize, 1234);
+        std::chrono::duration<double, std::milli> writeTime = Clock::now() - startTime;
+        double fileSizeMb = std::filesystem::file_size(filename) / (1024.0 * 1024.0);
+
+        {
+            startTime = Clock::now();
+            Levels::Level level = Levels::loadLevelFile(filename.string());
+            World world(level.size, World::maxPlayers, std::move(level.obstacles), std::move(level.tileMap));
+            std::chrono::duration<double, std::milli> loadTime = Clock::now() - startTime;
+            TileMap& tileMap = *world.getTileMap();
+
+            // Send each player off in a different diagonal direction, faster than a player can move.
+            // This crosses a new chunk every few dozen ticks, so streaming happens constantly.
+            static constexpr float speed = 0.25f;
+            const glm::vec2 directions[] = { { 1.f, 1.f }, { -1.f, 1.f }, { 1.f, -1.f }, { -1.f, -1.f } };
+            glm::vec2 range = level.size - glm::vec2(2.f, 2.f);
+            std::vector<glm::vec2> focusPoints(World::maxPlayers);
+
+            int maxResidentChunks = 0;
+            std::chrono::nanoseconds worstUpdate(0);
+            float checksum = 0.f;
+            startTime = Clock::now();
+            for (int tick = 0; tick < numTicks; ++tick)
+            {
+                // Bounce back and forth across the level
+                for (int i = 0; i < World::maxPlayers; ++i)
+                {
+                    glm::vec2 travel = directions[i] * (speed * tick) + range / 2.f;
+                    float x = std::fmod(std::abs(travel.x), 2.f * range.x);
+                    float y = std::fmod(std::abs(travel.y), 2.f * range.y);
+                    x = std::min(x, 2.f * range.x - x);
+                    y = std::min(y, 2.f * range.y - y);
+                    focusPoints[i] = glm::vec2(x, y) - range / 2.f;
+                }
+
+                Clock::time_point updateStart = Clock::now();
+                tileMap.update(focusPoints);
+                worstUpdate = std::max(worstUpdate, std::chrono::nanoseconds(Clock::now() - updateStart));
+                maxResidentChunks = std::max(maxResidentChunks, tileMap.getNumResidentChunks());
+
+                // Collide against whatever was just streamed in
+                for (int i = 0; i < World::maxPlayers; ++i)
+                {
+                    glm::vec2 pos = focusPoints[i];
+                    checksum += world.resolveMovement(pos, pos + directions[i] * speed, Player::extents).x;
+                }
+            }
+            std::chrono::duration<double, std::micro> tickTime = (Clock::now() - startTime) / numTicks;
+            std::chrono::duration<double, std::micro> worstTime = worstUpdate;
+            double residentKb = maxResidentChunks * tileMap.getChunkSize() * tileMap.getChunkSize() / 1024.0;
+
+            std::cout << "tiles: " << levelSize << "x" << levelSize << ", file: " << fileSizeMb << " MB (written in "
+                      << writeTime.count() << " ms), load: " << loadTime.count() << " ms, tick: " << tickTime.count()
+                      << " us (worst " << worstTime.count() << " us), decoded: " << tileMap.getNumChunksDecoded()
+                      << " chunks, max resident: " << maxResidentChunks << " chunks (" << residentKb
+                      << " KB) (checksum " << checksum << ")\n";
+        }
+
+        std::filesystem::remove(filename);
+    }
+
+    return 0;
+}
+
+int runParticleBenchmark()
+{
+    static constexpr int capacity = 1 << 17;
+    static constexpr int burstSize = 100000;
+    static constexpr int numTicks = 600;
+
+    std::cout << "SIMD: " << (ParticleSystem::isSimdEnabled() ? "enabled" : "disabled") << "\n";
+
+    ParticleSystem particles(capacity);
+
+    ParticleBurst burst;
+    burst.count = burstSize;
+    burst.spawnRadius = 1.f;
+    burst.minSpeed = 1.f;
+    burst.maxSpeed = 8.f;
+    burst.minLifetime = 4.f;
+    burst.maxLifetime = 12.f;
+
+    // Emit one huge burst, then keep topping it up so that the pool stays close to full
+    Clock::time_point startTime = Clock::now();
+    particles.emit(burst);
+    std::chrono::duration<double, std::milli> emitTime = Clock::now() - startTime;
+
+    burst.count = 2000;
+    std::vector<double> updateTimes;
+    updateTimes.reserve(numTicks);
+    long long totalParticles = 0;
+    for (int tick = 0; tick < numTicks; ++tick)
+    {
+        startTime = Clock::now();
+        particles.update(TimeUtils::frameTime);
+        updateTimes.push_back(std::chrono::duration<double, std::milli>(Clock::now() - startTime).count());
+
+        totalParticles += particles.getCount();
+        particles.emit(burst);
+    }
+
+    std::sort(updateTimes.begin(), updateTimes.end());
+    double meanTime = 0.0;
+    for (double t : updateTimes)
+    {
+        meanTime += t;
+    }
+    meanTime /= numTicks;
+
+    std::cout << "emit " << burstSize << ": " << emitTime.count() << " ms\n";
+    std::cout << "update (avg " << totalParticles / numTicks << " particles): mean " << meanTime << " ms, p50 "
+              << updateTimes[numTicks / 2] << " ms, p99 " << updateTimes[numTicks * 99 / 100] << " ms, max "
+              << updateTimes.back() << " ms\n";
+
+    return 0;
+}
+
+int runTimerBenchmark()
+{
+    static constexpr int numPairs = 500000;
+    static constexpr uint32_t maxDueTick = 100000;
+
+    // Timers are scheduled in pairs due on the same tick, and whichever fires first cancels the other
+    TimerWheel<int> timers;
+    std::vector<TimerHandle> handles(numPairs * 2);
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<uint32_t> dueDist(0, maxDueTick);
+
+    Clock::time_point startTime = Clock::now();
+    for (int pair = 0; pair < numPairs; ++pair)
+    {
+        uint32_t dueTick = dueDist(rng);
+        handles[pair * 2] = timers.schedule(dueTick, pair * 2);
+        handles[pair * 2 + 1] = timers.schedule(dueTick, pair * 2 + 1);
+    }
+    std::chrono::duration<double, std::milli> scheduleTime = Clock::now() - startTime;
+
+    std::vector<uint8_t> fired(handles.size(), 0);
+    int numFired = 0;
+    bool partnerFired = false;
+
+    startTime = Clock::now();
+    while (timers.getNumPending() > 0)
+    {
+        timers.advance([&](int id) {
+            fired[id] = 1;
+            ++numFired;
+
+            // The partner is still pending unless it was wrongly fired, or cancelled but fired anyway
+            int partner = id ^ 1;
+            partnerFired |= fired[partner] || !timers.cancel(handles[partner]);
+        });
+    }
+    std::chrono::duration<double, std::milli> advanceTime = Clock::now() - startTime;
+
+    std::cout << "schedule " << handles.size() << ": " << scheduleTime.count() << " ms\n";
+    std::cout << "advance " << timers.getCurrentTick() << " ticks: " << advanceTime.count() << " ms ("
+              << advanceTime.count() * 1e6 / handles.size() << " ns per timer)\n";
+
+    if (partnerFired || numFired != numPairs)
+    {
+        std::cerr << "Timers cancelled while advancing were not removed (" << numFired << " of " << numPairs
+                  << " expected timers fired)\n";
+        return -1;
+    }
+
+    return 0;
+}
+
+int runRenderBenchmark(const RenderOptions& options)
+{
+    static constexpr int windowWidth = 800;
+    static constexpr int windowHeight = 600;
+
+    // Time to let the winner's celebration play out before restarting the match
+    static constexpr int celebrationTicks = 120;
+
+    if (!glfwInit())
+    {
+        std::cerr << "Failed to initialize GLFW\n";
+        return -1;
+    }
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(windowWidth, windowHeight, "Tag render benchmark", nullptr, nullptr);
+    if (!window)
+    {
+        std::cerr << "Failed to create window\n";
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+
+    GLenum glewStatus = glewInit();
+    if (glewStatus != GLEW_OK)
+    {
+        std::cerr << "Failed to initialize GLEW: " << glewGetErrorString(glewStatus) << "\n";
+        glfwTerminate();
+        return -1;
+    }
+
+    Shaders::initializeShaders();
+
+    // Never wait for the display, so we measure how fast we can go
+    glfwSwapInterval(0);
+
+    std::vector<double> frameTimes;
+    std::vector<double> tickTimes;
+    std::vector<double> renderTimes;
+    std::vector<double> swapTimes;
+    {
+        int width;
+        int height;
+        glfwGetWindowSize(window, &width, &height);
+
+        ScriptedMatch match(options.numPlayers);
+        GameRenderer renderer(
+                { width, height }, &match.world, &match.cameras, &match.particles, &match.screenShake);
+        renderer.setDecorations(
+                makeDecorations(options.numDecorations, match.world.getSize()), { 0.25f, 0.25f, 0.3f, 1.f });
+
+        // One tick per frame, with no throttling; the match plays faster than real time
+        int finishedTicks = 0;
+        Clock::time_point benchmarkStartTime = Clock::now();
+        std::chrono::duration<double> duration(options.durationSeconds);
+        while (Clock::now() - benchmarkStartTime < duration && !glfwWindowShouldClose(window))
+        {
+            Clock::time_point frameStartTime = Clock::now();
+            glfwPollEvents();
+
+            match.tick();
+            if (match.isFinished() && ++finishedTicks >= celebrationTicks)
+            {
+                match.restart();
+                renderer.clearTrails();
+                finishedTicks = 0;
+            }
+            Clock::time_point tickEndTime = Clock::now();
+
+            renderer.render(std::chrono::duration<double>(tickEndTime - benchmarkStartTime).count());
+            Clock::time_point renderEndTime = Clock::now();
+
+            glfwSwapBuffers(window);
+            Clock::time_point swapEndTime = Clock::now();
+
+            using Ms = std::chrono::duration<double, std::milli>;
+            tickTimes.push_back(Ms(tickEndTime - frameStartTime).count());
+            renderTimes.push_back(Ms(renderEndTime - tickEndTime).count());
+            swapTimes.push_back(Ms(swapEndTime - renderEndTime).count());
+            frameTimes.push_back(Ms(swapEndTime - frameStartTime).count());
+        }
+    }
+
+    std::ofstream outputFile;
+    if (!options.outputFilename.empty())
+    {
+        outputFile.open(options.outputFilename);
+        if (!outputFile)
+        {
+            std::cerr << "Failed to open benchmark output file: " << options.outputFilename << "\n";
+            glfwTerminate();
+            return -1;
+        }
+    }
+    std::ostream& out = options.outputFilename.empty() ? std::cout : outputFile;
+
+    out << "{\n";
+    out << "    \"benchmark\": \"render\",\n";
+    out << "    \"vendor\": \"" << escapeJson(getGlString(GL_VENDOR)) << "\",\n";
+    out << "    \"renderer\": \"" << escapeJson(getGlString(GL_RENDERER)) << "\",\n";
+    out << "    \"version\": \"" << escapeJson(getGlString(GL_VERSION)) << "\",\n";
+    out << "    \"width\": " << windowWidth << ",\n";
+    out << "    \"height\": " << windowHeight << ",\n";
+    out << "    \"numPlayers\": " << options.numPlayers << ",\n";
+    out << "    \"numDecorations\": " << options.numDecorations << ",\n";
+    out << "    \"durationSeconds\": " << options.durationSeconds << ",\n";
+    out << "    \"numFrames\": " << frameTimes.size() << ",\n";
+    writeJson(out, "frameMs", summarize(frameTimes));
+    out << ",\n";
+    writeJson(out, "tickMs", summarize(tickTimes));
+    out << ",\n";
+    writeJson(out, "renderMs", summarize(renderTimes));
+    out << ",\n";
+    writeJson(out, "swapMs", summarize(swapTimes));
+    out << "\n}\n";
+
+    glfwTerminate();
+    return 0;
+}
+
+}  // namespace Benchmarks
@@ -0,0 +1,208 @@
+#include "BloomEffect.h"
+
+#include <algorithm>  // max
+#include <iostream>
+#include <stdexcept>
+
+#include "Shaders.h"
+
+BloomEffect::BloomEffect(int width, int height)
+{
+    glGenVertexArrays(1, &emptyVao);
+    glGenQueries(numTimerQueries, timerQueries);
+    resize(width, height);
+}
+
+BloomEffect::~BloomEffect()
+{
+    destroyTarget(scene);
+    destroyTarget(halfTarget);
+    destroyTarget(halfScratch);
+    destroyTarget(quarterTarget);
+    destroyTarget(quarterScratch);
+    glDeleteQueries(numTimerQueries, timerQueries);
+    glDeleteVertexArrays(1, &emptyVao);
+}
+
+void BloomEffect::resize(int width, int height)
+{
+    width = std::max(width, 1);
+    height = std::max(height, 1);
+    int halfWidth = std::max(width / 2, 1);
+    int halfHeight = std::max(height / 2, 1);
+    int quarterWidth = std::max(width / 4, 1);
+    int quarterHeight = std::max(height / 4, 1);
+
+    createTarget(scene, width, height);
+    createTarget(halfTarget, halfWidth, halfHeight);
+    createTarget(halfScratch, halfWidth, halfHeight);
+    createTarget(quarterTarget, quarterWidth, quarterHeight);
+    createTarget(quarterScratch, quarterWidth, quarterHeight);
+}
+
+void BloomEffect::begin()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, scene.fbo);
+}
+
+void BloomEffect::end()
+{
+    collectGpuTime();
+    glBeginQuery(GL_TIME_ELAPSED, timerQueries[frameIndex % numTimerQueries]);
+
+    // Every pass overwrites its target completely
+    GLboolean blendEnabled = glIsEnabled(GL_BLEND);
+    glDisable(GL_BLEND);
+    glBindVertexArray(emptyVao);
+    glActiveTexture(GL_TEXTURE0);
+
+    // Extract the bright parts of the scene at half resolution.
+    // Linear filtering averages each 2x2 block of the scene as we go.
+    glUseProgram(Shaders::brightPassShader.programId);
+    glUniform1i(Shaders::brightPassShader.sourceUniformLoc, 0);
+    glUniform1f(Shaders::brightPassShader.thresholdUniformLoc, threshold);
+    glUniform1f(Shaders::brightPassShader.kneeUniformLoc, knee);
+    glBindTexture(GL_TEXTURE_2D, scene.texture);
+    drawToTarget(halfTarget);
+
+    // Blur at half resolution for a tight glow
+    blur(halfTarget, halfScratch);
+
+    // Downsample again and blur at quarter resolution for a wide glow
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, halfTarget.fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, quarterTarget.fbo);
+    glBlitFramebuffer(
+            0,
+            0,
+            halfTarget.width,
+            halfTarget.height,
+            0,
+            0,
+            quarterTarget.width,
+            quarterTarget.height,
+            GL_COLOR_BUFFER_BIT,
+            GL_LINEAR);
+    blur(quarterTarget, quarterScratch);
+
+    // Combine everything into the window
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, scene.width, scene.height);
+    glUseProgram(Shaders::compositeShader.programId);
+    glUniform1i(Shaders::compositeShader.sceneUniformLoc, 0);
+    glUniform1i(Shaders::compositeShader.bloomHalfUniformLoc, 1);
+    glUniform1i(Shaders::compositeShader.bloomQuarterUniformLoc, 2);
+    glUniform1f(Shaders::compositeShader.strengthUniformLoc, strength);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, scene.texture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, halfTarget.texture);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, quarterTarget.texture);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    // Restore state for the next frame
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(0);
+    if (blendEnabled)
+    {
+        glEnable(GL_BLEND);
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    ++frameIndex;
+}
+
+void BloomEffect::createTarget(RenderTarget& target, int width, int height)
+{
+    destroyTarget(target);
+    target.width = width;
+    target.height = height;
+
+    // Half-float colour lets bright, overlapping effects go above 1 before the bright pass
+    glGenTextures(1, &target.texture);
+    glBindTexture(GL_TEXTURE_2D, target.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_HALF_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenFramebuffers(1, &target.fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.texture, 0);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        throw std::runtime_error("Failed to create bloom framebuffer");
+    }
+}
+
+void BloomEffect::destroyTarget(RenderTarget& target)
+{
+    if (target.fbo != 0)
+    {
+        glDeleteFramebuffers(1, &target.fbo);
+        glDeleteTextures(1, &target.texture);
+    }
+    target = RenderTarget();
+}
+
+void BloomEffect::drawToTarget(const RenderTarget& target) const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+    glViewport(0, 0, target.width, target.height);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+void BloomEffect::blur(const RenderTarget& target, const RenderTarget& scratch) const
+{
+    glUseProgram(Shaders::blurShader.programId);
+    glUniform1i(Shaders::blurShader.sourceUniformLoc, 0);
+
+    // Horizontal pass into the scratch target
+    glUniform2f(Shaders::blurShader.texelStepUniformLoc, 1.f / target.width, 0.f);
+    glBindTexture(GL_TEXTURE_2D, target.texture);
+    drawToTarget(scratch);
+
+    // Vertical pass back again
+    glUniform2f(Shaders::blurShader.texelStepUniformLoc, 0.f, 1.f / target.height);
+    glBindTexture(GL_TEXTURE_2D, scratch.texture);
+    drawToTarget(target);
+}
+
+void BloomEffect::collectGpuTime()
+{
+    if (frameIndex < numTimerQueries)
+    {
+        // No query has been issued in this slot yet
+        return;
+    }
+
+    // This query was issued a few frames ago, so it is usually ready by now
+    GLuint query = timerQueries[frameIndex % numTimerQueries];
+    GLint available = 0;
+    glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available)
+    {
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNs);
+        gpuTimeTotalMs += elapsedNs / 1'000'000.0;
+        ++numGpuTimeSamples;
+    }
+
+    if (frameIndex % framesPerReport == 0 && numGpuTimeSamples > 0)
+    {
+        lastGpuTimeMs = gpuTimeTotalMs / numGpuTimeSamples;
+        std::cout << "Bloom GPU time: " << lastGpuTimeMs << " ms (budget " << gpuBudgetMs << " ms)";
+        if (lastGpuTimeMs > gpuBudgetMs)
+        {
+            std::cout << " - over budget!";
+        }
+        std::cout << "\n";
+
+        gpuTimeTotalMs = 0.0;
+        numGpuTimeSamples = 0;
+    }
+}
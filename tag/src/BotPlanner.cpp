@@ -0,0 +1,206 @@
+#include "BotPlanner.h"
+
+#include <algorithm>  // clamp, max
+#include <cmath>
+#include <mutex>
+
+#include "ThreadPool.h"
+#include "World.h"
+
+static constexpr Direction allDirections[BotPlanner::numDirections] = {
+    Direction::NONE, Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT
+};
+
+BotPlanner::BotPlanner(ThreadPool& threadPool)
+    : threadPool(threadPool)
+{
+}
+
+void BotPlanner::setWorld(const World* newWorld)
+{
+    world = newWorld;
+}
+
+Direction BotPlanner::chooseDirection(const SimState& state, int playerIndex, Clock::duration budget)
+{
+    const Clock::time_point deadline = Clock::now() + budget;
+    const uint32_t baseSeed = nextSeed;
+    nextSeed += threadPool.getNumThreads();
+
+    ActionStats stats;
+    std::mutex statsMutex;
+
+    // Every rollout is judged by the same rules, so pick them once
+    const auto rolloutFunction = state.getGameMode() == GameMode::Inverted
+            ? &BotPlanner::rollout<GameModes::Inverted>
+            : &BotPlanner::rollout<GameModes::Classic>;
+
+    // One task per thread; each keeps going until the deadline
+    threadPool.parallelFor(threadPool.getNumThreads(), [&](int taskIndex) {
+        ActionStats localStats;
+
+        // Stagger the starting action so that short budgets still cover every action
+        int action = taskIndex % numDirections;
+        uint32_t seed = (baseSeed + taskIndex) << 16;
+
+        while (Clock::now() < deadline)
+        {
+            localStats.totalScore[action] +=
+                    (this->*rolloutFunction)(state, playerIndex, allDirections[action], ++seed);
+            ++localStats.numSamples[action];
+            action = (action + 1) % numDirections;
+        }
+
+        std::lock_guard<std::mutex> lock(statsMutex);
+        for (int i = 0; i < numDirections; ++i)
+        {
+            stats.totalScore[i] += localStats.totalScore[i];
+            stats.numSamples[i] += localStats.numSamples[i];
+        }
+    });
+
+    for (int samples : stats.numSamples)
+    {
+        numRollouts += samples;
+    }
+
+    // Pick the action with the best average score
+    Direction bestDir = state.getPlayer(playerIndex).dir;
+    double bestScore = -INFINITY;
+    for (int i = 0; i < numDirections; ++i)
+    {
+        if (stats.numSamples[i] == 0)
+        {
+            // Not enough time to consider every option
+            return state.getPlayer(playerIndex).dir;
+        }
+
+        double score = stats.totalScore[i] / stats.numSamples[i];
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestDir = allDirections[i];
+        }
+    }
+
+    return bestDir;
+}
+
+template <typename Mode>
+float BotPlanner::rollout(SimState state, int playerIndex, Direction firstDir, uint32_t seed) const
+{
+    state.setSeed(seed);
+
+    for (int frame = 0; frame < rolloutLength && !state.isFinished(); ++frame)
+    {
+        for (int i = 0; i < state.getNumPlayers(); ++i)
+        {
+            if (i == playerIndex && frame < commitLength)
+            {
+                state.setDir(i, firstDir);
+            }
+            else
+            {
+                state.setDir(i, rolloutPolicy(state, i));
+            }
+        }
+
+        state.tick();
+    }
+
+    return evaluate<Mode>(state, playerIndex);
+}
+
+Direction BotPlanner::rolloutPolicy(SimState& state, int playerIndex) const
+{
+    // Mostly keep going in the same direction, to avoid jittering
+    uint32_t roll = state.random(100);
+    const SimState::SimPlayer& player = state.getPlayer(playerIndex);
+    if (roll < 70)
+    {
+        return player.dir;
+    }
+    if (roll < 80)
+    {
+        return allDirections[state.random(numDirections)];
+    }
+
+    int tagged = state.getTaggedPlayer();
+    if (tagged == SimState::noPlayer)
+    {
+        return allDirections[state.random(numDirections)];
+    }
+
+    glm::vec2 diff;
+    if (tagged == playerIndex)
+    {
+        // Chase the nearest player
+        int nearest = SimState::noPlayer;
+        float nearestDistSq = INFINITY;
+        for (int i = 0; i < state.getNumPlayers(); ++i)
+        {
+            if (i == playerIndex)
+            {
+                continue;
+            }
+            glm::vec2 toOther = state.getPlayer(i).pos - player.pos;
+            float distSq = toOther.x * toOther.x + toOther.y * toOther.y;
+            if (distSq < nearestDistSq)
+            {
+                nearest = i;
+                nearestDistSq = distSq;
+                diff = toOther;
+            }
+        }
+
+        if (world)
+        {
+            Direction dir = world->getFlowField(nearest).getDirectionTowards(player.pos);
+            if (dir != Direction::NONE)
+            {
+                return dir;
+            }
+        }
+    }
+    else
+    {
+        // Run away from the tagged player
+        if (world)
+        {
+            return world->getFlowField(tagged).getDirectionAway(player.pos);
+        }
+        diff = player.pos - state.getPlayer(tagged).pos;
+    }
+
+    // Move along the dominant axis
+    if (std::abs(diff.x) > std::abs(diff.y))
+    {
+        return diff.x < 0.f ? Direction::LEFT : Direction::RIGHT;
+    }
+    return diff.y < 0.f ? Direction::UP : Direction::DOWN;
+}
+
+template <typename Mode>
+float BotPlanner::evaluate(const SimState& state, int playerIndex)
+{
+    if (state.isFinished())
+    {
+        return state.getWinner() == playerIndex ? 1.f : -1.f;
+    }
+
+    // Compare our score to the best of our opponents
+    float bestOtherScore = -INFINITY;
+    for (int i = 0; i < state.getNumPlayers(); ++i)
+    {
+        if (i != playerIndex)
+        {
+            bestOtherScore = std::max(bestOtherScore, Mode::score(state.getPlayer(i).timeRemaining));
+        }
+    }
+    float lead = (Mode::score(state.getPlayer(playerIndex).timeRemaining) - bestOtherScore) / SimState::getMaxTime();
+
+    // Being tagged at the end of the rollout means we are about to fall behind, in either mode
+    float taggedPenalty = state.getTaggedPlayer() == playerIndex ? 0.25f : 0.f;
+
+    return std::clamp(lead - taggedPenalty, -1.f, 1.f);
+}
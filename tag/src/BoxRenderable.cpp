@@ -1,5 +1,7 @@
 #include "BoxRenderable.h"
 
+#include <glm/vec2.hpp>
+
 #include <iostream>  // tmp
 #include <stdexcept>
 
@@ -17,6 +19,8 @@ BoxRenderable::BoxRenderable(int maxBoxes)
     // Generate VBOs
     glGenBuffers(1, &positionVbo);
     glGenBuffers(1, &colorVbo);
+    glGenBuffers(1, &shapeVbo);
+    glGenBuffers(1, &styleVbo);
     glGenBuffers(1, &ibo);
 
     // Determine the primitive that should be drawn
@@ -55,6 +59,36 @@ BoxRenderable::BoxRenderable(int maxBoxes)
             nullptr);
     glBufferData(GL_ARRAY_BUFFER, colorBufferSize, NULL, GL_DYNAMIC_DRAW);
 
+    // Allocate space to hold each vertex's position within its box, and the box's size
+    size_t shapeBufferSize = maxBoxes * numShapeDimensions * indicesPerBox * sizeof(GLfloat);
+    shapeData.reserve(maxBoxes * numShapeDimensions * numVerticesPerBox);
+
+    // Initialize shape buffer with empty data
+    glBindBuffer(GL_ARRAY_BUFFER, shapeVbo);
+    glVertexAttribPointer(
+            Shaders::boxShapeAttribIndex,
+            numShapeDimensions,
+            GL_FLOAT,
+            GL_FALSE,
+            numShapeDimensions * sizeof(GLfloat),
+            nullptr);
+    glBufferData(GL_ARRAY_BUFFER, shapeBufferSize, NULL, GL_DYNAMIC_DRAW);
+
+    // Allocate space to hold box styles
+    size_t styleBufferSize = maxBoxes * numStyleDimensions * indicesPerBox * sizeof(GLfloat);
+    styleData.reserve(maxBoxes * numStyleDimensions * numVerticesPerBox);
+
+    // Initialize style buffer with empty data
+    glBindBuffer(GL_ARRAY_BUFFER, styleVbo);
+    glVertexAttribPointer(
+            Shaders::boxStyleAttribIndex,
+            numStyleDimensions,
+            GL_FLOAT,
+            GL_FALSE,
+            numStyleDimensions * sizeof(GLfloat),
+            nullptr);
+    glBufferData(GL_ARRAY_BUFFER, styleBufferSize, NULL, GL_DYNAMIC_DRAW);
+
     // Initialize index buffer - this should never need to change
     std::vector<GLuint> indexData;
     indexData.reserve(maxBoxes * indicesPerBox);
@@ -85,12 +119,16 @@ BoxRenderable::BoxRenderable(int maxBoxes)
     // Enable vertex attributes
     glEnableVertexAttribArray(Shaders::vertexAttribIndex);
     glEnableVertexAttribArray(Shaders::colorAttribIndex);
+    glEnableVertexAttribArray(Shaders::boxShapeAttribIndex);
+    glEnableVertexAttribArray(Shaders::boxStyleAttribIndex);
 }
 
 BoxRenderable::~BoxRenderable()
 {
     glDeleteBuffers(1, &positionVbo);
     glDeleteBuffers(1, &colorVbo);
+    glDeleteBuffers(1, &shapeVbo);
+    glDeleteBuffers(1, &styleVbo);
     glDeleteVertexArrays(1, &vao);
 }
 
@@ -103,10 +141,12 @@ void BoxRenderable::reset()
 {
     vertexData.clear();
     colorData.clear();
+    shapeData.clear();
+    styleData.clear();
     numBoxes = 0;
 }
 
-void BoxRenderable::addBox(const Rect& rect, const Color& color)
+void BoxRenderable::addBox(const Rect& rect, const Color& color, const BoxStyle& style)
 {
     if (numBoxes == maxBoxes)
     {
@@ -114,31 +154,29 @@ void BoxRenderable::addBox(const Rect& rect, const Color& color)
         return;
     }
 
-    // Define vertex positions
-    float x1 = rect.pos.x - rect.extents.x;
-    float y1 = rect.pos.y - rect.extents.y;
-    float x2 = rect.pos.x + rect.extents.x;
-    float y2 = rect.pos.y + rect.extents.y;
-    std::vector<GLfloat> newVertexData = {
-        x1, y1,  //
-        x2, y1,  //
-        x2, y2,  //
-        x1, y2   //
+    // Grow the quad to make room for the glow; the shader works out what is inside the box
+    glm::vec2 quadExtents = rect.extents + glm::vec2(style.glowRadius, style.glowRadius);
+
+    // Define vertex positions, relative to the box centre
+    static constexpr glm::vec2 corners[numVerticesPerBox] = {
+        { -1.f, -1.f },  //
+        { 1.f, -1.f },   //
+        { 1.f, 1.f },    //
+        { -1.f, 1.f }    //
     };
 
-    // Determine vertex colors
-    float r = static_cast<float>(color.r);
-    float g = static_cast<float>(color.g);
-    float b = static_cast<float>(color.b);
-    float a = static_cast<float>(color.a);
-    std::vector<GLfloat> newColorData = { r, g, b, a,  //
-                                          r, g, b, a,  //
-                                          r, g, b, a,  //
-                                          r, g, b, a };
-
-    // Add the box to our buffers
-    vertexData.insert(vertexData.cend(), newVertexData.cbegin(), newVertexData.cend());
-    colorData.insert(colorData.cend(), newColorData.cbegin(), newColorData.cend());
+    for (const glm::vec2& corner : corners)
+    {
+        glm::vec2 localPos = corner * quadExtents;
+        glm::vec2 pos = rect.pos + localPos;
+
+        vertexData.insert(vertexData.cend(), { pos.x, pos.y });
+        colorData.insert(colorData.cend(), { color.r, color.g, color.b, color.a });
+        shapeData.insert(shapeData.cend(), { localPos.x, localPos.y, rect.extents.x, rect.extents.y });
+        styleData.insert(
+                styleData.cend(), { style.cornerRadius, style.outlineWidth, style.glowRadius, style.pulse });
+    }
+
     ++numBoxes;
 }
 
@@ -169,6 +207,16 @@ void BoxRenderScope::update() const
     glBindBuffer(GL_ARRAY_BUFFER, boxRenderable->colorVbo);
     size_t colorBufferSize = boxRenderable->colorData.size() * sizeof(GLfloat);
     glBufferSubData(GL_ARRAY_BUFFER, 0, colorBufferSize, boxRenderable->colorData.data());
+
+    // Upload shape data to GPU
+    glBindBuffer(GL_ARRAY_BUFFER, boxRenderable->shapeVbo);
+    size_t shapeBufferSize = boxRenderable->shapeData.size() * sizeof(GLfloat);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, shapeBufferSize, boxRenderable->shapeData.data());
+
+    // Upload style data to GPU
+    glBindBuffer(GL_ARRAY_BUFFER, boxRenderable->styleVbo);
+    size_t styleBufferSize = boxRenderable->styleData.size() * sizeof(GLfloat);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, styleBufferSize, boxRenderable->styleData.data());
 }
 
 void BoxRenderScope::render() const
@@ -176,3 +224,40 @@ void BoxRenderScope::render() const
     int numVerts = boxRenderable->numBoxes * boxRenderable->indicesPerBox;
     glDrawElements(boxRenderable->drawMode, numVerts, GL_UNSIGNED_INT, nullptr);
 }
+
+void BoxRenderScope::render(const BoxRange& range) const
+{
+    if (range.numBoxes == 0)
+    {
+        return;
+    }
+
+    int numVerts = range.numBoxes * boxRenderable->indicesPerBox;
+    size_t offset = range.firstBox * boxRenderable->indicesPerBox * sizeof(GLuint);
+    glDrawElements(boxRenderable->drawMode, numVerts, GL_UNSIGNED_INT, reinterpret_cast<const void*>(offset));
+}
+
+void BoxRenderScope::render(const std::vector<BoxRange>& ranges) const
+{
+    std::vector<GLsizei>& counts = boxRenderable->multiDrawCounts;
+    std::vector<const void*>& offsets = boxRenderable->multiDrawOffsets;
+    counts.clear();
+    offsets.clear();
+
+    for (const BoxRange& range : ranges)
+    {
+        size_t offset = range.firstBox * boxRenderable->indicesPerBox * sizeof(GLuint);
+        counts.push_back(range.numBoxes * boxRenderable->indicesPerBox);
+        offsets.push_back(reinterpret_cast<const void*>(offset));
+    }
+
+    if (!counts.empty())
+    {
+        glMultiDrawElements(
+                boxRenderable->drawMode,
+                counts.data(),
+                GL_UNSIGNED_INT,
+                offsets.data(),
+                static_cast<GLsizei>(counts.size()));
+    }
+}
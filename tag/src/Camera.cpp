@@ -0,0 +1,105 @@
+#include "Camera.h"
+
+#include <algorithm>  // max, min
+#include <limits>
+#include <vector>
+
+#include "MathUtils.h"
+#include "Player.h"
+#include "World.h"
+
+Camera::Camera(glm::vec2 worldSize)
+    : worldExtents(worldSize / 2.f)
+    , baseExtents(worldExtents)
+    , frame({ 0.f, 0.f }, worldExtents)
+{
+}
+
+void Camera::setMode(const World& world, CameraMode newMode, int newTargetPlayerId)
+{
+    mode = newMode;
+    targetPlayerId = newTargetPlayerId;
+    updateBaseExtents();
+    snap(world);
+}
+
+void Camera::setAspectRatio(float newAspectRatio)
+{
+    followAspectRatio = newAspectRatio;
+    updateBaseExtents();
+}
+
+void Camera::update(const World& world)
+{
+    if (mode == CameraMode::World)
+    {
+        return;
+    }
+
+    Rect target = findTargetFrame(world);
+    frame.pos += (target.pos - frame.pos) * followRate;
+    frame.extents += (target.extents - frame.extents) * followRate;
+}
+
+void Camera::snap(const World& world)
+{
+    frame = findTargetFrame(world);
+}
+
+void Camera::updateBaseExtents()
+{
+    if (mode == CameraMode::World)
+    {
+        baseExtents = worldExtents;
+    }
+    else
+    {
+        baseExtents = { followExtents.y * followAspectRatio, followExtents.y };
+    }
+}
+
+Rect Camera::findTargetFrame(const World& world) const
+{
+    if (mode == CameraMode::World)
+    {
+        return { { 0.f, 0.f }, worldExtents };
+    }
+
+    // Find the bounds of everyone we are following
+    glm::vec2 targetMin(std::numeric_limits<float>::max());
+    glm::vec2 targetMax(std::numeric_limits<float>::lowest());
+    for (const Player& player : world.getPlayers())
+    {
+        if (mode == CameraMode::Player && player.getPlayerId() != targetPlayerId)
+        {
+            continue;
+        }
+
+        const Rect& rect = player.getRect();
+        targetMin.x = std::min(targetMin.x, rect.pos.x - rect.extents.x);
+        targetMin.y = std::min(targetMin.y, rect.pos.y - rect.extents.y);
+        targetMax.x = std::max(targetMax.x, rect.pos.x + rect.extents.x);
+        targetMax.y = std::max(targetMax.y, rect.pos.y + rect.extents.y);
+    }
+
+    if (targetMin.x > targetMax.x)
+    {
+        // Nobody to follow
+        return frame;
+    }
+
+    // Zoom out just enough to fit everyone, keeping our aspect ratio
+    glm::vec2 targetExtents = (targetMax - targetMin) / 2.f + glm::vec2(targetMargin, targetMargin);
+    float zoom = std::max(targetExtents.x / baseExtents.x, targetExtents.y / baseExtents.y);
+    zoom = MathUtils::clamp(zoom, 1.f, maxZoom);
+    glm::vec2 extents = baseExtents * zoom;
+
+    // Don't show more of the outside of the world than we need to
+    glm::vec2 pos = (targetMin + targetMax) / 2.f;
+    pos.x = extents.x < worldExtents.x ? MathUtils::clamp(pos.x, -worldExtents.x + extents.x, worldExtents.x - extents.x)
+                                       : 0.f;
+    pos.y = extents.y < worldExtents.y ? MathUtils::clamp(pos.y, -worldExtents.y + extents.y, worldExtents.y - extents.y)
+                                       : 0.f;
+
+    return { pos, extents };
+}
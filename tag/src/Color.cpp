@@ -1,5 +1,7 @@
 #include "Color.h"
 
+#include <algorithm>  // clamp
+
 const Color Color::white = { 1.f, 1.f, 1.f, 1.f };
 const Color Color::red = { 1.f, 0.f, 0.f, 1.f };
 const Color Color::green = { 0.f, 1.f, 0.f, 1.f };
@@ -13,3 +15,11 @@ Color::Color(float r, float g, float b, float a)
     , a(a)
 {
 }
+
+uint32_t Color::pack() const
+{
+    auto toByte = [](float value) { return static_cast<uint32_t>(std::clamp(value, 0.f, 1.f) * 255.f + 0.5f); };
+
+    // Byte order matches GL_UNSIGNED_BYTE RGBA on little-endian machines
+    return toByte(r) | (toByte(g) << 8) | (toByte(b) << 16) | (toByte(a) << 24);
+}
@@ -0,0 +1,109 @@
+#include "Effects.h"
+
+#include <glm/geometric.hpp>
+
+#include "TimeUtils.h"
+
+Effects::Effects(ParticleSystem& particles, ScreenShake& screenShake)
+    : particles(particles)
+    , screenShake(screenShake)
+{
+}
+
+void Effects::tick(const World& world)
+{
+    particles.update(TimeUtils::frameTime);
+    ++tickCount;
+
+    if (winnerId != noWinner)
+    {
+        if (tickCount % ticksPerFirework == 0)
+        {
+            emitCelebration(world.getPlayers()[winnerId]);
+        }
+        return;
+    }
+
+    if (const Player* taggedPlayer = world.getTaggedPlayer())
+    {
+        if (tickCount % ticksPerPulse == 0)
+        {
+            emitTagPulse(*taggedPlayer);
+        }
+    }
+}
+
+void Effects::reset()
+{
+    particles.clear();
+    winnerId = noWinner;
+}
+
+void Effects::onTag(const Player& tagger, const Player& taggedPlayer)
+{
+    ParticleBurst burst;
+    burst.pos = (tagger.getRect().pos + taggedPlayer.getRect().pos) / 2.f;
+    burst.color = taggedPlayer.getColor();
+    burst.count = 300;
+    burst.minSpeed = 2.f;
+    burst.maxSpeed = 9.f;
+    burst.minLifetime = 0.3f;
+    burst.maxLifetime = 0.8f;
+    burst.size = 0.12f;
+    particles.emit(burst);
+
+    // Restart the pulse so it lines up with the tag
+    tickCount = 0;
+
+    // Knock the screen the way the tagged player was hit
+    glm::vec2 direction = taggedPlayer.getRect().pos - tagger.getRect().pos;
+    float distance = glm::length(direction);
+    direction = distance > 0.f ? direction / distance : glm::vec2(0.f, -1.f);
+
+    screenShake.kick(direction * tagShakeImpulse);
+    screenShake.flash(tagFlashIntensity);
+}
+
+void Effects::onWin(const Player& winner)
+{
+    winnerId = winner.getPlayerId();
+    tickCount = 0;
+    emitCelebration(winner);
+
+    screenShake.kick({ 0.f, -winShakeImpulse });
+    screenShake.flash(1.f);
+}
+
+void Effects::emitTagPulse(const Player& taggedPlayer)
+{
+    // Ring of particles leaving the edge of the player
+    ParticleBurst burst;
+    burst.pos = taggedPlayer.getRect().pos;
+    burst.color = taggedPlayer.getColor();
+    burst.count = 60;
+    burst.spawnRadius = 0.2f;
+    burst.minSpeed = 3.5f;
+    burst.maxSpeed = 4.f;
+    burst.minLifetime = 0.3f;
+    burst.maxLifetime = 0.45f;
+    burst.size = 0.1f;
+    particles.emit(burst);
+}
+
+void Effects::emitCelebration(const Player& winner)
+{
+    std::uniform_real_distribution<float> offsetDist(-fireworkRange, fireworkRange);
+    std::uniform_real_distribution<float> chanceDist(0.f, 1.f);
+
+    // Fireworks mostly in the winner's colour, with the occasional white one
+    ParticleBurst burst;
+    burst.pos = winner.getRect().pos + glm::vec2(offsetDist(rng), offsetDist(rng));
+    burst.color = chanceDist(rng) < 0.25f ? Color::white : winner.getColor();
+    burst.count = 500;
+    burst.minSpeed = 1.f;
+    burst.maxSpeed = 7.f;
+    burst.minLifetime = 0.8f;
+    burst.maxLifetime = 1.6f;
+    burst.size = 0.15f;
+    particles.emit(burst);
+}
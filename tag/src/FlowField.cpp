@@ -0,0 +1,326 @@
+#include "FlowField.h"
+
+#include <algorithm>  // clamp, max, min
+#include <cmath>
+#include <cstdlib>  // abs
+
+///////////////////////////////////////////////////////////////////////////////
+// NavGrid
+///////////////////////////////////////////////////////////////////////////////
+
+NavGrid::NavGrid(glm::vec2 worldSize, float cellSize)
+    : worldExtents(worldSize / 2.f)
+    , cellSize(cellSize)
+    , width(static_cast<int>(std::ceil(worldSize.x / cellSize)))
+    , height(static_cast<int>(std::ceil(worldSize.y / cellSize)))
+    , blocked(getNumCells(), 1)
+{
+    // Clear everything except the border
+    for (int y = 0; y < height; ++y)
+    {
+        std::fill_n(blocked.begin() + (y + 1) * getStride() + 1, width, uint8_t(0));
+    }
+}
+
+void NavGrid::setBlocked(int cellX, int cellY, bool newBlocked)
+{
+    uint8_t& cell = blocked[(cellY + 1) * getStride() + (cellX + 1)];
+    uint8_t newValue = newBlocked ? 1 : 0;
+    if (cell != newValue)
+    {
+        cell = newValue;
+        ++version;
+    }
+}
+
+void NavGrid::blockArea(const Rect& area)
+{
+    // Find the range of cells whose centres might be inside the area
+    glm::vec2 areaMin = area.pos - area.extents + worldExtents;
+    glm::vec2 areaMax = area.pos + area.extents + worldExtents;
+    int minX = std::max(static_cast<int>(std::floor(areaMin.x / cellSize - 0.5f)), 0);
+    int minY = std::max(static_cast<int>(std::floor(areaMin.y / cellSize - 0.5f)), 0);
+    int maxX = std::min(static_cast<int>(std::ceil(areaMax.x / cellSize - 0.5f)), width - 1);
+    int maxY = std::min(static_cast<int>(std::ceil(areaMax.y / cellSize - 0.5f)), height - 1);
+
+    for (int y = minY; y <= maxY; ++y)
+    {
+        for (int x = minX; x <= maxX; ++x)
+        {
+            glm::vec2 cellCentre((x + 0.5f) * cellSize, (y + 0.5f) * cellSize);
+            if (cellCentre.x > areaMin.x && cellCentre.x < areaMax.x && cellCentre.y > areaMin.y
+                    && cellCentre.y < areaMax.y)
+            {
+                setBlocked(x, y, true);
+            }
+        }
+    }
+}
+
+void NavGrid::clear()
+{
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            setBlocked(x, y, false);
+        }
+    }
+}
+
+int NavGrid::getCellIndex(glm::vec2 pos) const
+{
+    int cellX = static_cast<int>((pos.x + worldExtents.x) / cellSize);
+    int cellY = static_cast<int>((pos.y + worldExtents.y) / cellSize);
+    cellX = std::clamp(cellX, 0, width - 1);
+    cellY = std::clamp(cellY, 0, height - 1);
+    return (cellY + 1) * getStride() + (cellX + 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// FlowField
+///////////////////////////////////////////////////////////////////////////////
+
+FlowField::FlowField(const NavGrid& grid)
+    : grid(&grid)
+    , distances(grid.getNumCells(), unreachable)
+    , directions(grid.getNumCells(), Direction::NONE)
+    , repairedDistances(grid.getNumCells(), unreachable)
+    , repairedDirections(grid.getNumCells(), Direction::NONE)
+    , queue(grid.getNumCells())
+{
+}
+
+bool FlowField::update(glm::vec2 targetPos)
+{
+    int newTargetCell = grid->getCellIndex(targetPos);
+    if (newTargetCell == targetCell && grid->getVersion() == gridVersion)
+    {
+        // Nothing has changed, so the previous field is still valid
+        return false;
+    }
+
+    const bool hasField = targetCell != noCell && grid->getVersion() == gridVersion;
+    targetCell = newTargetCell;
+    gridVersion = grid->getVersion();
+    findSeeds();
+
+    // A target that has only drifted a little from the anchor can be reached by repairing the area around it,
+    // as long as the grid has not changed underneath the existing field, and the anchor itself was open
+    bool canRepair = hasField && distances[anchorCell] == 0 && !seeds.empty();
+    for (int seed : seeds)
+    {
+        canRepair = canRepair && distances[seed] <= maxDrift;
+    }
+
+    if (canRepair)
+    {
+        repair();
+    }
+    else
+    {
+        rebuild();
+    }
+    return true;
+}
+
+void FlowField::invalidate()
+{
+    targetCell = noCell;
+}
+
+Direction FlowField::getDirectionTowards(glm::vec2 pos) const
+{
+    const int cell = grid->getCellIndex(pos);
+    return repairedDistances[cell] != unreachable ? repairedDirections[cell] : directions[cell];
+}
+
+Direction FlowField::getDirectionAway(glm::vec2 pos) const
+{
+    const int stride = grid->getStride();
+    const int cell = grid->getCellIndex(pos);
+
+    Direction bestDir = Direction::NONE;
+    uint32_t bestDistance = getCellDistance(cell);
+
+    auto consider = [&](int neighbour, Direction dir) {
+        uint32_t distance = getCellDistance(neighbour);
+        if (distance != unreachable && (bestDistance == unreachable || distance > bestDistance))
+        {
+            bestDistance = distance;
+            bestDir = dir;
+        }
+    };
+
+    // No need for bounds checks, since the border is never reachable
+    consider(cell - stride, Direction::UP);
+    consider(cell + stride, Direction::DOWN);
+    consider(cell - 1, Direction::LEFT);
+    consider(cell + 1, Direction::RIGHT);
+
+    return bestDir;
+}
+
+uint32_t FlowField::getDistance(glm::vec2 pos) const
+{
+    return getCellDistance(grid->getCellIndex(pos));
+}
+
+uint32_t FlowField::getCellDistance(int cell) const
+{
+    if (repairedDistances[cell] != unreachable)
+    {
+        return repairedDistances[cell];
+    }
+    return distances[cell] == unreachable ? unreachable : distances[cell] + anchorOffset;
+}
+
+void FlowField::rebuild()
+{
+    clearRepair();
+    anchorCell = targetCell;
+    anchorOffset = 0;
+
+    std::fill(distances.begin(), distances.end(), unreachable);
+    std::fill(directions.begin(), directions.end(), Direction::NONE);
+
+    // Breadth-first search outwards from the target (or the open cells nearest to it).
+    // When a cell is discovered, the Direction towards the target is back towards the cell it was discovered from.
+    // The grid's border is always blocked, so neighbours never need to be bounds-checked.
+    const int stride = grid->getStride();
+    int queueStart = 0;
+    int queueEnd = queueSeeds(distances, directions);
+
+    while (queueStart < queueEnd)
+    {
+        const int cell = queue[queueStart++];
+        const uint32_t nextDistance = distances[cell] + 1;
+
+        auto visit = [&](int neighbour, Direction dirToCell) {
+            if (distances[neighbour] == unreachable && !grid->isBlocked(neighbour))
+            {
+                distances[neighbour] = nextDistance;
+                directions[neighbour] = dirToCell;
+                queue[queueEnd++] = neighbour;
+            }
+        };
+
+        visit(cell - stride, Direction::DOWN);
+        visit(cell + stride, Direction::UP);
+        visit(cell - 1, Direction::RIGHT);
+        visit(cell + 1, Direction::LEFT);
+    }
+}
+
+void FlowField::repair()
+{
+    clearRepair();
+
+    // Breadth-first search outwards from the target, as in rebuild, but confined to the cells near the anchor.
+    // Every such cell can reach the anchor without leaving the area, and the target is at most maxDrift steps from
+    // the anchor, so the whole area (including the anchor) is always reached. Cells outside the area keep leading
+    // towards the anchor, and so into the area, with their distances offset by the anchor's distance to the target.
+    const int stride = grid->getStride();
+    int queueStart = 0;
+    int queueEnd = queueSeeds(repairedDistances, repairedDirections);
+
+    while (queueStart < queueEnd)
+    {
+        const int cell = queue[queueStart++];
+        const uint32_t nextDistance = repairedDistances[cell] + 1;
+
+        auto visit = [&](int neighbour, Direction dirToCell) {
+            // Blocked cells are never within reach of the anchor, so need no separate check
+            if (repairedDistances[neighbour] == unreachable && distances[neighbour] <= repairRadius)
+            {
+                repairedDistances[neighbour] = nextDistance;
+                repairedDirections[neighbour] = dirToCell;
+                queue[queueEnd++] = neighbour;
+            }
+        };
+
+        visit(cell - stride, Direction::DOWN);
+        visit(cell + stride, Direction::UP);
+        visit(cell - 1, Direction::RIGHT);
+        visit(cell + 1, Direction::LEFT);
+    }
+
+    repairedCells.assign(queue.begin(), queue.begin() + queueEnd);
+    anchorOffset = repairedDistances[anchorCell];
+}
+
+void FlowField::clearRepair()
+{
+    for (int cell : repairedCells)
+    {
+        repairedDistances[cell] = unreachable;
+        repairedDirections[cell] = Direction::NONE;
+    }
+    repairedCells.clear();
+}
+
+void FlowField::findSeeds()
+{
+    seeds.clear();
+    seedDistance = 0;
+    if (!grid->isBlocked(targetCell))
+    {
+        seeds.push_back(targetCell);
+        return;
+    }
+
+    // Nav cells are coarse, so a player touching an obstacle can be in a blocked cell.
+    // Rather than leaving the whole field unreachable, start from every open cell at the smallest distance.
+    const int stride = grid->getStride();
+    const int numRows = grid->getNumCells() / stride;
+    const int targetX = targetCell % stride;
+    const int targetY = targetCell / stride;
+
+    auto addSeed = [&](int x, int y) {
+        if (x >= 0 && x < stride && y >= 0 && y < numRows && !grid->isBlocked(y * stride + x))
+        {
+            seeds.push_back(y * stride + x);
+        }
+    };
+
+    // Walk outwards one diamond-shaped ring at a time, since distances are measured in axis-aligned steps
+    for (int distance = 1; distance <= maxSeedDistance && seeds.empty(); ++distance)
+    {
+        for (int dy = -distance; dy <= distance; ++dy)
+        {
+            const int dx = distance - std::abs(dy);
+            addSeed(targetX - dx, targetY + dy);
+            if (dx != 0)
+            {
+                addSeed(targetX + dx, targetY + dy);
+            }
+        }
+        seedDistance = static_cast<uint32_t>(distance);
+    }
+}
+
+int FlowField::queueSeeds(std::vector<uint32_t>& seedDistances, std::vector<Direction>& seedDirections)
+{
+    const int stride = grid->getStride();
+    const int targetX = targetCell % stride;
+    const int targetY = targetCell / stride;
+
+    int queueEnd = 0;
+    for (int seed : seeds)
+    {
+        // Seeds right beside a blocked target point straight at it; any further out, the way may be blocked
+        const int dx = targetX - seed % stride;
+        const int dy = targetY - seed / stride;
+        Direction dir = Direction::NONE;
+        if (seedDistance == 1)
+        {
+            dir = dx != 0 ? (dx > 0 ? Direction::RIGHT : Direction::LEFT)
+                          : (dy > 0 ? Direction::DOWN : Direction::UP);
+        }
+
+        seedDistances[seed] = seedDistance;
+        seedDirections[seed] = dir;
+        queue[queueEnd++] = seed;
+    }
+    return queueEnd;
+}
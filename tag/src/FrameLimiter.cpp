@@ -0,0 +1,89 @@
+#include "FrameLimiter.h"
+
+#include <algorithm>  // max
+#include <iostream>
+
+FrameLimiter::FrameLimiter(int maxFramesInFlight)
+    : maxFramesInFlight(maxFramesInFlight)
+    , frameStartTime(Clock::now())
+{
+}
+
+FrameLimiter::~FrameLimiter()
+{
+    for (const Frame& frame : framesInFlight)
+    {
+        glDeleteSync(frame.fence);
+    }
+}
+
+void FrameLimiter::beginFrame()
+{
+    // Retire any frames that have already finished, without waiting
+    while (!framesInFlight.empty())
+    {
+        GLenum result = glClientWaitSync(framesInFlight.front().fence, 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+        {
+            break;
+        }
+        retireOldestFrame(Clock::now());
+    }
+
+    // Wait for the GPU to catch up, if we are too far ahead
+    Clock::time_point waitStartTime = Clock::now();
+    while (static_cast<int>(framesInFlight.size()) >= maxFramesInFlight)
+    {
+        constexpr GLuint64 waitTimeout = 100'000'000;  // 100ms
+        GLenum result = glClientWaitSync(framesInFlight.front().fence, GL_SYNC_FLUSH_COMMANDS_BIT, waitTimeout);
+        while (result == GL_TIMEOUT_EXPIRED)
+        {
+            result = glClientWaitSync(framesInFlight.front().fence, 0, waitTimeout);
+        }
+
+        // If waiting failed there is nothing more we can do, so carry on rather than hang
+        retireOldestFrame(Clock::now());
+    }
+
+    frameStartTime = Clock::now();
+    totalWaitMs += std::chrono::duration<double, std::milli>(frameStartTime - waitStartTime).count();
+}
+
+void FrameLimiter::endFrame()
+{
+    framesInFlight.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), frameStartTime });
+
+    ++frameIndex;
+    if (frameIndex % framesPerReport == 0)
+    {
+        report();
+    }
+}
+
+void FrameLimiter::retireOldestFrame(Clock::time_point now)
+{
+    const Frame& frame = framesInFlight.front();
+
+    double latencyMs = std::chrono::duration<double, std::milli>(now - frame.startTime).count();
+    totalLatencyMs += latencyMs;
+    maxLatencyMs = std::max(maxLatencyMs, latencyMs);
+    ++numLatencySamples;
+
+    glDeleteSync(frame.fence);
+    framesInFlight.pop_front();
+}
+
+void FrameLimiter::report()
+{
+    if (numLatencySamples > 0)
+    {
+        std::cout << "Frame latency (max " << maxFramesInFlight << " in flight): avg "
+                  << totalLatencyMs / numLatencySamples << " ms, max " << maxLatencyMs << " ms; waited avg "
+                  << totalWaitMs / framesPerReport << " ms per frame\n";
+    }
+
+    numLatencySamples = 0;
+    totalLatencyMs = 0.0;
+    maxLatencyMs = 0.0;
+    totalWaitMs = 0.0;
+}
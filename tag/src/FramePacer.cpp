@@ -0,0 +1,31 @@
+#include "FramePacer.h"
+
+#include <algorithm>  // max
+
+FramePacer::FramePacer(double refreshInterval)
+    : refreshInterval(refreshInterval)
+{
+}
+
+double FramePacer::getNextFrameStartTime() const
+{
+    // If the frame could never fit within one refresh, start immediately
+    double leadTime = workTimeEstimate + safetyMargin;
+    if (leadTime >= refreshInterval)
+    {
+        return lastVsyncTime;
+    }
+
+    return lastVsyncTime + refreshInterval - leadTime;
+}
+
+void FramePacer::frameSubmitted(double workTime)
+{
+    workTimeEstimate = std::max(workTime, workTimeEstimate + (workTime - workTimeEstimate) * workTimeDecay);
+}
+
+void FramePacer::frameSwapped(double swapTime)
+{
+    // Swaps complete shortly after the vsync, so any error here makes us start slightly late; the margin covers it
+    lastVsyncTime = swapTime;
+}
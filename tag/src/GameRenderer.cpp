@@ -2,133 +2,617 @@
 
 #include <GL/glew.h>
 #include <GL/gl.h>
-#include <GLFW/glfw3.h>
+#include <glm/common.hpp>
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_transform.hpp>
 
+#include <algorithm>  // max, min, sort
+#include <cmath>
+
 #include "Color.h"
 #include "Player.h"
 #include "Shaders.h"
 
-GameRenderer::GameRenderer(GLFWwindow* window, World* world)
+GameRenderer::GameRenderer(
+        glm::ivec2 targetSize,
+        World* world,
+        const std::vector<Camera>* cameras,
+        const ParticleSystem* particles,
+        const ScreenShake* screenShake)
     : world(world)
+    , cameras(cameras)
+    , screenShake(screenShake)
+    , particles(particles)
+    , particleRenderable(particles->getCapacity())
 {
-    // Calculate border Rects
-    glm::vec2 worldExtents = world->getExtents();
-    glm::vec2 worldExtentsPlusBorder = worldExtents + glm::vec2(borderThickness, borderThickness);
-    float halfBorderThickness = borderThickness / 2.f;
-    borderTop = { { 0.f, -worldExtents.y - halfBorderThickness }, { worldExtentsPlusBorder.x, halfBorderThickness } };
-    borderLeft = { { -worldExtents.x - halfBorderThickness, 0.f }, { halfBorderThickness, worldExtentsPlusBorder.y } };
-    borderBottom = { { 0.f, worldExtents.y + halfBorderThickness }, { worldExtentsPlusBorder.x, halfBorderThickness } };
-    borderRight = { { worldExtents.x + halfBorderThickness, 0.f }, { halfBorderThickness, worldExtentsPlusBorder.y } };
+    borderRects = makeBorderRects(world->getExtents());
 
-    // Use shader
-    glUseProgram(Shaders::boxShader.programId);
+    if (const TileMap* tileMap = world->getTileMap())
+    {
+        tileRenderable = std::make_unique<BoxRenderable>(tileMap->getMaxResidentRuns());
+    }
 
-    // Set uniform values
-    glm::mat4 viewProjMatrix = makeViewProjectionMatrix(*world);
-    glUniformMatrix4fv(Shaders::boxShader.viewProjMatrixUniformLoc, 1, GL_FALSE, &viewProjMatrix[0][0]);
+    // Per-frame values are shared by all shaders
+    glGenBuffers(1, &frameUniformBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUniformBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Shaders::FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Shaders::frameUniformsBinding, frameUniformBuffer);
 
-    updateViewport(window);
+    // Boxes are antialiased and can glow, so they need blending
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    updateViewport(targetSize);
 }
 
-void GameRenderer::updateViewport(GLFWwindow* window)
+GameRenderer::~GameRenderer()
 {
-    fillWindow(window, world->getAspectRatio());
+    glDeleteBuffers(1, &frameUniformBuffer);
+}
+
+void GameRenderer::updateViewport(glm::ivec2 targetSize)
+{
+    Layout layout = makeLayout(targetSize, *cameras);
+    views.resize(layout.viewports.size());
+    for (size_t i = 0; i < views.size(); ++i)
+    {
+        views[i].viewport = layout.viewports[i];
+    }
+    hudViewport = layout.hudViewport;
+    hudExtents = layout.hudExtents;
+}
+
+float GameRenderer::getSplitScreenAspectRatio(glm::ivec2 targetSize, int numViews)
+{
+    glm::ivec2 layout = getSplitScreenLayout(numViews);
+    float cellWidth = static_cast<float>(targetSize.x / layout.x);
+    float cellHeight = static_cast<float>(std::max(targetSize.y / layout.y, 1));
+    return cellWidth / cellHeight;
+}
+
+GameRenderer::Layout GameRenderer::makeLayout(glm::ivec2 targetSize, const std::vector<Camera>& cameras)
+{
+    int numViews = static_cast<int>(cameras.size());
+    Layout layout;
+    layout.viewports.resize(numViews);
+
+    if (numViews == 1)
+    {
+        // Single view, letterboxed to the camera's aspect ratio
+        const Camera& camera = cameras.front();
+        layout.viewports[0] = fillTarget(targetSize, camera.getAspectRatio());
+        layout.hudViewport = layout.viewports[0];
+        layout.hudExtents = camera.getBaseExtents();
+        return layout;
+    }
+
+    // Split the target into a grid
+    glm::ivec2 grid = getSplitScreenLayout(numViews);
+    GLsizei cellWidth = targetSize.x / grid.x;
+    GLsizei cellHeight = targetSize.y / grid.y;
+
+    for (int i = 0; i < numViews; ++i)
+    {
+        int column = i % grid.x;
+        int row = i / grid.x;
+
+        // OpenGL viewports start from the bottom, but we want the first view at the top
+        Viewport& viewport = layout.viewports[i];
+        viewport.x = column * cellWidth;
+        viewport.y = targetSize.y - (row + 1) * cellHeight;
+        viewport.width = cellWidth;
+        viewport.height = cellHeight;
+    }
+
+    // The HUD spans the whole target
+    layout.hudViewport = { 0, 0, targetSize.x, targetSize.y };
+    float targetAspectRatio = static_cast<float>(targetSize.x) / std::max(targetSize.y, 1);
+    layout.hudExtents = { Camera::followExtents.y * targetAspectRatio, Camera::followExtents.y };
+    return layout;
 }
 
-void GameRenderer::render()
+void GameRenderer::render(double time)
 {
     // Clear screen
     glClear(GL_COLOR_BUFFER_BIT);
 
-    // Prepare to render
-    boxRenderable.reset();
+    updateFrameUniforms(time);
 
-    // - Border
+    // Work out what each camera can see
+    for (size_t i = 0; i < views.size(); ++i)
+    {
+        const Rect& frame = (*cameras)[i].getFrame();
+        views[i].viewProjMatrix = makeViewProjectionMatrix(frame);
+        views[i].visibleRect = makeVisibleRect(frame);
+    }
+
+    // Upload each batch once, with everything that any view needs
+    if (obstaclesDirty || world->getObstacleVersion() != obstacleVersion)
+    {
+        rebuildObstacles();
+        if (BoxRenderScope renderScope = obstacleRenderable->bind())
+        {
+            renderScope.update();
+        }
+    }
+
+    const TileMap* tileMap = world->getTileMap();
+    if (tileMap)
+    {
+        if (tilesDirty || tileMap->getVersion() != tileMapVersion)
+        {
+            rebuildTiles(*tileMap);
+            if (BoxRenderScope renderScope = tileRenderable->bind())
+            {
+                renderScope.update();
+            }
+        }
+    }
+
+    // Find the parts of each batch that each view can see
+    for (View& view : views)
+    {
+        view.obstacleRanges.clear();
+        cullRanges(obstacleCellRanges, view.visibleRect, view.obstacleRanges);
+
+        view.tileRanges.clear();
+        cullRanges(tileChunkRanges, view.visibleRect, view.tileRanges);
+
+        view.pickupRanges.clear();
+        cullRanges(pickupCellRanges, view.visibleRect, view.pickupRanges);
+    }
+
+    if (world->getPickups().getVersion() != pickupsVersion)
+    {
+        rebuildPickups();
+        if (BoxRenderScope renderScope = pickupRenderable.bind())
+        {
+            renderScope.update();
+        }
+    }
+
+    rebuildPlayers();
+    if (BoxRenderScope renderScope = playerRenderable.bind())
+    {
+        renderScope.update();
+    }
+
+    updateTrails();
+    particleRenderable.update(*particles);
+
+    // The border, obstacles and tiles are stored in white, and tinted to match the tagged player when drawn
     const Player* taggedPlayer = world->getTaggedPlayer();
     const Color borderColor = taggedPlayer ? taggedPlayer->getColor() : Color::white;
-    boxRenderable.addBox(borderTop, borderColor);
-    boxRenderable.addBox(borderLeft, borderColor);
-    boxRenderable.addBox(borderBottom, borderColor);
-    boxRenderable.addBox(borderRight, borderColor);
 
-    // - Players & scores
+    // Draw each view from the shared batches
+    for (const View& view : views)
+    {
+        setViewport(view.viewport);
+        glUseProgram(Shaders::boxShader.programId);
+        glUniformMatrix4fv(Shaders::boxShader.viewProjMatrixUniformLoc, 1, GL_FALSE, &view.viewProjMatrix[0][0]);
+        glUniform1f(Shaders::boxShader.shakeWeightUniformLoc, 1.f);
+
+        // - Border & obstacles
+        // These flash when someone is tagged
+        glUniform4f(Shaders::boxShader.tintUniformLoc, borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+        glUniform1f(Shaders::boxShader.flashWeightUniformLoc, 1.f);
+        if (BoxRenderScope renderScope = obstacleRenderable->bind())
+        {
+            renderScope.render(view.obstacleRanges);
+        }
+
+        // - Streamed tiles
+        if (tileMap)
+        {
+            if (BoxRenderScope renderScope = tileRenderable->bind())
+            {
+                renderScope.render(view.tileRanges);
+            }
+        }
+        glUniform4f(Shaders::boxShader.tintUniformLoc, 1.f, 1.f, 1.f, 1.f);
+
+        // - Decorations
+        if (decorationRenderable)
+        {
+            glUniform1f(Shaders::boxShader.flashWeightUniformLoc, 0.f);
+            if (BoxRenderScope renderScope = decorationRenderable->bind())
+            {
+                renderScope.render();
+            }
+        }
+
+        // - Pickups
+        if (!view.pickupRanges.empty())
+        {
+            glUniform1f(Shaders::boxShader.flashWeightUniformLoc, 0.f);
+            if (BoxRenderScope renderScope = pickupRenderable.bind())
+            {
+                renderScope.render(view.pickupRanges);
+            }
+        }
+
+        // - Trails
+        // These are drawn beneath the players, and fade out along their length
+        glUseProgram(Shaders::trailShader.programId);
+        glUniformMatrix4fv(Shaders::trailShader.viewProjMatrixUniformLoc, 1, GL_FALSE, &view.viewProjMatrix[0][0]);
+        glUniform1ui(Shaders::trailShader.currentTickUniformLoc, trailTick);
+        glUniform1f(
+                Shaders::trailShader.fadeTicksUniformLoc, static_cast<float>(trailRenderable.getSegmentsPerTrail()));
+        trailRenderable.render();
+
+        // - Players
+        glUseProgram(Shaders::boxShader.programId);
+        glUniform1f(Shaders::boxShader.flashWeightUniformLoc, 0.f);
+        if (BoxRenderScope renderScope = playerRenderable.bind())
+        {
+            renderScope.render(view.playerRange);
+        }
+
+        // - Particles
+        // These are not culled; the GPU clips them cheaply, and bursts are usually on screen anyway
+        if (particles->getCount() > 0)
+        {
+            glUseProgram(Shaders::particleShader.programId);
+            glUniformMatrix4fv(
+                    Shaders::particleShader.viewProjMatrixUniformLoc, 1, GL_FALSE, &view.viewProjMatrix[0][0]);
+            // Particles are blended additively, so overlapping particles glow
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+            particleRenderable.render();
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        }
+    }
+
+    // - Scores
+    // The HUD is laid out in a fixed frame, so it stays put when the cameras move or the screen shakes
+    setViewport(hudViewport);
+    glUseProgram(Shaders::boxShader.programId);
+    glUniform1f(Shaders::boxShader.shakeWeightUniformLoc, 0.f);
+    glUniform1f(Shaders::boxShader.flashWeightUniformLoc, 0.f);
+    glm::mat4 hudMatrix = makeViewProjectionMatrix({ { 0.f, 0.f }, hudExtents });
+    glUniformMatrix4fv(Shaders::boxShader.viewProjMatrixUniformLoc, 1, GL_FALSE, &hudMatrix[0][0]);
+
+    hudRenderable.reset();
+    int numPlayers = static_cast<int>(world->getPlayers().size());
     for (const Player& player : world->getPlayers())
     {
-        boxRenderable.addBox(player.getRect(), player.getColor());
-        boxRenderable.addBox(makeScoreRect(player), player.getColor());
+        hudRenderable.addBox(makeScoreRect(player, numPlayers, hudExtents), player.getColor(), scoreStyle);
     }
 
-    // Render
-    if (BoxRenderScope renderScope = boxRenderable.bind())
+    if (BoxRenderScope renderScope = hudRenderable.bind())
     {
         renderScope.update();
         renderScope.render();
     }
 }
 
-glm::mat4 GameRenderer::makeViewProjectionMatrix(const World& world)
+void GameRenderer::clearTrails()
+{
+    trailRenderable.clear();
+    trailTick = 0;
+}
+
+void GameRenderer::setDecorations(const std::vector<Rect>& rects, const Color& color)
+{
+    if (rects.empty())
+    {
+        decorationRenderable.reset();
+        return;
+    }
+
+    decorationRenderable = std::make_unique<BoxRenderable>(static_cast<int>(rects.size()));
+    for (const Rect& rect : rects)
+    {
+        decorationRenderable->addBox(rect, color);
+    }
+
+    if (BoxRenderScope renderScope = decorationRenderable->bind())
+    {
+        renderScope.update();
+    }
+}
+
+glm::mat4 GameRenderer::makeViewProjectionMatrix(const Rect& frame) const
 {
     // Determine our view matrix.
     // This assumes our vertices are positioned using this co-ordinate system:
     //  - +x points right
     //  - +y points down
     //  - +z points into the screen
+    Rect visibleRect = makeVisibleRect(frame);
+    glm::vec3 cameraLookAt(visibleRect.pos.x, visibleRect.pos.y, 0.f);
+    glm::vec3 cameraPos = cameraLookAt + glm::vec3(0.f, 0.f, -1.f);
     glm::mat4 view = glm::lookAt(cameraPos, cameraLookAt, up);
 
     // Determine our projection matrix
-    glm::vec2 extents = world.getExtents() + borderPadding;
+    glm::vec2 extents = visibleRect.extents;
     glm::mat4 projection = glm::ortho(-extents.x, extents.x, -extents.y, extents.y, nearPlane, farPlane);
 
     // Combine matrices
     return projection * view;
 }
 
-void GameRenderer::fillWindow(GLFWwindow* window, float aspectRatio)
+Rect GameRenderer::makeVisibleRect(const Rect& frame)
+{
+    glm::vec3 cameraOffset = (frame.extents.y * cameraOffsetRatio) * up;
+    glm::vec2 pos = frame.pos + glm::vec2(cameraOffset.x, cameraOffset.y);
+    glm::vec2 extents = frame.extents * (1.f + framePaddingRatio);
+    return { pos, extents };
+}
+
+GameRenderer::Viewport GameRenderer::fillTarget(glm::ivec2 targetSize, float aspectRatio)
 {
-    // Get window size
-    int outX;
-    int outY;
-    glfwGetWindowSize(window, &outX, &outY);
-    glm::vec2 windowSize(outX, outY);
+    glm::vec2 size(static_cast<float>(targetSize.x), static_cast<float>(targetSize.y));
 
     // Fill the available width, and set height accordingly
-    glm::vec2 viewportSize(windowSize.x, windowSize.x / aspectRatio);
+    glm::vec2 viewportSize(size.x, size.x / aspectRatio);
 
     // Scale down if y is too big to fit
-    if (viewportSize.y > windowSize.y)
+    if (viewportSize.y > size.y)
     {
-        viewportSize *= windowSize.y / viewportSize.y;
+        viewportSize *= size.y / viewportSize.y;
     }
 
     // Center vertically
-    glm::vec2 viewportOffset = (windowSize - viewportSize) / 2.f;
+    glm::vec2 viewportOffset = (size - viewportSize) / 2.f;
 
-    glViewport(
-            static_cast<GLint>(viewportOffset.x),
-            static_cast<GLint>(viewportOffset.y),
-            static_cast<GLsizei>(viewportSize.x),
-            static_cast<GLsizei>(viewportSize.y));
+    return { static_cast<GLint>(viewportOffset.x),
+             static_cast<GLint>(viewportOffset.y),
+             static_cast<GLsizei>(viewportSize.x),
+             static_cast<GLsizei>(viewportSize.y) };
 }
 
-Rect GameRenderer::makeScoreRect(const Player& player) const
+glm::ivec2 GameRenderer::getSplitScreenLayout(int numViews)
+{
+    // Side-by-side for 2 views, otherwise a 2x2 grid
+    return { numViews > 1 ? 2 : 1, numViews > 2 ? 2 : 1 };
+}
+
+void GameRenderer::setViewport(const Viewport& viewport)
+{
+    glViewport(viewport.x, viewport.y, viewport.width, viewport.height);
+}
+
+std::array<Rect, GameRenderer::numBoxesForBorder> GameRenderer::makeBorderRects(glm::vec2 worldExtents)
+{
+    glm::vec2 worldExtentsPlusBorder = worldExtents + glm::vec2(borderThickness, borderThickness);
+    float halfBorderThickness = borderThickness / 2.f;
+    return { {
+            // Top
+            { { 0.f, -worldExtents.y - halfBorderThickness }, { worldExtentsPlusBorder.x, halfBorderThickness } },
+            // Left
+            { { -worldExtents.x - halfBorderThickness, 0.f }, { halfBorderThickness, worldExtentsPlusBorder.y } },
+            // Bottom
+            { { 0.f, worldExtents.y + halfBorderThickness }, { worldExtentsPlusBorder.x, halfBorderThickness } },
+            // Right
+            { { worldExtents.x + halfBorderThickness, 0.f }, { halfBorderThickness, worldExtentsPlusBorder.y } },
+    } };
+}
+
+Rect GameRenderer::makeScoreRect(const Player& player, int numPlayers, glm::vec2 hudExtents)
 {
     // Calculate player ratio
     int index = player.getPlayerId();
-    int numPlayers = static_cast<int>(world->getPlayers().size());
     float playerRatio = static_cast<float>(index) / numPlayers;
 
     // Size
-    float widthPerPlayer = (world->getSize().x / numPlayers);
+    glm::vec2 hudSize = hudExtents * 2.f;
+    float widthPerPlayer = (hudSize.x / numPlayers);
     float maxWidth = widthPerPlayer - scorePadding;
     float width = maxWidth * player.getTimeRemainingRatio();
     glm::vec2 extents = { width / 2.f, scoreHeight / 2.f };
 
     // Position
-    float x = -world->getExtents().x + (playerRatio * world->getSize().x) + (widthPerPlayer / 2.f);
-    float y = -world->getExtents().y;
+    float x = -hudExtents.x + (playerRatio * hudSize.x) + (widthPerPlayer / 2.f);
+    float y = -hudExtents.y;
     glm::vec2 pos = glm::vec2(x, y) + scoreOffset;
 
     return { pos, extents };
 }
+
+BoxStyle GameRenderer::makePlayerStyle(const Player& player) const
+{
+    if (player.hasWon())
+    {
+        return winnerStyle;
+    }
+    if (&player == world->getTaggedPlayer())
+    {
+        return taggedPlayerStyle;
+    }
+    return playerStyle;
+}
+
+void GameRenderer::updateFrameUniforms(double time)
+{
+    Shaders::FrameUniforms frameUniforms {};
+    frameUniforms.time = static_cast<GLfloat>(time);
+    frameUniforms.flashIntensity = screenShake->getFlashIntensity();
+    frameUniforms.shakeOffset[0] = screenShake->getOffset().x;
+    frameUniforms.shakeOffset[1] = screenShake->getOffset().y;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUniformBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(frameUniforms), &frameUniforms);
+}
+
+void GameRenderer::rebuildObstacles()
+{
+    if (world->getObstacleVersion() != obstacleVersion || !obstacleRenderable)
+    {
+        // The obstacles have been replaced, so work out the new layout of the batch.
+        // Each side of the border gets its own range, since they span the whole world.
+        obstacleCellRanges.clear();
+        for (int i = 0; i < numBoxesForBorder; ++i)
+        {
+            obstacleCellRanges.emplace_back(borderRects[i], BoxRange { i, 1 });
+        }
+
+        sortedObstacles = world->getObstacles();
+        groupByCell(sortedObstacles, numBoxesForBorder, obstacleCellRanges);
+
+        obstacleRenderable =
+                std::make_unique<BoxRenderable>(numBoxesForBorder + static_cast<int>(sortedObstacles.size()));
+        obstacleVersion = world->getObstacleVersion();
+    }
+
+    obstacleRenderable->reset();
+    for (const Rect& border : borderRects)
+    {
+        obstacleRenderable->addBox(border, Color::white);
+    }
+    for (const Rect& obstacle : sortedObstacles)
+    {
+        obstacleRenderable->addBox(obstacle, Color::white);
+    }
+
+    obstaclesDirty = false;
+}
+
+void GameRenderer::rebuildTiles(const TileMap& tileMap)
+{
+    tileRenderable->reset();
+    tileChunkRanges.clear();
+
+    // Each chunk's runs are kept together, so views can pick out whole chunks
+    tileMap.forEachResidentChunk([&](const Rect& bounds, const std::vector<Rect>& runs) {
+        BoxRange range { tileRenderable->getNumBoxes(), static_cast<int>(runs.size()) };
+        for (const Rect& run : runs)
+        {
+            tileRenderable->addBox(run, Color::white);
+        }
+        tileChunkRanges.emplace_back(bounds, range);
+    });
+
+    tileMapVersion = tileMap.getVersion();
+    tilesDirty = false;
+}
+
+void GameRenderer::groupByCell(std::vector<Rect>& rects, int firstBox, CellRanges& cellRanges)
+{
+    auto getCell = [](const Rect& rect) {
+        return glm::ivec2(
+                static_cast<int>(std::floor(rect.pos.x / cullCellSize)),
+                static_cast<int>(std::floor(rect.pos.y / cullCellSize)));
+    };
+
+    std::sort(rects.begin(), rects.end(), [&](const Rect& a, const Rect& b) {
+        glm::ivec2 cellA = getCell(a);
+        glm::ivec2 cellB = getCell(b);
+        return cellA.y != cellB.y ? cellA.y < cellB.y : cellA.x < cellB.x;
+    });
+
+    // Each run of boxes in the same cell becomes one range, bounded by everything in it
+    size_t start = 0;
+    while (start < rects.size())
+    {
+        const glm::ivec2 cell = getCell(rects[start]);
+        glm::vec2 boundsMin = rects[start].pos - rects[start].extents;
+        glm::vec2 boundsMax = rects[start].pos + rects[start].extents;
+
+        size_t end = start + 1;
+        while (end < rects.size() && getCell(rects[end]) == cell)
+        {
+            boundsMin = glm::min(boundsMin, rects[end].pos - rects[end].extents);
+            boundsMax = glm::max(boundsMax, rects[end].pos + rects[end].extents);
+            ++end;
+        }
+
+        Rect bounds { (boundsMin + boundsMax) / 2.f, (boundsMax - boundsMin) / 2.f };
+        cellRanges.emplace_back(bounds, BoxRange { firstBox + static_cast<int>(start), static_cast<int>(end - start) });
+        start = end;
+    }
+}
+
+void GameRenderer::cullRanges(const CellRanges& cellRanges, const Rect& visibleRect, std::vector<BoxRange>& ranges)
+{
+    for (const auto& [bounds, range] : cellRanges)
+    {
+        if (range.numBoxes == 0 || !bounds.intersects(visibleRect))
+        {
+            continue;
+        }
+
+        // Merge with the previous range if they are adjacent in the batch
+        if (!ranges.empty() && ranges.back().firstBox + ranges.back().numBoxes == range.firstBox)
+        {
+            ranges.back().numBoxes += range.numBoxes;
+        }
+        else
+        {
+            ranges.push_back(range);
+        }
+    }
+}
+
+void GameRenderer::rebuildPickups()
+{
+    const Pickups& pickups = world->getPickups();
+
+    sortedPickups.clear();
+    pickups.forEach([&](const Rect& bounds, PowerUp /*powerUp*/) { sortedPickups.push_back(bounds); });
+
+    pickupCellRanges.clear();
+    groupByCell(sortedPickups, 0, pickupCellRanges);
+
+    pickupRenderable.reset();
+    for (const Rect& bounds : sortedPickups)
+    {
+        pickupRenderable.addBox(bounds, Color::white, pickupStyle);
+    }
+
+    pickupsVersion = pickups.getVersion();
+}
+
+void GameRenderer::rebuildPlayers()
+{
+    playerRenderable.reset();
+
+    for (View& view : views)
+    {
+        view.playerRange.firstBox = playerRenderable.getNumBoxes();
+
+        for (const Player& player : world->getPlayers())
+        {
+            if (player.getRect().intersects(view.visibleRect))
+            {
+                playerRenderable.addBox(player.getRect(), player.getColor(), makePlayerStyle(player));
+            }
+        }
+
+        view.playerRange.numBoxes = playerRenderable.getNumBoxes() - view.playerRange.firstBox;
+    }
+}
+
+void GameRenderer::updateTrails()
+{
+    const std::vector<Player>& players = world->getPlayers();
+    if (players.empty())
+    {
+        return;
+    }
+
+    // Players are all ticked together, so any of them can tell us the current tick
+    const uint32_t currentTick = players.front().getNumTicks();
+
+    // If we have fallen further behind than the length of a trail, the older segments would be overwritten anyway
+    const uint32_t maxNewTicks = static_cast<uint32_t>(trailRenderable.getSegmentsPerTrail());
+    const uint32_t numNewTicks = std::min(currentTick - trailTick, maxNewTicks);
+
+    for (uint32_t tick = currentTick - numNewTicks + 1; tick <= currentTick; ++tick)
+    {
+        int ticksAgo = static_cast<int>(currentTick - tick);
+        for (const Player& player : players)
+        {
+            Color color = player.getColor();
+            color.a = trailAlpha;
+            trailRenderable.addSegment(
+                    player.getPlayerId(),
+                    tick,
+                    player.getTrailPos(ticksAgo + 1),
+                    player.getTrailPos(ticksAgo),
+                    trailHalfWidth,
+                    color);
+        }
+    }
+
+    trailTick = currentTick;
+}
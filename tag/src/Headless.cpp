@@ -0,0 +1,161 @@
+#include "Headless.h"
+
+#include <GL/glew.h>
+#include <glm/vec2.hpp>
+
+#include <algorithm>  // max
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+#include "AsyncReadback.h"
+#include "GameRenderer.h"
+#include "HeadlessContext.h"
+#include "ImageUtils.h"
+#include "OffscreenTarget.h"
+#include "Renderer.h"
+#include "ScriptedMatch.h"
+#include "Shaders.h"
+#include "SoftwareRenderer.h"
+#include "ThreadPool.h"
+#include "TimeUtils.h"
+
+namespace Headless {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Saves and / or checks the final frame, as requested.
+ *
+ * @return Exit code for the application.
+ */
+int checkFinalFrame(const Options& options, const Image& image)
+{
+    if (!options.screenshotFilename.empty())
+    {
+        ImageUtils::writePpm(options.screenshotFilename, image);
+        std::cout << "Saved final frame to " << options.screenshotFilename << "\n";
+    }
+
+    if (options.goldenFilename.empty())
+    {
+        return 0;
+    }
+
+    Image golden = ImageUtils::readPpm(options.goldenFilename);
+    if (golden.width != image.width || golden.height != image.height)
+    {
+        std::cerr << "Golden image is " << golden.width << "x" << golden.height << ", but the final frame is "
+                  << image.width << "x" << image.height << "\n";
+        return 1;
+    }
+
+    ImageUtils::ImageDiff diff = ImageUtils::compare(image, golden, options.tolerance);
+    if (diff.numDifferentPixels > 0)
+    {
+        std::cerr << "Final frame does not match " << options.goldenFilename << ": " << diff.numDifferentPixels
+                  << " pixels differ, by up to " << diff.maxChannelDifference << "\n";
+        return 1;
+    }
+
+    std::cout << "Final frame matches " << options.goldenFilename << " (max difference "
+              << diff.maxChannelDifference << ")\n";
+    return 0;
+}
+
+void printRenderTime(const Options& options, Clock::duration renderTime, const char* rendererName)
+{
+    double totalMs = std::chrono::duration<double, std::milli>(renderTime).count();
+    double avgMs = totalMs / std::max(options.numFrames, 1);
+    std::cout << "Rendered " << options.numFrames << " frames at " << options.width << "x" << options.height
+              << " in " << totalMs << " ms (" << avgMs << " ms per frame, " << 1000.0 / avgMs << " FPS)\n";
+    std::cout << "Renderer: " << rendererName << "\n";
+}
+
+/**
+ * Plays the scripted match, rendering every frame, and returns the time spent rendering.
+ *
+ * Only rendering is timed; the simulation has its own benchmarks.
+ */
+Clock::duration renderMatch(const Options& options, ScriptedMatch& match, Renderer& renderer)
+{
+    Clock::duration renderTime {};
+    for (int frame = 0; frame < options.numFrames; ++frame)
+    {
+        match.tick();
+
+        Clock::time_point startTime = Clock::now();
+        renderer.render(frame * static_cast<double>(TimeUtils::frameTime));
+        renderTime += Clock::now() - startTime;
+    }
+    return renderTime;
+}
+
+int renderWithGpu(const Options& options)
+{
+    HeadlessContext context;
+    Shaders::initializeShaders();
+
+    glm::ivec2 targetSize { options.width, options.height };
+    OffscreenTarget target(options.width, options.height);
+    ScriptedMatch match(options.numPlayers);
+    GameRenderer renderer(targetSize, &match.world, &match.cameras, &match.particles, &match.screenShake);
+
+    target.bind();
+    Clock::duration renderTime = renderMatch(options, match, renderer);
+
+    // Include any work the GPU has not finished yet
+    Clock::time_point finishStartTime = Clock::now();
+    glFinish();
+    renderTime += Clock::now() - finishStartTime;
+
+    printRenderTime(options, renderTime, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+
+    if (options.screenshotFilename.empty() && options.goldenFilename.empty())
+    {
+        return 0;
+    }
+
+    AsyncReadback readback(options.width, options.height, 1);
+    Image image;
+    readback.request();
+    if (!readback.poll(image, true))
+    {
+        std::cerr << "Failed to read back the final frame\n";
+        return -1;
+    }
+
+    return checkFinalFrame(options, image);
+}
+
+int renderWithCpu(const Options& options)
+{
+    glm::ivec2 targetSize { options.width, options.height };
+    ScriptedMatch match(options.numPlayers);
+    ThreadPool threadPool;
+    SoftwareRenderer renderer(targetSize, &match.world, &match.cameras, &match.screenShake, &threadPool);
+
+    Clock::duration renderTime = renderMatch(options, match, renderer);
+    printRenderTime(options, renderTime, "software");
+
+    return checkFinalFrame(options, renderer.getImage());
+}
+
+}  // namespace
+
+int run(const Options& options)
+{
+    try
+    {
+        return options.software ? renderWithCpu(options) : renderWithGpu(options);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+        return -1;
+    }
+}
+
+}  // namespace Headless
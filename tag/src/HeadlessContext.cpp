@@ -0,0 +1,140 @@
+#include "HeadlessContext.h"
+
+#include <GL/glew.h>
+#ifdef TAG_HEADLESS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#else
+#include <GLFW/glfw3.h>
+#endif
+
+#include <stdexcept>
+#include <string>
+
+#ifdef TAG_HEADLESS_EGL
+
+HeadlessContext::HeadlessContext()
+{
+    // Prefer Mesa's surfaceless platform, which needs no display server
+    EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+    auto getPlatformDisplay =
+            reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay)
+    {
+        eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (eglDisplay == EGL_NO_DISPLAY)
+    {
+        eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, nullptr, nullptr))
+    {
+        throw std::runtime_error("Failed to initialize EGL display");
+    }
+    display = eglDisplay;
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        destroy();
+        throw std::runtime_error("EGL does not support desktop OpenGL");
+    }
+
+    // No surface will be created, so any config that supports OpenGL will do
+    const EGLint configAttribs[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLConfig config = nullptr;
+    EGLint numConfigs = 0;
+    eglChooseConfig(eglDisplay, configAttribs, &config, 1, &numConfigs);
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext eglContext =
+            eglCreateContext(eglDisplay, numConfigs > 0 ? config : EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttribs);
+    if (eglContext == EGL_NO_CONTEXT)
+    {
+        destroy();
+        throw std::runtime_error("Failed to create EGL context");
+    }
+    context = eglContext;
+
+    if (!eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext))
+    {
+        destroy();
+        throw std::runtime_error("Failed to make EGL context current");
+    }
+
+    // GLEW looks for a GLX display first, which may not exist; its function pointers still load correctly
+    glewExperimental = GL_TRUE;
+    GLenum glewStatus = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    if (glewStatus == GLEW_ERROR_NO_GLX_DISPLAY)
+    {
+        glewStatus = GLEW_OK;
+    }
+#endif
+    if (glewStatus != GLEW_OK)
+    {
+        destroy();
+        const char* error = reinterpret_cast<const char*>(glewGetErrorString(glewStatus));
+        throw std::runtime_error(std::string("Failed to initialize GLEW: ") + error);
+    }
+}
+
+void HeadlessContext::destroy()
+{
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (context)
+    {
+        eglDestroyContext(display, context);
+    }
+    eglTerminate(display);
+}
+
+#else
+
+HeadlessContext::HeadlessContext()
+{
+    if (!glfwInit())
+    {
+        throw std::runtime_error("Failed to initialize GLFW");
+    }
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // Only the context is needed, so the window can be tiny
+    window = glfwCreateWindow(1, 1, "Tag (headless)", nullptr, nullptr);
+    if (!window)
+    {
+        glfwTerminate();
+        throw std::runtime_error("Failed to create hidden window");
+    }
+
+    glfwMakeContextCurrent(window);
+
+    GLenum glewStatus = glewInit();
+    if (glewStatus != GLEW_OK)
+    {
+        destroy();
+        const char* error = reinterpret_cast<const char*>(glewGetErrorString(glewStatus));
+        throw std::runtime_error(std::string("Failed to initialize GLEW: ") + error);
+    }
+}
+
+void HeadlessContext::destroy()
+{
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
+
+#endif
+
+HeadlessContext::~HeadlessContext()
+{
+    destroy();
+}
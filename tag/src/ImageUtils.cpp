@@ -0,0 +1,144 @@
+#include "ImageUtils.h"
+
+#include <algorithm>  // max
+#include <cstdlib>    // abs
+#include <fstream>
+#include <stdexcept>
+
+namespace ImageUtils {
+
+namespace {
+
+constexpr int numColorChannels = 3;
+constexpr int maxPpmValue = 255;
+
+/**
+ * Reads the next number from a PPM header, skipping whitespace and comments.
+ */
+int readHeaderValue(std::istream& in)
+{
+    in >> std::ws;
+    while (in.peek() == '#')
+    {
+        std::string comment;
+        std::getline(in, comment);
+        in >> std::ws;
+    }
+
+    int value = 0;
+    if (!(in >> value))
+    {
+        throw std::runtime_error("Invalid PPM header");
+    }
+    return value;
+}
+
+}  // namespace
+
+void writePpm(const std::string& filename, const Image& image)
+{
+    std::ofstream out(filename, std::ios::binary);
+    if (!out)
+    {
+        throw std::runtime_error("Failed to open image file for writing: " + filename);
+    }
+
+    out << "P6\n" << image.width << " " << image.height << "\n" << maxPpmValue << "\n";
+
+    std::vector<uint8_t> row(static_cast<size_t>(image.width) * numColorChannels);
+    for (int y = 0; y < image.height; ++y)
+    {
+        const uint8_t* src = &image.pixels[static_cast<size_t>(y) * image.width * Image::bytesPerPixel];
+        for (int x = 0; x < image.width; ++x)
+        {
+            row[x * numColorChannels + 0] = src[x * Image::bytesPerPixel + 0];
+            row[x * numColorChannels + 1] = src[x * Image::bytesPerPixel + 1];
+            row[x * numColorChannels + 2] = src[x * Image::bytesPerPixel + 2];
+        }
+        out.write(reinterpret_cast<const char*>(row.data()), row.size());
+    }
+
+    if (!out)
+    {
+        throw std::runtime_error("Failed to write image file: " + filename);
+    }
+}
+
+Image readPpm(const std::string& filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+    {
+        throw std::runtime_error("Failed to open image file: " + filename);
+    }
+
+    std::string magic;
+    in >> magic;
+    if (magic != "P6")
+    {
+        throw std::runtime_error("Not a binary PPM file: " + filename);
+    }
+
+    Image image;
+    image.width = readHeaderValue(in);
+    image.height = readHeaderValue(in);
+    int maxValue = readHeaderValue(in);
+    if (image.width <= 0 || image.height <= 0 || maxValue != maxPpmValue)
+    {
+        throw std::runtime_error("Unsupported PPM format: " + filename);
+    }
+
+    // Exactly one whitespace character separates the header from the pixel data
+    in.get();
+
+    std::vector<uint8_t> row(static_cast<size_t>(image.width) * numColorChannels);
+    image.pixels.resize(static_cast<size_t>(image.width) * image.height * Image::bytesPerPixel);
+    for (int y = 0; y < image.height; ++y)
+    {
+        if (!in.read(reinterpret_cast<char*>(row.data()), row.size()))
+        {
+            throw std::runtime_error("Truncated PPM file: " + filename);
+        }
+
+        uint8_t* dest = &image.pixels[static_cast<size_t>(y) * image.width * Image::bytesPerPixel];
+        for (int x = 0; x < image.width; ++x)
+        {
+            dest[x * Image::bytesPerPixel + 0] = row[x * numColorChannels + 0];
+            dest[x * Image::bytesPerPixel + 1] = row[x * numColorChannels + 1];
+            dest[x * Image::bytesPerPixel + 2] = row[x * numColorChannels + 2];
+            dest[x * Image::bytesPerPixel + 3] = maxPpmValue;
+        }
+    }
+
+    return image;
+}
+
+ImageDiff compare(const Image& a, const Image& b, int tolerance)
+{
+    if (a.width != b.width || a.height != b.height)
+    {
+        throw std::invalid_argument("Cannot compare images of different sizes");
+    }
+
+    ImageDiff diff;
+    const size_t numPixels = static_cast<size_t>(a.width) * a.height;
+    for (size_t i = 0; i < numPixels; ++i)
+    {
+        int pixelDifference = 0;
+        for (int channel = 0; channel < numColorChannels; ++channel)
+        {
+            size_t index = i * Image::bytesPerPixel + channel;
+            pixelDifference = std::max(pixelDifference, std::abs(a.pixels[index] - b.pixels[index]));
+        }
+
+        diff.maxChannelDifference = std::max(diff.maxChannelDifference, pixelDifference);
+        if (pixelDifference > tolerance)
+        {
+            ++diff.numDifferentPixels;
+        }
+    }
+
+    return diff;
+}
+
+}  // namespace ImageUtils
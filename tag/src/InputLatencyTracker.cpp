@@ -0,0 +1,110 @@
+#include "InputLatencyTracker.h"
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * Percentiles written to the report.
+ */
+constexpr double reportedPercentiles[] = { 0.5, 0.9, 0.99, 0.999, 1.0 };
+
+void printSummary(std::ostream& out, const char* name, const LatencyHistogram& histogram)
+{
+    out << "  " << name << ": avg " << histogram.getMeanMs() << " ms, p50 " << histogram.getPercentileMs(0.5)
+        << " ms, p99 " << histogram.getPercentileMs(0.99) << " ms, max " << histogram.getMaxMs() << " ms\n";
+}
+
+void writeDistribution(std::ostream& out, const char* name, const LatencyHistogram& histogram)
+{
+    out << name << " (" << histogram.getCount() << " samples)\n";
+    out << "  min " << histogram.getMinMs() << " ms, avg " << histogram.getMeanMs() << " ms\n";
+    for (double fraction : reportedPercentiles)
+    {
+        out << "  p" << fraction * 100.0 << " " << histogram.getPercentileMs(fraction) << " ms\n";
+    }
+
+    // Every non-empty bucket, so that the distribution can be plotted or compared between runs
+    out << "  buckets (ms: samples)\n";
+    histogram.forEachBucket([&](double lowMs, double highMs, uint64_t count) {
+        out << "    " << lowMs << "-" << highMs << ": " << count << "\n";
+    });
+}
+
+}  // namespace
+
+void InputLatencyTracker::inputApplied(double inputTime, double tickTime)
+{
+    recent.tick.record(tickTime - inputTime);
+    pendingInputTimes.push_back(inputTime);
+}
+
+void InputLatencyTracker::frameRendered(double renderTime)
+{
+    for (size_t i = numRenderedInputs; i < pendingInputTimes.size(); ++i)
+    {
+        recent.render.record(renderTime - pendingInputTimes[i]);
+    }
+    numRenderedInputs = pendingInputTimes.size();
+}
+
+void InputLatencyTracker::frameSwapped(double swapTime)
+{
+    // Inputs applied after the frame was rendered are left for the next frame
+    for (size_t i = 0; i < numRenderedInputs; ++i)
+    {
+        recent.swap.record(swapTime - pendingInputTimes[i]);
+    }
+    pendingInputTimes.erase(pendingInputTimes.begin(), pendingInputTimes.begin() + numRenderedInputs);
+    numRenderedInputs = 0;
+
+    ++frameIndex;
+    if (frameIndex % framesPerReport == 0)
+    {
+        report();
+    }
+}
+
+void InputLatencyTracker::writeReport(const std::string& filename) const
+{
+    std::ofstream out(filename);
+    if (!out)
+    {
+        throw std::runtime_error("Failed to open latency report: " + filename);
+    }
+
+    // Include whatever has not yet made it into a periodic report
+    Stages stages = total;
+    stages.tick.add(recent.tick);
+    stages.render.add(recent.render);
+    stages.swap.add(recent.swap);
+
+    writeDistribution(out, "Input to tick", stages.tick);
+    writeDistribution(out, "Input to render", stages.render);
+    writeDistribution(out, "Input to swap", stages.swap);
+
+    if (!out)
+    {
+        throw std::runtime_error("Failed to write latency report: " + filename);
+    }
+}
+
+void InputLatencyTracker::report()
+{
+    if (recent.swap.getCount() > 0)
+    {
+        std::cout << "Input latency (" << recent.swap.getCount() << " inputs):\n";
+        printSummary(std::cout, "to tick", recent.tick);
+        printSummary(std::cout, "to render", recent.render);
+        printSummary(std::cout, "to swap", recent.swap);
+    }
+
+    total.tick.add(recent.tick);
+    total.render.add(recent.render);
+    total.swap.add(recent.swap);
+    recent.tick.reset();
+    recent.render.reset();
+    recent.swap.reset();
+}
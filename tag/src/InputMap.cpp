@@ -0,0 +1,280 @@
+#include "InputMap.h"
+
+#include <GLFW/glfw3.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "World.h"
+
+namespace {
+
+/**
+ * Keys with names that cannot be derived from their code.
+ */
+const std::pair<const char*, int> namedKeys[] = {
+    { "UP", GLFW_KEY_UP },
+    { "DOWN", GLFW_KEY_DOWN },
+    { "LEFT", GLFW_KEY_LEFT },
+    { "RIGHT", GLFW_KEY_RIGHT },
+    { "SPACE", GLFW_KEY_SPACE },
+    { "ENTER", GLFW_KEY_ENTER },
+    { "ESCAPE", GLFW_KEY_ESCAPE },
+    { "APOSTROPHE", GLFW_KEY_APOSTROPHE },
+    { "COMMA", GLFW_KEY_COMMA },
+    { "MINUS", GLFW_KEY_MINUS },
+    { "PERIOD", GLFW_KEY_PERIOD },
+    { "SLASH", GLFW_KEY_SLASH },
+    { "SEMICOLON", GLFW_KEY_SEMICOLON },
+    { "EQUAL", GLFW_KEY_EQUAL },
+    { "LEFT_BRACKET", GLFW_KEY_LEFT_BRACKET },
+    { "BACKSLASH", GLFW_KEY_BACKSLASH },
+    { "RIGHT_BRACKET", GLFW_KEY_RIGHT_BRACKET },
+    { "GRAVE_ACCENT", GLFW_KEY_GRAVE_ACCENT },
+    { "TAB", GLFW_KEY_TAB },
+    { "BACKSPACE", GLFW_KEY_BACKSPACE },
+    { "INSERT", GLFW_KEY_INSERT },
+    { "DELETE", GLFW_KEY_DELETE },
+    { "HOME", GLFW_KEY_HOME },
+    { "END", GLFW_KEY_END },
+    { "PAGE_UP", GLFW_KEY_PAGE_UP },
+    { "PAGE_DOWN", GLFW_KEY_PAGE_DOWN },
+    { "KP_DECIMAL", GLFW_KEY_KP_DECIMAL },
+    { "KP_DIVIDE", GLFW_KEY_KP_DIVIDE },
+    { "KP_MULTIPLY", GLFW_KEY_KP_MULTIPLY },
+    { "KP_SUBTRACT", GLFW_KEY_KP_SUBTRACT },
+    { "KP_ADD", GLFW_KEY_KP_ADD },
+    { "KP_ENTER", GLFW_KEY_KP_ENTER },
+    { "LEFT_SHIFT", GLFW_KEY_LEFT_SHIFT },
+    { "LEFT_CONTROL", GLFW_KEY_LEFT_CONTROL },
+    { "RIGHT_SHIFT", GLFW_KEY_RIGHT_SHIFT },
+    { "RIGHT_CONTROL", GLFW_KEY_RIGHT_CONTROL },
+};
+
+/**
+ * Default key for each player's up, down, left and right controls.
+ */
+constexpr int defaultKeys[World::maxPlayers][4] = {
+    { GLFW_KEY_UP, GLFW_KEY_DOWN, GLFW_KEY_LEFT, GLFW_KEY_RIGHT },  //
+    { GLFW_KEY_W, GLFW_KEY_S, GLFW_KEY_A, GLFW_KEY_D },              //
+    { GLFW_KEY_KP_8, GLFW_KEY_KP_5, GLFW_KEY_KP_4, GLFW_KEY_KP_6 },  //
+    { GLFW_KEY_I, GLFW_KEY_K, GLFW_KEY_J, GLFW_KEY_L },              //
+};
+
+/**
+ * Directions in the order used by defaultKeys.
+ */
+constexpr Direction defaultKeyDirs[4] = { Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT };
+
+int getDefaultKey(int playerId, Direction dir)
+{
+    return defaultKeys[playerId][static_cast<int>(dir) - static_cast<int>(Direction::UP)];
+}
+
+Direction parseDirection(const std::string& name)
+{
+    if (name == "up")
+    {
+        return Direction::UP;
+    }
+    if (name == "down")
+    {
+        return Direction::DOWN;
+    }
+    if (name == "left")
+    {
+        return Direction::LEFT;
+    }
+    if (name == "right")
+    {
+        return Direction::RIGHT;
+    }
+    return Direction::NONE;
+}
+
+}  // namespace
+
+InputMap::InputMap()
+{
+    static_assert(numKeys == GLFW_KEY_LAST + 1);
+
+    for (int playerId = 0; playerId < World::maxPlayers; ++playerId)
+    {
+        for (Direction dir : defaultKeyDirs)
+        {
+            bind(getDefaultKey(playerId, dir), playerId, dir);
+        }
+    }
+}
+
+InputMap InputMap::loadFile(const std::string& filename)
+{
+    std::ifstream in(filename);
+    if (!in)
+    {
+        throw std::runtime_error("Failed to open controls file: " + filename);
+    }
+
+    InputMap inputMap;
+    inputMap.clear();
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+
+        std::istringstream fields(line);
+        std::string playerField;
+        if (!(fields >> playerField) || playerField[0] == '#')
+        {
+            continue;
+        }
+
+        auto fail = [&](const std::string& reason) {
+            return std::runtime_error(filename + ":" + std::to_string(lineNumber) + ": " + reason);
+        };
+
+        std::string dirField;
+        std::string keyField;
+        std::string extra;
+        if (!(fields >> dirField >> keyField) || fields >> extra)
+        {
+            throw fail("Expected: [player] [direction] [key]");
+        }
+
+        int playerId = 0;
+        try
+        {
+            playerId = std::stoi(playerField) - 1;
+        }
+        catch (const std::exception&)
+        {
+            throw fail("Invalid player: " + playerField);
+        }
+        if (playerId < 0 || playerId >= World::maxPlayers)
+        {
+            throw fail("Player must be between 1 and " + std::to_string(World::maxPlayers));
+        }
+
+        Direction dir = parseDirection(dirField);
+        if (dir == Direction::NONE)
+        {
+            throw fail("Invalid direction: " + dirField);
+        }
+
+        int key = findKey(keyField);
+        if (key < 0)
+        {
+            throw fail("Unknown key: " + keyField);
+        }
+
+        // Reserved keys would never reach the player, so keep the control usable with its default key instead
+        if (isReservedKey(key))
+        {
+            std::cerr << filename << ":" << lineNumber << ": " << keyField
+                      << " is reserved by the game; using the default key for this control\n";
+            key = getDefaultKey(playerId, dir);
+        }
+
+        inputMap.bind(key, playerId, dir);
+    }
+
+    return inputMap;
+}
+
+bool InputMap::bind(int key, int playerId, Direction dir)
+{
+    if (!isValidKey(key))
+    {
+        return false;
+    }
+    if (isReservedKey(key))
+    {
+        std::cerr << "Cannot bind key " << key << ", since it is reserved by the game\n";
+        return false;
+    }
+
+    for (Binding& binding : bindings)
+    {
+        if (binding.playerId == playerId && binding.dir == dir)
+        {
+            binding = {};
+        }
+    }
+
+    bindings[key] = { playerId, dir };
+    return true;
+}
+
+void InputMap::unbind(int key)
+{
+    if (isValidKey(key))
+    {
+        bindings[key] = {};
+    }
+}
+
+void InputMap::clear()
+{
+    bindings.fill({});
+}
+
+bool InputMap::isReservedKey(int key)
+{
+    switch (key)
+    {
+    case GLFW_KEY_SPACE:
+    case GLFW_KEY_ENTER:
+    case GLFW_KEY_ESCAPE:
+    case GLFW_KEY_F2:
+    case GLFW_KEY_F3:
+    case GLFW_KEY_F4:
+        return true;
+    default:
+        return false;
+    }
+}
+
+int InputMap::findKey(const std::string& name)
+{
+    // Letters and digits are named after themselves
+    if (name.size() == 1)
+    {
+        char c = name[0];
+        if (c >= 'A' && c <= 'Z')
+        {
+            return GLFW_KEY_A + (c - 'A');
+        }
+        if (c >= '0' && c <= '9')
+        {
+            return GLFW_KEY_0 + (c - '0');
+        }
+    }
+    if (name.size() == 4 && name.compare(0, 3, "KP_") == 0 && name[3] >= '0' && name[3] <= '9')
+    {
+        return GLFW_KEY_KP_0 + (name[3] - '0');
+    }
+    if ((name.size() == 2 || name.size() == 3) && name[0] == 'F'
+            && name.find_first_not_of("0123456789", 1) == std::string::npos)
+    {
+        int n = std::stoi(name.substr(1));
+        if (n >= 1 && n <= 12)
+        {
+            return GLFW_KEY_F1 + (n - 1);
+        }
+    }
+
+    for (const auto& [keyName, key] : namedKeys)
+    {
+        if (name == keyName)
+        {
+            return key;
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,113 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>  // clamp, fill, max, min
+#include <bit>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram()
+    : counts(getBucketIndex(maxValue) + 1)
+{
+}
+
+void LatencyHistogram::record(double seconds)
+{
+    double micros = std::clamp(seconds * 1e6, 0.0, static_cast<double>(maxValue));
+    uint64_t value = static_cast<uint64_t>(std::llround(micros));
+
+    ++counts[getBucketIndex(value)];
+    minValue = count == 0 ? value : std::min(minValue, value);
+    maxRecordedValue = std::max(maxRecordedValue, value);
+    totalValue += static_cast<double>(value);
+    ++count;
+}
+
+void LatencyHistogram::add(const LatencyHistogram& other)
+{
+    if (other.count == 0)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        counts[i] += other.counts[i];
+    }
+    minValue = count == 0 ? other.minValue : std::min(minValue, other.minValue);
+    maxRecordedValue = std::max(maxRecordedValue, other.maxRecordedValue);
+    totalValue += other.totalValue;
+    count += other.count;
+}
+
+void LatencyHistogram::reset()
+{
+    std::fill(counts.begin(), counts.end(), 0);
+    count = 0;
+    minValue = 0;
+    maxRecordedValue = 0;
+    totalValue = 0.0;
+}
+
+double LatencyHistogram::getPercentileMs(double fraction) const
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
+    // Nearest rank, as with Benchmarks
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * count));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+        {
+            // The top of the bucket may be above anything actually recorded
+            return std::min(getBucketMaxValue(static_cast<int>(i)), maxRecordedValue) / 1000.0;
+        }
+    }
+
+    return maxRecordedValue / 1000.0;
+}
+
+double LatencyHistogram::getMinMs() const
+{
+    return minValue / 1000.0;
+}
+
+double LatencyHistogram::getMeanMs() const
+{
+    return count == 0 ? 0.0 : totalValue / count / 1000.0;
+}
+
+double LatencyHistogram::getMaxMs() const
+{
+    return maxRecordedValue / 1000.0;
+}
+
+int LatencyHistogram::getBucketIndex(uint64_t value)
+{
+    if (value < subBucketCount)
+    {
+        return static_cast<int>(value);
+    }
+
+    // Keep only the top bits of the value; each extra bit halves the precision needed
+    int shift = static_cast<int>(std::bit_width(value)) - precisionBits;
+    uint64_t subBucket = value >> shift;
+    return static_cast<int>(subBucketCount + (shift - 1) * subBucketHalfCount + (subBucket - subBucketHalfCount));
+}
+
+uint64_t LatencyHistogram::getBucketMaxValue(int index)
+{
+    if (index < static_cast<int>(subBucketCount))
+    {
+        return static_cast<uint64_t>(index);
+    }
+
+    int shift = (index - static_cast<int>(subBucketCount)) / static_cast<int>(subBucketHalfCount) + 1;
+    uint64_t subBucket = (static_cast<uint64_t>(index) - subBucketCount) % subBucketHalfCount + subBucketHalfCount;
+    return ((subBucket + 1) << shift) - 1;
+}
@@ -0,0 +1,194 @@
+#include "LevelFile.h"
+
+#include <algorithm>  // fill_n
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/** Largest chunk we accept, to stop a corrupt header from requesting enormous decode buffers. */
+constexpr uint32_t maxChunkSize = 256;
+
+/** Longest run that fits in a count byte. */
+constexpr int maxRunLength = 255;
+
+}  // namespace
+
+LevelFile::LevelFile(const std::string& filename)
+    : file(filename)
+{
+    if (file.getSize() < sizeof(Header))
+    {
+        throw std::runtime_error("Level file is too small: " + filename);
+    }
+
+    Header header;
+    std::memcpy(&header, file.getData(), sizeof(Header));
+
+    if (header.magic != magic)
+    {
+        throw std::runtime_error("Not a level file: " + filename);
+    }
+    if (header.version != version)
+    {
+        throw std::runtime_error("Unsupported level file version: " + filename);
+    }
+    if (header.widthTiles == 0 || header.heightTiles == 0 || header.chunkSize == 0 || header.chunkSize > maxChunkSize
+            || header.widthTiles > INT32_MAX / 2 || header.heightTiles > INT32_MAX / 2 || !(header.tileSize > 0.f))
+    {
+        throw std::runtime_error("Invalid level dimensions: " + filename);
+    }
+
+    widthTiles = static_cast<int>(header.widthTiles);
+    heightTiles = static_cast<int>(header.heightTiles);
+    chunkSize = static_cast<int>(header.chunkSize);
+    tileSize = header.tileSize;
+    numChunksX = (widthTiles + chunkSize - 1) / chunkSize;
+    numChunksY = (heightTiles + chunkSize - 1) / chunkSize;
+
+    // Only the size of the chunk table is checked here; entries are checked when their chunk is decoded
+    uint64_t tableSize = static_cast<uint64_t>(numChunksX) * numChunksY * sizeof(ChunkEntry);
+    if (file.getSize() - sizeof(Header) < tableSize)
+    {
+        throw std::runtime_error("Level file is truncated: " + filename);
+    }
+    chunkTable = reinterpret_cast<const ChunkEntry*>(file.getData() + sizeof(Header));
+}
+
+void LevelFile::write(
+        const std::string& filename,
+        int widthTiles,
+        int heightTiles,
+        int chunkSize,
+        float tileSize,
+        const std::function<uint8_t(int, int)>& getTile)
+{
+    if (widthTiles <= 0 || heightTiles <= 0 || chunkSize <= 0 || chunkSize > static_cast<int>(maxChunkSize)
+            || !(tileSize > 0.f))
+    {
+        throw std::runtime_error("Invalid level dimensions");
+    }
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        throw std::runtime_error("Failed to open file for writing: " + filename);
+    }
+
+    Header header {};
+    header.magic = magic;
+    header.version = version;
+    header.widthTiles = static_cast<uint32_t>(widthTiles);
+    header.heightTiles = static_cast<uint32_t>(heightTiles);
+    header.chunkSize = static_cast<uint32_t>(chunkSize);
+    header.tileSize = tileSize;
+
+    int numChunksX = (widthTiles + chunkSize - 1) / chunkSize;
+    int numChunksY = (heightTiles + chunkSize - 1) / chunkSize;
+    std::vector<ChunkEntry> chunkTable(static_cast<size_t>(numChunksX) * numChunksY);
+
+    // Leave space for the chunk table, which is filled in once we know where each chunk ends up
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    out.write(reinterpret_cast<const char*>(chunkTable.data()), chunkTable.size() * sizeof(ChunkEntry));
+
+    uint64_t offset = sizeof(Header) + chunkTable.size() * sizeof(ChunkEntry);
+    std::vector<uint8_t> encoded;
+
+    for (int chunkY = 0; chunkY < numChunksY; ++chunkY)
+    {
+        for (int chunkX = 0; chunkX < numChunksX; ++chunkX)
+        {
+            encoded.clear();
+
+            int minX = chunkX * chunkSize;
+            int minY = chunkY * chunkSize;
+            int maxX = std::min(minX + chunkSize, widthTiles);
+            int maxY = std::min(minY + chunkSize, heightTiles);
+
+            // Runs continue from one row to the next, so empty or solid chunks collapse to a few bytes
+            int runLength = 0;
+            uint8_t runTile = 0;
+            for (int y = minY; y < maxY; ++y)
+            {
+                for (int x = minX; x < maxX; ++x)
+                {
+                    uint8_t tile = getTile(x, y);
+                    if (runLength > 0 && (tile != runTile || runLength == maxRunLength))
+                    {
+                        encoded.push_back(static_cast<uint8_t>(runLength));
+                        encoded.push_back(runTile);
+                        runLength = 0;
+                    }
+                    runTile = tile;
+                    ++runLength;
+                }
+            }
+            encoded.push_back(static_cast<uint8_t>(runLength));
+            encoded.push_back(runTile);
+
+            ChunkEntry& entry = chunkTable[static_cast<size_t>(chunkY) * numChunksX + chunkX];
+            entry.offset = offset;
+            entry.size = static_cast<uint32_t>(encoded.size());
+
+            out.write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+            offset += encoded.size();
+        }
+    }
+
+    out.seekp(sizeof(Header));
+    out.write(reinterpret_cast<const char*>(chunkTable.data()), chunkTable.size() * sizeof(ChunkEntry));
+
+    if (!out)
+    {
+        throw std::runtime_error("Failed to write level file: " + filename);
+    }
+}
+
+void LevelFile::decodeChunk(int chunkX, int chunkY, uint8_t* tiles) const
+{
+    ChunkEntry entry;
+    std::memcpy(&entry, &chunkTable[static_cast<size_t>(chunkY) * numChunksX + chunkX], sizeof(ChunkEntry));
+
+    if (entry.offset > file.getSize() || entry.size > file.getSize() - entry.offset || entry.size % 2 != 0)
+    {
+        throw std::runtime_error("Corrupt level chunk");
+    }
+
+    // Chunks along the right and bottom edges may be partially outside the level
+    int minX = chunkX * chunkSize;
+    int minY = chunkY * chunkSize;
+    int chunkWidth = std::min(chunkSize, widthTiles - minX);
+    int chunkHeight = std::min(chunkSize, heightTiles - minY);
+    int numTiles = chunkWidth * chunkHeight;
+
+    std::fill_n(tiles, chunkSize * chunkSize, solidTile);
+
+    const uint8_t* data = file.getData() + entry.offset;
+    const uint8_t* dataEnd = data + entry.size;
+    int tileIndex = 0;
+
+    for (; data != dataEnd; data += 2)
+    {
+        int runLength = data[0];
+        uint8_t tile = data[1];
+        if (runLength > numTiles - tileIndex)
+        {
+            throw std::runtime_error("Corrupt level chunk");
+        }
+
+        // Runs are stored in level order, but may wrap onto the next row of the chunk
+        for (int i = 0; i < runLength; ++i, ++tileIndex)
+        {
+            int x = tileIndex % chunkWidth;
+            int y = tileIndex / chunkWidth;
+            tiles[y * chunkSize + x] = tile;
+        }
+    }
+
+    if (tileIndex != numTiles)
+    {
+        throw std::runtime_error("Corrupt level chunk");
+    }
+}
@@ -0,0 +1,153 @@
+#include "Levels.h"
+
+#include <cstdlib>  // abs
+#include <random>
+#include <stdexcept>
+
+#include "LevelFile.h"
+#include "World.h"
+
+namespace Levels {
+
+Level loadLevelFile(const std::string& filename)
+{
+    auto tileMap = std::make_unique<TileMap>(std::make_unique<LevelFile>(filename), World::maxPlayers);
+    glm::vec2 size = tileMap->getWorldSize();
+    return { size, {}, std::move(tileMap) };
+}
+
+void writeRoomsLevelFile(const std::string& filename, int widthTiles, int heightTiles, unsigned int seed)
+{
+    static constexpr int roomSize = 24;
+    static constexpr int doorSize = 4;
+    static constexpr int chunkSize = 32;
+    static constexpr float tileSize = 0.5f;
+
+    // Size of the clear area around the centre, in tiles
+    static constexpr int spawnAreaSize = 24;
+
+    // Each room gets a random pillar, chosen by hashing its position so that tiles can be generated in any order
+    auto roomHash = [seed](int roomX, int roomY) {
+        uint32_t h = seed ^ (static_cast<uint32_t>(roomX) * 0x9E3779B1u) ^ (static_cast<uint32_t>(roomY) * 0x85EBCA77u);
+        h ^= h >> 15;
+        h *= 0x2C1B3C6Du;
+        h ^= h >> 12;
+        return h;
+    };
+
+    int centreX = widthTiles / 2;
+    int centreY = heightTiles / 2;
+
+    LevelFile::write(filename, widthTiles, heightTiles, chunkSize, tileSize, [&](int x, int y) {
+        if (std::abs(x - centreX) < spawnAreaSize && std::abs(y - centreY) < spawnAreaSize)
+        {
+            return LevelFile::emptyTile;
+        }
+
+        int localX = x % roomSize;
+        int localY = y % roomSize;
+        int roomX = x / roomSize;
+        int roomY = y / roomSize;
+
+        // Walls along the top and left of each room, with a door in the middle
+        bool inDoorway = std::abs(localX - roomSize / 2) < doorSize / 2 || std::abs(localY - roomSize / 2) < doorSize / 2;
+        if ((localX == 0 || localY == 0) && !inDoorway)
+        {
+            return LevelFile::solidTile;
+        }
+
+        // Pillar somewhere in the room
+        uint32_t h = roomHash(roomX, roomY);
+        int pillarX = 4 + static_cast<int>(h % (roomSize - 10));
+        int pillarY = 4 + static_cast<int>((h >> 8) % (roomSize - 10));
+        if (localX >= pillarX && localX < pillarX + 2 && localY >= pillarY && localY < pillarY + 2)
+        {
+            return LevelFile::solidTile;
+        }
+
+        return LevelFile::emptyTile;
+    });
+}
+
+std::vector<Rect> makeLevel(const std::string& name, glm::vec2 worldSize)
+{
+    if (name == "open")
+    {
+        return makeOpen();
+    }
+    if (name == "pillars")
+    {
+        return makePillars(worldSize);
+    }
+
+    throw std::invalid_argument("Unknown level: " + name);
+}
+
+std::vector<Rect> makeOpen()
+{
+    return {};
+}
+
+std::vector<Rect> makePillars(glm::vec2 worldSize)
+{
+    glm::vec2 worldExtents = worldSize / 2.f;
+
+    return {
+        // Centre
+        { { 0.f, 0.f }, { 1.f, 1.f } },
+
+        // Corners
+        { { -worldExtents.x / 1.5f, -worldExtents.y / 1.6f }, { 0.75f, 0.75f } },
+        { { worldExtents.x / 1.5f, -worldExtents.y / 1.6f }, { 0.75f, 0.75f } },
+        { { -worldExtents.x / 1.5f, worldExtents.y / 1.6f }, { 0.75f, 0.75f } },
+        { { worldExtents.x / 1.5f, worldExtents.y / 1.6f }, { 0.75f, 0.75f } },
+
+        // Side walls
+        { { -worldExtents.x / 1.5f, 0.f }, { 0.25f, 2.f } },
+        { { worldExtents.x / 1.5f, 0.f }, { 0.25f, 2.f } },
+
+        // Top / bottom walls
+        { { 0.f, -worldExtents.y + 2.5f }, { 3.f, 0.25f } },
+        { { 0.f, worldExtents.y - 2.5f }, { 3.f, 0.25f } },
+    };
+}
+
+std::vector<Rect> makeMaze(glm::vec2 worldSize, float cellSize, unsigned int seed)
+{
+    static constexpr float wallThickness = 0.25f;
+
+    // Chance of each cell edge having a wall
+    static constexpr float wallChance = 0.3f;
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(0.f, 1.f);
+
+    int numCellsX = static_cast<int>(worldSize.x / cellSize);
+    int numCellsY = static_cast<int>(worldSize.y / cellSize);
+    glm::vec2 origin = -worldSize / 2.f;
+
+    std::vector<Rect> walls;
+    for (int y = 1; y < numCellsY; ++y)
+    {
+        for (int x = 1; x < numCellsX; ++x)
+        {
+            glm::vec2 corner = origin + glm::vec2(x * cellSize, y * cellSize);
+
+            // Horizontal wall along the top of this cell
+            if (dist(rng) < wallChance)
+            {
+                walls.push_back({ corner - glm::vec2(cellSize / 2.f, 0.f), { cellSize / 2.f, wallThickness / 2.f } });
+            }
+
+            // Vertical wall along the left of this cell
+            if (dist(rng) < wallChance)
+            {
+                walls.push_back({ corner - glm::vec2(0.f, cellSize / 2.f), { wallThickness / 2.f, cellSize / 2.f } });
+            }
+        }
+    }
+
+    return walls;
+}
+
+}  // namespace Levels
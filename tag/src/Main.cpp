@@ -2,19 +2,78 @@
 #include <GL/gl.h>
 #include <GLFW/glfw3.h>
 
+#include <chrono>
 #include <iostream>
 
 #include "Application.h"
+#include "Benchmarks.h"
+#include "Headless.h"
+#include "Levels.h"
 #include "Shaders.h"
 #include "World.h"
 
 static constexpr int windowWidth = 800;
 static constexpr int windowHeight = 600;
+static constexpr int maxFramesInFlightLimit = 8;
 static const std::string versionString = "1.0.0";
 static const std::string windowTitle = "Tag v" + versionString;
 static bool fullscreenEnabled = false;
 static bool vsyncEnabled = true;
+static int maxFramesInFlight = 0;
+static bool lateLatchEnabled = false;
 static int numPlayers = 2;
+static int numBots = 0;
+static std::string worldFeedName;
+static std::string benchmarkName;
+static Benchmarks::RenderOptions renderBenchmarkOptions;
+static std::string levelName = "open";
+static std::string levelFilename;
+static std::string cameraModeName;
+static GameMode gameMode = GameMode::Classic;
+static bool powerUpsEnabled = false;
+static bool splitScreenEnabled = false;
+static bool bloomEnabled = false;
+static std::string recordFilename;
+static std::string latencyReportFilename;
+static std::string controlsFilename;
+static bool headlessEnabled = false;
+static Headless::Options headlessOptions;
+
+/**
+ * Logs the time taken by each phase of startup.
+ */
+class StartupTimer
+{
+public:
+    /**
+     * Logs the time since the previous phase ended, or since the timer was created.
+     */
+    void endPhase(const char* name)
+    {
+        auto now = std::chrono::steady_clock::now();
+        std::cout << "Startup: " << name << " took " << millisecondsBetween(phaseStart, now) << " ms\n";
+        phaseStart = now;
+    }
+
+    /**
+     * Logs the total startup time.
+     */
+    void finish() const
+    {
+        auto now = std::chrono::steady_clock::now();
+        std::cout << "Startup: total " << millisecondsBetween(startupStart, now) << " ms\n";
+    }
+
+private:
+    static double millisecondsBetween(
+            std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    std::chrono::steady_clock::time_point startupStart = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point phaseStart = startupStart;
+};
 
 static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
@@ -43,10 +102,87 @@ int main(int argc, char* argv[])
         {
             vsyncEnabled = false;
         }
+        else if (arg == "-maxFramesInFlight")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for maxFramesInFlight\n";
+                std::cerr << "Expected: -maxFramesInFlight [n]\n";
+                return -1;
+            }
+            try
+            {
+                maxFramesInFlight = std::stoi(argv[i + 1]);
+                if (maxFramesInFlight < 0 || maxFramesInFlight > maxFramesInFlightLimit)
+                {
+                    throw std::out_of_range("maxFramesInFlight out of range");
+                }
+            }
+            catch (const std::invalid_argument&)
+            {
+                std::cerr << "Invalid value supplied for maxFramesInFlight\n";
+                return -1;
+            }
+            catch (const std::out_of_range&)
+            {
+                std::cerr << "maxFramesInFlight must be between 0 and " << maxFramesInFlightLimit << "\n";
+                return -1;
+            }
+            ++i;  // Skip next argument
+        }
+        else if (arg == "-lateLatch")
+        {
+            lateLatchEnabled = true;
+        }
         else if (arg == "-fullscreen")
         {
             fullscreenEnabled = true;
         }
+        else if (arg == "-splitscreen")
+        {
+            splitScreenEnabled = true;
+        }
+        else if (arg == "-powerups")
+        {
+            powerUpsEnabled = true;
+        }
+        else if (arg == "-bloom")
+        {
+            bloomEnabled = true;
+        }
+        else if (arg == "-record")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for record\n";
+                std::cerr << "Expected: -record [filename]\n";
+                return -1;
+            }
+            recordFilename = argv[i + 1];
+            ++i;  // Skip next argument
+        }
+        else if (arg == "-latencyReport")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for latencyReport\n";
+                std::cerr << "Expected: -latencyReport [filename]\n";
+                return -1;
+            }
+            latencyReportFilename = argv[i + 1];
+            ++i;  // Skip next argument
+        }
+        else if (arg == "-feed")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for feed\n";
+                std::cerr << "Expected: -feed [name]\n";
+                return -1;
+            }
+            worldFeedName = argv[i + 1];
+            ++i;  // Skip next argument
+        }
         else if (arg == "-numPlayers")
         {
             if (i + 1 >= argc)
@@ -75,6 +211,243 @@ int main(int argc, char* argv[])
             }
             ++i;  // Skip next argument
         }
+        else if (arg == "-bots")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for bots\n";
+                std::cerr << "Expected: -bots [n]\n";
+                return -1;
+            }
+            try
+            {
+                numBots = std::stoi(argv[i + 1]);
+                if (numBots < 0 || numBots > World::maxPlayers)
+                {
+                    throw std::out_of_range("bots out of range");
+                }
+            }
+            catch (const std::invalid_argument&)
+            {
+                std::cerr << "Invalid value supplied for bots\n";
+                return -1;
+            }
+            catch (const std::out_of_range&)
+            {
+                std::cerr << "bots must be between 0 and " << World::maxPlayers << "\n";
+                return -1;
+            }
+            ++i;  // Skip next argument
+        }
+        else if (arg == "-controls")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for controls\n";
+                std::cerr << "Expected: -controls [filename]\n";
+                return -1;
+            }
+            controlsFilename = argv[i + 1];
+            ++i;  // Skip next argument
+        }
+        else if (arg == "-level")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for level\n";
+                std::cerr << "Expected: -level [name]\n";
+                return -1;
+            }
+            levelName = argv[i + 1];
+            ++i;  // Skip next argument
+        }
+        else if (arg == "-levelFile")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for levelFile\n";
+                std::cerr << "Expected: -levelFile [filename]\n";
+                return -1;
+            }
+            levelFilename = argv[i + 1];
+            ++i;  // Skip next argument
+        }
+        else if (arg == "-mode")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for mode\n";
+                std::cerr << "Expected: -mode [classic|inverted]\n";
+                return -1;
+            }
+            std::string modeName = argv[i + 1];
+            if (modeName == "classic")
+            {
+                gameMode = GameMode::Classic;
+            }
+            else if (modeName == "inverted")
+            {
+                gameMode = GameMode::Inverted;
+            }
+            else
+            {
+                std::cerr << "Invalid value supplied for mode\n";
+                std::cerr << "Expected: -mode [classic|inverted]\n";
+                return -1;
+            }
+            ++i;  // Skip next argument
+        }
+        else if (arg == "-camera")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for camera\n";
+                std::cerr << "Expected: -camera [world|group|player]\n";
+                return -1;
+            }
+            cameraModeName = argv[i + 1];
+            if (cameraModeName != "world" && cameraModeName != "group" && cameraModeName != "player")
+            {
+                std::cerr << "Invalid value supplied for camera\n";
+                std::cerr << "Expected: -camera [world|group|player]\n";
+                return -1;
+            }
+            ++i;  // Skip next argument
+        }
+        else if (arg == "-headless")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for headless\n";
+                std::cerr << "Expected: -headless [frames]\n";
+                return -1;
+            }
+            try
+            {
+                headlessOptions.numFrames = std::stoi(argv[i + 1]);
+                if (headlessOptions.numFrames < 1)
+                {
+                    throw std::out_of_range("headless out of range");
+                }
+            }
+            catch (const std::invalid_argument&)
+            {
+                std::cerr << "Invalid value supplied for headless\n";
+                return -1;
+            }
+            catch (const std::out_of_range&)
+            {
+                std::cerr << "headless must be at least 1\n";
+                return -1;
+            }
+            headlessEnabled = true;
+            ++i;  // Skip next argument
+        }
+        else if (arg == "-software")
+        {
+            headlessOptions.software = true;
+            headlessEnabled = true;
+        }
+        else if (arg == "-screenshot")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for screenshot\n";
+                std::cerr << "Expected: -screenshot [filename]\n";
+                return -1;
+            }
+            headlessOptions.screenshotFilename = argv[i + 1];
+            ++i;  // Skip next argument
+        }
+        else if (arg == "-golden")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for golden\n";
+                std::cerr << "Expected: -golden [filename]\n";
+                return -1;
+            }
+            headlessOptions.goldenFilename = argv[i + 1];
+            ++i;  // Skip next argument
+        }
+        else if (arg == "-benchmark")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for benchmark\n";
+                std::cerr << "Expected: -benchmark [name]\n";
+                return -1;
+            }
+            benchmarkName = argv[i + 1];
+            ++i;  // Skip next argument
+        }
+        else if (arg == "-benchmarkDecorations")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for benchmarkDecorations\n";
+                std::cerr << "Expected: -benchmarkDecorations [n]\n";
+                return -1;
+            }
+            try
+            {
+                renderBenchmarkOptions.numDecorations = std::stoi(argv[i + 1]);
+                if (renderBenchmarkOptions.numDecorations < 0)
+                {
+                    throw std::out_of_range("benchmarkDecorations out of range");
+                }
+            }
+            catch (const std::invalid_argument&)
+            {
+                std::cerr << "Invalid value supplied for benchmarkDecorations\n";
+                return -1;
+            }
+            catch (const std::out_of_range&)
+            {
+                std::cerr << "benchmarkDecorations must not be negative\n";
+                return -1;
+            }
+            ++i;  // Skip next argument
+        }
+        else if (arg == "-benchmarkDuration")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for benchmarkDuration\n";
+                std::cerr << "Expected: -benchmarkDuration [seconds]\n";
+                return -1;
+            }
+            try
+            {
+                renderBenchmarkOptions.durationSeconds = std::stod(argv[i + 1]);
+                if (renderBenchmarkOptions.durationSeconds <= 0.0)
+                {
+                    throw std::out_of_range("benchmarkDuration out of range");
+                }
+            }
+            catch (const std::invalid_argument&)
+            {
+                std::cerr << "Invalid value supplied for benchmarkDuration\n";
+                return -1;
+            }
+            catch (const std::out_of_range&)
+            {
+                std::cerr << "benchmarkDuration must be greater than 0\n";
+                return -1;
+            }
+            ++i;  // Skip next argument
+        }
+        else if (arg == "-benchmarkOutput")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "No value supplied for benchmarkOutput\n";
+                std::cerr << "Expected: -benchmarkOutput [filename]\n";
+                return -1;
+            }
+            renderBenchmarkOptions.outputFilename = argv[i + 1];
+            ++i;  // Skip next argument
+        }
         else
         {
             std::cerr << "Invalid argument: " << arg << "\n";
@@ -82,12 +455,69 @@ int main(int argc, char* argv[])
         }
     }
 
+    // Benchmarks create their own window, if they need one at all
+    if (!benchmarkName.empty())
+    {
+        renderBenchmarkOptions.numPlayers = numPlayers;
+        return Benchmarks::run(benchmarkName, renderBenchmarkOptions);
+    }
+
+    // Render a scripted match offscreen, without ever creating a visible window
+    if (!headlessOptions.screenshotFilename.empty() || !headlessOptions.goldenFilename.empty())
+    {
+        headlessEnabled = true;
+    }
+    if (headlessEnabled)
+    {
+        headlessOptions.numPlayers = numPlayers;
+        return Headless::run(headlessOptions);
+    }
+
+    StartupTimer startupTimer;
+
+    // Build the level
+    Levels::Level level;
+    try
+    {
+        if (levelFilename.empty())
+        {
+            level.size = World::defaultSize;
+            level.obstacles = Levels::makeLevel(levelName, World::defaultSize);
+        }
+        else
+        {
+            level = Levels::loadLevelFile(levelFilename);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+        return -1;
+    }
+    startupTimer.endPhase("level");
+
+    // Load the controls
+    InputMap inputMap;
+    if (!controlsFilename.empty())
+    {
+        try
+        {
+            inputMap = InputMap::loadFile(controlsFilename);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << "\n";
+            return -1;
+        }
+    }
+
     // Initialize GLFW
     if (!glfwInit())
     {
         std::cerr << "Failed to initialize GLFW\n";
         return -1;
     }
+    startupTimer.endPhase("GLFW init");
 
     // Prepare for window creation
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -131,16 +561,99 @@ int main(int argc, char* argv[])
         std::cerr << "Failed to initialize GLEW: " << glewGetErrorString(glewStatus) << "\n";
         return -1;
     }
+    startupTimer.endPhase("window and context");
 
     // Initialize shaders
     Shaders::initializeShaders();
+    startupTimer.endPhase("shaders");
 
     // Enable vsync
     glfwSwapInterval(vsyncEnabled ? 1 : 0);
 
     // Create the application and store a pointer to it in GLFW
-    Application app(window, numPlayers);
+    Application app(window, numPlayers, std::move(level));
     glfwSetWindowUserPointer(window, &app);
+    app.setNumBots(numBots);
+    if (gameMode != GameMode::Classic)
+    {
+        app.setGameMode(gameMode);
+    }
+    if (powerUpsEnabled)
+    {
+        app.setPowerUpsEnabled(true);
+    }
+    app.setInputMap(inputMap);
+
+    // Late latching relies on vsync to know when each frame will be shown
+    if (lateLatchEnabled && !vsyncEnabled)
+    {
+        std::cerr << "Ignoring lateLatch, since vsync is disabled\n";
+        lateLatchEnabled = false;
+    }
+    if (lateLatchEnabled)
+    {
+        // Frames queued by the driver would add back the latency we are trying to remove
+        if (maxFramesInFlight == 0)
+        {
+            maxFramesInFlight = 1;
+        }
+        app.setFramePacingEnabled(true);
+    }
+    app.setMaxFramesInFlight(maxFramesInFlight);
+    if (!latencyReportFilename.empty())
+    {
+        app.enableInputLatencyTracking();
+    }
+
+    // Large levels don't fit on screen, so follow the players by default
+    if (cameraModeName.empty())
+    {
+        cameraModeName = levelFilename.empty() ? "world" : "group";
+    }
+    if (cameraModeName == "group")
+    {
+        app.setCameraMode(CameraMode::Group);
+    }
+    else if (cameraModeName == "player")
+    {
+        app.setCameraMode(CameraMode::Player);
+    }
+    if (splitScreenEnabled)
+    {
+        app.setSplitScreen(true);
+    }
+
+    // Add glow to bright effects, if requested
+    if (bloomEnabled)
+    {
+        try
+        {
+            app.setBloomEnabled(true);
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << e.what() << "\n";
+            glfwTerminate();
+            return -1;
+        }
+    }
+
+    // Publish the world state for external tools, if requested
+    if (!worldFeedName.empty())
+    {
+        try
+        {
+            app.enableWorldFeed(worldFeedName);
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << e.what() << "\n";
+            glfwTerminate();
+            return -1;
+        }
+    }
+
+    startupTimer.endPhase("application");
 
     // Make the window visible
     glfwShowWindow(window);
@@ -150,10 +663,40 @@ int main(int argc, char* argv[])
     {
         app.toggleFullscreen();
     }
+    startupTimer.endPhase("show window");
+
+    // Start recording once the window has reached its final size
+    if (!recordFilename.empty())
+    {
+        try
+        {
+            app.startRecording(recordFilename);
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << e.what() << "\n";
+            glfwTerminate();
+            return -1;
+        }
+    }
+    startupTimer.finish();
 
     // Run the application
     app.run();
 
+    // Save the input latency for the whole session
+    if (const InputLatencyTracker* inputLatency = app.getInputLatency())
+    {
+        try
+        {
+            inputLatency->writeReport(latencyReportFilename);
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << e.what() << "\n";
+        }
+    }
+
     // Exit cleanly
     glfwTerminate();
 
@@ -0,0 +1,100 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <stdexcept>
+
+////////////////////////////////////////////////////////////////////////////////
+// Windows
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filename)
+{
+    fileHandle = CreateFileA(
+            filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(fileHandle);
+        throw std::runtime_error("Failed to read file size: " + filename);
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle)
+    {
+        CloseHandle(fileHandle);
+        throw std::runtime_error("Failed to map file: " + filename);
+    }
+
+    data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (!data)
+    {
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        throw std::runtime_error("Failed to map file: " + filename);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    UnmapViewOfFile(data);
+    CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// POSIX
+////////////////////////////////////////////////////////////////////////////////
+
+#else
+
+MappedFile::MappedFile(const std::string& filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1 || fileStat.st_size == 0)
+    {
+        close(fd);
+        throw std::runtime_error("Failed to read file size: " + filename);
+    }
+    size = static_cast<size_t>(fileStat.st_size);
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping keeps the file open, so we no longer need the descriptor
+    close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        throw std::runtime_error("Failed to map file: " + filename);
+    }
+    data = static_cast<const uint8_t*>(mapping);
+}
+
+MappedFile::~MappedFile()
+{
+    munmap(const_cast<uint8_t*>(data), size);
+}
+
+#endif
@@ -0,0 +1,37 @@
+#include "OffscreenTarget.h"
+
+#include <stdexcept>
+
+OffscreenTarget::OffscreenTarget(int width, int height)
+    : width(width)
+    , height(height)
+{
+    glGenRenderbuffers(1, &colorRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRenderbuffer);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteRenderbuffers(1, &colorRenderbuffer);
+        throw std::runtime_error("Failed to create offscreen framebuffer");
+    }
+}
+
+OffscreenTarget::~OffscreenTarget()
+{
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &colorRenderbuffer);
+}
+
+void OffscreenTarget::bind() const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+}
@@ -0,0 +1,112 @@
+#include "ParticleRenderable.h"
+
+#include <algorithm>  // min
+#include <cstdint>
+
+#include "ParticleSystem.h"
+#include "Shaders.h"
+
+namespace {
+
+/**
+ * Replaces the contents of a buffer.
+ *
+ * The old storage is orphaned first, so that we never wait for the GPU to finish drawing last frame's particles.
+ */
+void uploadBuffer(GLuint vbo, GLsizeiptr capacityBytes, GLsizeiptr sizeBytes, const void* data)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, capacityBytes, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeBytes, data);
+}
+
+}  // namespace
+
+ParticleRenderable::ParticleRenderable(int maxParticles)
+    : maxParticles(maxParticles)
+{
+    // Generate VAO
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    // Create the quad shared by every particle, drawn using GL_TRIANGLE_FAN
+    static constexpr GLfloat corners[numCorners * numCornerDimensions] = {
+        -0.5f, -0.5f,  //
+        0.5f,  -0.5f,  //
+        0.5f,  0.5f,   //
+        -0.5f, 0.5f    //
+    };
+    glGenBuffers(1, &cornerVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, cornerVbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glVertexAttribPointer(Shaders::vertexAttribIndex, numCornerDimensions, GL_FLOAT, GL_FALSE, 0, nullptr);
+    glEnableVertexAttribArray(Shaders::vertexAttribIndex);
+
+    // Create one buffer per particle array, advancing once per instance
+    glGenBuffers(NumInstanceBuffers, instanceVbos);
+    const GLint floatAttribIndices[] = {
+        Shaders::particlePosXAttribIndex,
+        Shaders::particlePosYAttribIndex,
+        Shaders::particleAgeAttribIndex,
+        Shaders::particleLifetimeAttribIndex,
+        Shaders::particleSizeAttribIndex,
+    };
+    for (int i = PosXBuffer; i <= SizeBuffer; ++i)
+    {
+        GLint attribIndex = floatAttribIndices[i];
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVbos[i]);
+        glBufferData(GL_ARRAY_BUFFER, maxParticles * sizeof(GLfloat), nullptr, GL_STREAM_DRAW);
+        glVertexAttribPointer(attribIndex, 1, GL_FLOAT, GL_FALSE, 0, nullptr);
+        glVertexAttribDivisor(attribIndex, 1);
+        glEnableVertexAttribArray(attribIndex);
+    }
+
+    // Colours are packed into 4 bytes
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbos[ColorBuffer]);
+    glBufferData(GL_ARRAY_BUFFER, maxParticles * sizeof(uint32_t), nullptr, GL_STREAM_DRAW);
+    glVertexAttribPointer(Shaders::colorAttribIndex, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, nullptr);
+    glVertexAttribDivisor(Shaders::colorAttribIndex, 1);
+    glEnableVertexAttribArray(Shaders::colorAttribIndex);
+
+    glBindVertexArray(0);
+}
+
+ParticleRenderable::~ParticleRenderable()
+{
+    glDeleteBuffers(NumInstanceBuffers, instanceVbos);
+    glDeleteBuffers(1, &cornerVbo);
+    glDeleteVertexArrays(1, &vao);
+}
+
+void ParticleRenderable::update(const ParticleSystem& particles)
+{
+    numParticles = std::min(particles.getCount(), maxParticles);
+    if (numParticles == 0)
+    {
+        return;
+    }
+
+    GLsizeiptr floatCapacity = maxParticles * sizeof(GLfloat);
+    GLsizeiptr floatSize = numParticles * sizeof(GLfloat);
+    uploadBuffer(instanceVbos[PosXBuffer], floatCapacity, floatSize, particles.getPosX());
+    uploadBuffer(instanceVbos[PosYBuffer], floatCapacity, floatSize, particles.getPosY());
+    uploadBuffer(instanceVbos[AgeBuffer], floatCapacity, floatSize, particles.getAge());
+    uploadBuffer(instanceVbos[LifetimeBuffer], floatCapacity, floatSize, particles.getLifetime());
+    uploadBuffer(instanceVbos[SizeBuffer], floatCapacity, floatSize, particles.getSize());
+
+    GLsizeiptr colorCapacity = maxParticles * sizeof(uint32_t);
+    GLsizeiptr colorSize = numParticles * sizeof(uint32_t);
+    uploadBuffer(instanceVbos[ColorBuffer], colorCapacity, colorSize, particles.getColor());
+}
+
+void ParticleRenderable::render() const
+{
+    if (numParticles == 0)
+    {
+        return;
+    }
+
+    glBindVertexArray(vao);
+    glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, numCorners, numParticles);
+    glBindVertexArray(0);
+}
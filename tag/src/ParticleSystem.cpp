@@ -0,0 +1,162 @@
+#include "ParticleSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TAG_PARTICLES_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>  // min
+#include <cmath>
+
+namespace {
+
+constexpr float pi = 3.14159265f;
+
+}  // namespace
+
+ParticleSystem::ParticleSystem(int capacity)
+    : capacity(capacity)
+    , posX(capacity)
+    , posY(capacity)
+    , velX(capacity)
+    , velY(capacity)
+    , age(capacity)
+    , lifetime(capacity)
+    , size(capacity)
+    , color(capacity)
+    , directions(numDirections)
+{
+    for (int i = 0; i < numDirections; ++i)
+    {
+        float angle = 2.f * pi * i / numDirections;
+        directions[i] = { std::cos(angle), std::sin(angle) };
+    }
+}
+
+void ParticleSystem::emit(const ParticleBurst& burst)
+{
+    int numToEmit = std::min(burst.count, capacity - count);
+    uint32_t packedColor = burst.color.pack();
+
+    for (int i = count; i < count + numToEmit; ++i)
+    {
+        // Emitting is dominated by random number generation, so we use every bit we generate
+        uint32_t random1 = nextRandom();
+        uint32_t random2 = nextRandom();
+        glm::vec2 dir = directions[random1 & (numDirections - 1)];
+        glm::vec2 spawnDir = directions[(random1 >> 10) & (numDirections - 1)];
+        float speedRatio = static_cast<float>(random1 >> 20) * (1.f / 4096.f);
+        float spawnRatio = static_cast<float>(random2 & 0xFFFF) * (1.f / 65536.f);
+        float lifetimeRatio = static_cast<float>(random2 >> 16) * (1.f / 65536.f);
+
+        float spawnDistance = std::sqrt(spawnRatio) * burst.spawnRadius;
+        float speed = burst.minSpeed + speedRatio * (burst.maxSpeed - burst.minSpeed);
+
+        posX[i] = burst.pos.x + spawnDir.x * spawnDistance;
+        posY[i] = burst.pos.y + spawnDir.y * spawnDistance;
+        velX[i] = dir.x * speed;
+        velY[i] = dir.y * speed;
+        age[i] = 0.f;
+        lifetime[i] = burst.minLifetime + lifetimeRatio * (burst.maxLifetime - burst.minLifetime);
+        size[i] = burst.size;
+        color[i] = packedColor;
+    }
+
+    count += numToEmit;
+}
+
+void ParticleSystem::update(float deltaTime)
+{
+    int first = 0;
+
+#ifdef TAG_PARTICLES_SSE2
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 dragFactor = _mm_set1_ps(std::max(1.f - drag * deltaTime, 0.f));
+    const __m128 gravityX = _mm_set1_ps(gravity.x * deltaTime);
+    const __m128 gravityY = _mm_set1_ps(gravity.y * deltaTime);
+
+    for (; first + 4 <= count; first += 4)
+    {
+        __m128 vx = _mm_loadu_ps(&velX[first]);
+        __m128 vy = _mm_loadu_ps(&velY[first]);
+        vx = _mm_mul_ps(_mm_add_ps(vx, gravityX), dragFactor);
+        vy = _mm_mul_ps(_mm_add_ps(vy, gravityY), dragFactor);
+        _mm_storeu_ps(&velX[first], vx);
+        _mm_storeu_ps(&velY[first], vy);
+
+        __m128 px = _mm_loadu_ps(&posX[first]);
+        __m128 py = _mm_loadu_ps(&posY[first]);
+        _mm_storeu_ps(&posX[first], _mm_add_ps(px, _mm_mul_ps(vx, dt)));
+        _mm_storeu_ps(&posY[first], _mm_add_ps(py, _mm_mul_ps(vy, dt)));
+
+        __m128 a = _mm_loadu_ps(&age[first]);
+        _mm_storeu_ps(&age[first], _mm_add_ps(a, dt));
+    }
+#endif
+
+    // Anything left over (or everything, without SIMD)
+    integrateScalar(first, count, deltaTime);
+
+    removeExpired();
+}
+
+void ParticleSystem::clear()
+{
+    count = 0;
+}
+
+bool ParticleSystem::isSimdEnabled()
+{
+#ifdef TAG_PARTICLES_SSE2
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ParticleSystem::integrateScalar(int first, int last, float deltaTime)
+{
+    const float dragFactor = std::max(1.f - drag * deltaTime, 0.f);
+
+    for (int i = first; i < last; ++i)
+    {
+        velX[i] = (velX[i] + gravity.x * deltaTime) * dragFactor;
+        velY[i] = (velY[i] + gravity.y * deltaTime) * dragFactor;
+        posX[i] += velX[i] * deltaTime;
+        posY[i] += velY[i] * deltaTime;
+        age[i] += deltaTime;
+    }
+}
+
+void ParticleSystem::removeExpired()
+{
+    int i = 0;
+    while (i < count)
+    {
+        if (age[i] < lifetime[i])
+        {
+            ++i;
+            continue;
+        }
+
+        // Swap-remove: fill the gap with the last particle, and check it next
+        --count;
+        posX[i] = posX[count];
+        posY[i] = posY[count];
+        velX[i] = velX[count];
+        velY[i] = velY[count];
+        age[i] = age[count];
+        lifetime[i] = lifetime[count];
+        size[i] = size[count];
+        color[i] = color[count];
+    }
+}
+
+uint32_t ParticleSystem::nextRandom()
+{
+    // xorshift32
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
@@ -1,6 +1,6 @@
 #include "Player.h"
 
-#include <algorithm>  //max
+#include <algorithm>  // max, min
 
 #include "TimeUtils.h"
 #include "World.h"
@@ -11,13 +11,18 @@ Player::Player(int playerId, World* world, glm::vec2 pos, Color col)
     , rect(pos, Player::extents)
     , col(col)
 {
+    trail[0] = pos;
 }
 
+template <typename Mode>
 void Player::tick()
 {
     glm::vec2 positionDelta = calculatePositionDelta(TimeUtils::frameTime);
     setPos(rect.pos + positionDelta);
 
+    ++numTicks;
+    trail[numTicks % trailLength] = rect.pos;
+
     Player* taggedPlayer = world->getTaggedPlayer();
     if (!taggedPlayer)
     {
@@ -25,18 +30,20 @@ void Player::tick()
         return;
     }
 
-    if (taggedPlayer == this)
+    bool isTagged = taggedPlayer == this;
+    if (Mode::accelerates(isTagged))
     {
-        // Speed up when tagged
         speed = std::min(speed + acceleration * TimeUtils::frameTime, maxSpeed);
     }
-    else
+    if (Mode::countsDown(isTagged))
     {
-        // Count down when not tagged
         timeRemaining = std::max(timeRemaining - TimeUtils::frameTime, 0.f);
     }
 }
 
+template void Player::tick<GameModes::Classic>();
+template void Player::tick<GameModes::Inverted>();
+
 void Player::endTick()
 {
     intersectingPlayersLastFrame = intersectingPlayers;
@@ -45,7 +52,8 @@ void Player::endTick()
 
 glm::vec2 Player::calculatePositionDelta(float delta) const
 {
-    return dirVector * speed * delta;
+    float boost = speedBoosted ? speedBoostMultiplier : 1.f;
+    return dirVector * speed * boost * delta;
 }
 
 void Player::setDir(Direction newDir)
@@ -60,7 +68,11 @@ void Player::setDir(Direction newDir)
 
     dir = newDir;
 
-    if (dir == Direction::UP)
+    if (dir == Direction::NONE)
+    {
+        dirVector = { 0.f, 0.f };
+    }
+    else if (dir == Direction::UP)
     {
         dirVector = { 0.f, -1.f };
     }
@@ -80,7 +92,7 @@ void Player::setDir(Direction newDir)
 
 void Player::setPos(const glm::vec2& newPos)
 {
-    rect.pos = world->keepInBounds(newPos, rect.extents);
+    rect.pos = world->resolveMovement(rect.pos, newPos, rect.extents);
 }
 
 void Player::resetSpeed()
@@ -103,7 +115,12 @@ float Player::getTimeRemainingRatio() const
     return timeRemaining / maxTime;
 }
 
-bool Player::hasWon() const
+glm::vec2 Player::getTrailPos(int ticksAgo) const
+{
+    return trail[(numTicks - ticksAgo) % trailLength];
+}
+
+int Player::getTrailSize() const
 {
-    return timeRemaining == 0.f;
+    return static_cast<int>(std::min(numTicks + 1, static_cast<uint32_t>(trailLength)));
 }
@@ -0,0 +1,39 @@
+#include "ScreenShake.h"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>  // max
+#include <cmath>
+
+void ScreenShake::tick(float dt)
+{
+    // Semi-implicit Euler, which stays stable for a stiff spring at our tick rate
+    glm::vec2 acceleration = -stiffness * offset - damping * velocity;
+    velocity += acceleration * dt;
+    offset += velocity * dt;
+
+    float distance = glm::length(offset);
+    if (distance > maxOffset)
+    {
+        offset *= maxOffset / distance;
+    }
+
+    flashIntensity *= std::exp(-flashDecay * dt);
+}
+
+void ScreenShake::reset()
+{
+    offset = { 0.f, 0.f };
+    velocity = { 0.f, 0.f };
+    flashIntensity = 0.f;
+}
+
+void ScreenShake::kick(glm::vec2 impulse)
+{
+    velocity += impulse;
+}
+
+void ScreenShake::flash(float intensity)
+{
+    flashIntensity = std::max(flashIntensity, intensity);
+}
@@ -0,0 +1,99 @@
+#include "ScriptedMatch.h"
+
+#include <glm/vec2.hpp>
+
+#include <iterator>  // size
+
+#include "Levels.h"
+#include "Player.h"
+#include "TimeUtils.h"
+
+namespace {
+
+/** Directions each player cycles through, starting at a different point for each player. */
+constexpr Direction turnSequence[] = { Direction::RIGHT, Direction::DOWN, Direction::LEFT, Direction::UP };
+
+}  // namespace
+
+ScriptedMatch::ScriptedMatch(int numPlayers)
+    : world(World::defaultSize, numPlayers, Levels::makePillars(World::defaultSize))
+    , cameras(1, Camera(world.getSize()))
+{
+    world.setTaggedPlayer(&world.getPlayers()[0]);
+}
+
+void ScriptedMatch::tick()
+{
+    const int tickIndex = tickCount++;
+
+    // Effects keep playing after the game has ended
+    effects.tick(world);
+    screenShake.tick(TimeUtils::frameTime);
+
+    if (!playing)
+    {
+        return;
+    }
+
+    for (Camera& camera : cameras)
+    {
+        camera.update(world);
+    }
+
+    std::vector<Player>& players = world.getPlayers();
+    for (Player& player : players)
+    {
+        if (tickIndex % ticksPerTurn == 0)
+        {
+            int turn = tickIndex / ticksPerTurn + player.getPlayerId();
+            player.setDir(turnSequence[turn % static_cast<int>(std::size(turnSequence))]);
+        }
+
+        // Scripted matches always use the classic rules, so golden images stay valid
+        player.tick<GameModes::Classic>();
+
+        if (player.isOutOfTime())
+        {
+            player.setWon();
+            effects.onWin(player);
+            playing = false;
+            return;
+        }
+    }
+
+    if (tickIndex > 0 && tickIndex % ticksPerTag == 0)
+    {
+        passTag();
+    }
+
+    for (Player& player : players)
+    {
+        player.endTick();
+    }
+}
+
+void ScriptedMatch::restart()
+{
+    world.reset();
+    world.setTaggedPlayer(&world.getPlayers()[0]);
+    effects.reset();
+    screenShake.reset();
+    for (Camera& camera : cameras)
+    {
+        camera.snap(world);
+    }
+
+    tickCount = 0;
+    playing = true;
+}
+
+void ScriptedMatch::passTag()
+{
+    std::vector<Player>& players = world.getPlayers();
+    Player& tagger = *world.getTaggedPlayer();
+    Player& taggedPlayer = players[(tagger.getPlayerId() + 1) % players.size()];
+
+    tagger.resetSpeed();
+    world.setTaggedPlayer(&taggedPlayer);
+    effects.onTag(tagger, taggedPlayer);
+}
@@ -0,0 +1,211 @@
+#include "ShaderCache.h"
+
+#include <cstdio>  // snprintf
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ShaderCache {
+
+namespace {
+
+/** Identifies a cached program binary ("TAGS"). */
+constexpr uint32_t magic = 0x53474154;
+
+/** Incremented whenever the file layout changes. */
+constexpr uint32_t fileVersion = 1;
+
+/** Largest binary that will be read back, so that a corrupt length cannot trigger a huge allocation. */
+constexpr uint32_t maxBinaryLength = 64 * 1024 * 1024;
+
+/** Directory in which binaries are stored, relative to the working directory. */
+const std::filesystem::path cacheDir = "shadercache";
+
+struct FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t binaryFormat;
+    uint32_t binaryLength;
+};
+
+int numHits = 0;
+int numMisses = 0;
+
+/**
+ * Feeds a string into a 64-bit FNV-1a hash, including its terminator so that adjacent strings cannot run together.
+ */
+uint64_t hashString(uint64_t hash, const char* str)
+{
+    constexpr uint64_t fnvPrime = 0x100000001b3ull;
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(str ? str : "");
+    do
+    {
+        hash ^= *bytes;
+        hash *= fnvPrime;
+    } while (*bytes++ != '\0');
+
+    return hash;
+}
+
+bool isSupported()
+{
+    static const bool supported = [] {
+        if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary)
+        {
+            return false;
+        }
+
+        // Some drivers expose the extension without supporting any formats
+        GLint numFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+        return numFormats > 0;
+    }();
+
+    return supported;
+}
+
+std::filesystem::path getPath(uint64_t key)
+{
+    char filename[32];
+    std::snprintf(filename, sizeof(filename), "%016llx.bin", static_cast<unsigned long long>(key));
+    return cacheDir / filename;
+}
+
+}  // namespace
+
+uint64_t makeKey(const char* vertShaderSource, const char* fragShaderSource)
+{
+    constexpr uint64_t fnvOffsetBasis = 0xcbf29ce484222325ull;
+
+    uint64_t hash = fnvOffsetBasis;
+    hash = hashString(hash, vertShaderSource);
+    hash = hashString(hash, fragShaderSource);
+    hash = hashString(hash, reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+    hash = hashString(hash, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    hash = hashString(hash, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+    return hash;
+}
+
+void prepareForLink(GLuint programId)
+{
+    if (isSupported())
+    {
+        glProgramParameteri(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+}
+
+GLuint load(uint64_t key)
+{
+    if (!isSupported())
+    {
+        ++numMisses;
+        return 0;
+    }
+
+    const std::filesystem::path path = getPath(key);
+    std::ifstream file(path, std::ios::binary);
+    FileHeader header {};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != magic
+            || header.version != fileVersion || header.key != key)
+    {
+        ++numMisses;
+        return 0;
+    }
+
+    // Don't trust the stored length until it matches what is actually in the file
+    std::error_code error;
+    const std::uintmax_t fileSize = std::filesystem::file_size(path, error);
+    if (error || header.binaryLength == 0 || header.binaryLength > maxBinaryLength
+            || header.binaryLength > fileSize - sizeof(header))
+    {
+        ++numMisses;
+        return 0;
+    }
+
+    std::vector<char> binary(header.binaryLength);
+    if (!file.read(binary.data(), binary.size()))
+    {
+        ++numMisses;
+        return 0;
+    }
+
+    // The driver may still reject the binary, e.g. if it has changed without changing its version string
+    GLuint programId = glCreateProgram();
+    glProgramBinary(programId, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(programId, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE)
+    {
+        glDeleteProgram(programId);
+        ++numMisses;
+        return 0;
+    }
+
+    ++numHits;
+    return programId;
+}
+
+void save(uint64_t key, GLuint programId)
+{
+    if (!isSupported())
+    {
+        return;
+    }
+
+    GLint binaryLength = 0;
+    glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0)
+    {
+        return;
+    }
+
+    std::vector<char> binary(binaryLength);
+    GLenum binaryFormat = 0;
+    glGetProgramBinary(programId, binaryLength, nullptr, &binaryFormat, binary.data());
+
+    std::error_code error;
+    std::filesystem::create_directories(cacheDir, error);
+    if (error)
+    {
+        return;
+    }
+
+    // Write to a temporary file first, so that a crash can never leave a truncated binary behind
+    std::filesystem::path path = getPath(key);
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    bool written = false;
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        FileHeader header { magic, fileVersion, key, binaryFormat, static_cast<uint32_t>(binaryLength) };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), binary.size());
+        written = static_cast<bool>(file);
+    }
+
+    if (written)
+    {
+        std::filesystem::rename(tempPath, path, error);
+    }
+    else
+    {
+        std::filesystem::remove(tempPath, error);
+    }
+}
+
+int getNumHits()
+{
+    return numHits;
+}
+
+int getNumMisses()
+{
+    return numMisses;
+}
+
+}  // namespace ShaderCache
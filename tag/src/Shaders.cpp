@@ -1,8 +1,11 @@
 #include "Shaders.h"
 
+#include <cstdint>
 #include <iostream>
 #include <stdexcept>
 
+#include "ShaderCache.h"
+
 namespace Shaders {
 
 ///////////////////////////////////////////////////////////////////////////
@@ -92,6 +95,16 @@ bool Shader::validateUniform(GLint uniformLoc, std::string uniformName) const
     return true;
 }
 
+bool Shader::validateUniformBlock(GLuint blockIndex, std::string blockName) const
+{
+    if (blockIndex == GL_INVALID_INDEX)
+    {
+        std::cout << "Could not locate uniform block " << blockName << " for shader " << getName() << "\n";
+        return false;
+    }
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // BoxShader
 ///////////////////////////////////////////////////////////////////////////
@@ -103,26 +116,95 @@ const char* boxVertShaderSource = R"END_SHADER(
 
 uniform mat4 view_proj_matrix;
 
+// How much this draw is affected by screen shake (0-1)
+uniform float shake_weight;
+
+// Multiplied into every box in this draw, so that static batches can be recoloured without re-uploading them
+uniform vec4 tint;
+
+layout(std140) uniform FrameUniforms {
+    float time;
+    float flash_intensity;
+    vec2 shake_offset;
+};
+
 layout(location = 0) in vec2 in_vertex;
 layout(location = 1) in vec4 in_color;
+layout(location = 2) in vec4 in_shape;
+layout(location = 3) in vec4 in_style;
 
 out vec4 color;
+out vec2 local_pos;
+flat out vec2 half_size;
+flat out vec4 style;
 
 void main() {
-    gl_Position = view_proj_matrix * vec4(in_vertex.x, in_vertex.y, 0.f, 1.f);
-    color = in_color;
+    vec2 pos = in_vertex + shake_offset * shake_weight;
+    gl_Position = view_proj_matrix * vec4(pos.x, pos.y, 0.f, 1.f);
+    color = in_color * tint;
+    local_pos = in_shape.xy;
+    half_size = in_shape.zw;
+    style = in_style;
 }
 )END_SHADER";
 
 const char* boxFragShaderSource = R"END_SHADER(
 #version 330 core
 
+// How much this draw is affected by the screen flash (0-1)
+uniform float flash_weight;
+
+layout(std140) uniform FrameUniforms {
+    float time;
+    float flash_intensity;
+    vec2 shake_offset;
+};
+
 in vec4 color;
+in vec2 local_pos;
+flat in vec2 half_size;
+flat in vec4 style;
 
 out vec4 frag_color;
 
+const float pulse_speed = 6.f;
+const float max_glow_alpha = 0.6f;
+
+// Signed distance from a rounded box centred on the origin; negative inside
+float box_distance(vec2 pos, vec2 half_size, float radius) {
+    vec2 q = abs(pos) - half_size + radius;
+    return length(max(q, 0.f)) + min(max(q.x, q.y), 0.f) - radius;
+}
+
 void main() {
-    frag_color = color;
+    float corner_radius = min(style.x, min(half_size.x, half_size.y));
+    float outline_width = style.y;
+    float glow_radius = style.z;
+    float pulse = style.w * (0.5f + 0.5f * sin(time * pulse_speed));
+
+    float dist = box_distance(local_pos, half_size, corner_radius);
+    float aa = fwidth(dist);
+
+    // Antialias outwards from the edge, so that plain boxes stay solid right up to their edges
+    float fill = 1.f - smoothstep(0.f, aa, dist);
+    if (outline_width > 0.f) {
+        fill *= smoothstep(-outline_width - aa, -outline_width, dist);
+    }
+
+    float glow = 0.f;
+    if (glow_radius > 0.f) {
+        float falloff = 1.f - clamp(dist / glow_radius, 0.f, 1.f);
+        glow = falloff * falloff * max_glow_alpha * (0.5f + 0.5f * pulse);
+    }
+
+    float alpha = max(fill, glow);
+    if (alpha <= 0.f) {
+        discard;
+    }
+
+    vec3 rgb = mix(color.rgb, vec3(1.f), 0.35f * pulse * fill);
+    rgb = mix(rgb, vec3(1.f), flash_intensity * flash_weight);
+    frag_color = vec4(rgb, color.a * alpha);
 }
 )END_SHADER";
 
@@ -135,11 +217,17 @@ void BoxShader::init()
     boxShader.vertexAttribLoc = glGetAttribLocation(programId, "in_vertex");
     boxShader.colorAttribLoc = glGetAttribLocation(programId, "in_color");
     boxShader.viewProjMatrixUniformLoc = glGetUniformLocation(programId, "view_proj_matrix");
+    boxShader.shakeWeightUniformLoc = glGetUniformLocation(programId, "shake_weight");
+    boxShader.tintUniformLoc = glGetUniformLocation(programId, "tint");
+    boxShader.flashWeightUniformLoc = glGetUniformLocation(programId, "flash_weight");
+    boxShader.frameUniformsBlockIndex = glGetUniformBlockIndex(programId, "FrameUniforms");
 
     if (!boxShader.isValid())
     {
         throw std::runtime_error("Failed to create BoxShader");
     }
+
+    glUniformBlockBinding(programId, boxShader.frameUniformsBlockIndex, frameUniformsBinding);
 }
 
 bool BoxShader::isValid() const
@@ -152,9 +240,376 @@ bool BoxShader::isValid() const
     }
 
     // Validate vertex attributes / uniforms
-    return validateVertexAttribute(vertexAttribLoc, "in_vertex")     //
-            && validateVertexAttribute(vertexAttribLoc, "in_color")  //
-            && validateUniform(viewProjMatrixUniformLoc, "view_proj_matrix");
+    return validateVertexAttribute(vertexAttribLoc, "in_vertex")              //
+            && validateVertexAttribute(vertexAttribLoc, "in_color")           //
+            && validateUniform(viewProjMatrixUniformLoc, "view_proj_matrix")  //
+            && validateUniform(shakeWeightUniformLoc, "shake_weight")         //
+            && validateUniform(tintUniformLoc, "tint")                        //
+            && validateUniform(flashWeightUniformLoc, "flash_weight")         //
+            && validateUniformBlock(frameUniformsBlockIndex, "FrameUniforms");
+}
+
+///////////////////////////////////////////////////////////////////////////
+// ParticleShader
+///////////////////////////////////////////////////////////////////////////
+
+ParticleShader particleShader;
+
+const char* particleVertShaderSource = R"END_SHADER(
+#version 330 core
+
+uniform mat4 view_proj_matrix;
+
+layout(std140) uniform FrameUniforms {
+    float time;
+    float flash_intensity;
+    vec2 shake_offset;
+};
+
+// Per-vertex
+layout(location = 0) in vec2 in_corner;
+
+// Per-instance
+layout(location = 1) in vec4 in_color;
+layout(location = 2) in float in_pos_x;
+layout(location = 3) in float in_pos_y;
+layout(location = 4) in float in_age;
+layout(location = 5) in float in_lifetime;
+layout(location = 6) in float in_size;
+
+out vec4 color;
+
+void main() {
+    // Shrink and fade out over the particle's lifetime
+    float life_ratio = clamp(1.f - in_age / in_lifetime, 0.f, 1.f);
+    vec2 pos = vec2(in_pos_x, in_pos_y) + in_corner * in_size * (0.5f + 0.5f * life_ratio) + shake_offset;
+
+    gl_Position = view_proj_matrix * vec4(pos.x, pos.y, 0.f, 1.f);
+    color = vec4(in_color.rgb, in_color.a * life_ratio);
+}
+)END_SHADER";
+
+const char* particleFragShaderSource = R"END_SHADER(
+#version 330 core
+
+in vec4 color;
+
+out vec4 frag_color;
+
+void main() {
+    frag_color = color;
+}
+)END_SHADER";
+
+void ParticleShader::init()
+{
+    GLuint programId = createShader(particleVertShaderSource, particleFragShaderSource);
+
+    particleShader = ParticleShader();
+    particleShader.programId = programId;
+    particleShader.viewProjMatrixUniformLoc = glGetUniformLocation(programId, "view_proj_matrix");
+    particleShader.frameUniformsBlockIndex = glGetUniformBlockIndex(programId, "FrameUniforms");
+
+    if (!particleShader.isValid())
+    {
+        throw std::runtime_error("Failed to create ParticleShader");
+    }
+
+    glUniformBlockBinding(programId, particleShader.frameUniformsBlockIndex, frameUniformsBinding);
+}
+
+bool ParticleShader::isValid() const
+{
+    // Validate program ID
+    if (programId == 0)
+    {
+        printf("Could not generate program ID\n");
+        return false;
+    }
+
+    // Validate uniforms
+    return validateUniform(viewProjMatrixUniformLoc, "view_proj_matrix")  //
+            && validateUniformBlock(frameUniformsBlockIndex, "FrameUniforms");
+}
+
+///////////////////////////////////////////////////////////////////////////
+// TrailShader
+///////////////////////////////////////////////////////////////////////////
+
+TrailShader trailShader;
+
+const char* trailVertShaderSource = R"END_SHADER(
+#version 330 core
+
+uniform mat4 view_proj_matrix;
+uniform uint current_tick;
+uniform float fade_ticks;
+
+layout(std140) uniform FrameUniforms {
+    float time;
+    float flash_intensity;
+    vec2 shake_offset;
+};
+
+layout(location = 0) in vec2 in_vertex;
+layout(location = 1) in vec4 in_color;
+layout(location = 2) in uint in_tick;
+
+out vec4 color;
+
+void main() {
+    // Unsigned subtraction keeps working when the tick counter wraps
+    float age = float(current_tick - in_tick);
+    float fade = clamp(1.f - age / fade_ticks, 0.f, 1.f);
+
+    vec2 pos = in_vertex + shake_offset;
+    gl_Position = view_proj_matrix * vec4(pos.x, pos.y, 0.f, 1.f);
+    color = vec4(in_color.rgb, in_color.a * fade);
+}
+)END_SHADER";
+
+const char* trailFragShaderSource = R"END_SHADER(
+#version 330 core
+
+in vec4 color;
+
+out vec4 frag_color;
+
+void main() {
+    frag_color = color;
+}
+)END_SHADER";
+
+void TrailShader::init()
+{
+    GLuint programId = createShader(trailVertShaderSource, trailFragShaderSource);
+
+    trailShader = TrailShader();
+    trailShader.programId = programId;
+    trailShader.viewProjMatrixUniformLoc = glGetUniformLocation(programId, "view_proj_matrix");
+    trailShader.currentTickUniformLoc = glGetUniformLocation(programId, "current_tick");
+    trailShader.fadeTicksUniformLoc = glGetUniformLocation(programId, "fade_ticks");
+    trailShader.frameUniformsBlockIndex = glGetUniformBlockIndex(programId, "FrameUniforms");
+
+    if (!trailShader.isValid())
+    {
+        throw std::runtime_error("Failed to create TrailShader");
+    }
+
+    glUniformBlockBinding(programId, trailShader.frameUniformsBlockIndex, frameUniformsBinding);
+}
+
+bool TrailShader::isValid() const
+{
+    // Validate program ID
+    if (programId == 0)
+    {
+        printf("Could not generate program ID\n");
+        return false;
+    }
+
+    // Validate uniforms
+    return validateUniform(viewProjMatrixUniformLoc, "view_proj_matrix")  //
+            && validateUniform(currentTickUniformLoc, "current_tick")     //
+            && validateUniform(fadeTicksUniformLoc, "fade_ticks")         //
+            && validateUniformBlock(frameUniformsBlockIndex, "FrameUniforms");
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Post-process shaders
+///////////////////////////////////////////////////////////////////////////
+
+const char* fullscreenVertShaderSource = R"END_SHADER(
+#version 330 core
+
+out vec2 uv;
+
+void main() {
+    // One triangle that covers the whole screen, generated from the vertex index
+    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    uv = pos;
+    gl_Position = vec4(pos * 2.f - 1.f, 0.f, 1.f);
+}
+)END_SHADER";
+
+///////////////////////////////////////////////////////////////////////////
+// BrightPassShader
+///////////////////////////////////////////////////////////////////////////
+
+BrightPassShader brightPassShader;
+
+const char* brightPassFragShaderSource = R"END_SHADER(
+#version 330 core
+
+uniform sampler2D source;
+uniform float threshold;
+uniform float knee;
+
+in vec2 uv;
+
+out vec4 frag_color;
+
+void main() {
+    vec3 color = texture(source, uv).rgb;
+    float brightness = max(color.r, max(color.g, color.b));
+
+    // Quadratic soft knee, so that colours near the threshold fade in rather than popping
+    float soft = clamp(brightness - threshold + knee, 0.f, 2.f * knee);
+    soft = soft * soft / (4.f * knee + 0.0001f);
+    float contribution = max(soft, brightness - threshold) / max(brightness, 0.0001f);
+
+    frag_color = vec4(color * contribution, 1.f);
+}
+)END_SHADER";
+
+void BrightPassShader::init()
+{
+    GLuint programId = createShader(fullscreenVertShaderSource, brightPassFragShaderSource);
+
+    brightPassShader = BrightPassShader();
+    brightPassShader.programId = programId;
+    brightPassShader.sourceUniformLoc = glGetUniformLocation(programId, "source");
+    brightPassShader.thresholdUniformLoc = glGetUniformLocation(programId, "threshold");
+    brightPassShader.kneeUniformLoc = glGetUniformLocation(programId, "knee");
+
+    if (!brightPassShader.isValid())
+    {
+        throw std::runtime_error("Failed to create BrightPassShader");
+    }
+}
+
+bool BrightPassShader::isValid() const
+{
+    // Validate program ID
+    if (programId == 0)
+    {
+        printf("Could not generate program ID\n");
+        return false;
+    }
+
+    // Validate uniforms
+    return validateUniform(sourceUniformLoc, "source")            //
+            && validateUniform(thresholdUniformLoc, "threshold")  //
+            && validateUniform(kneeUniformLoc, "knee");
+}
+
+///////////////////////////////////////////////////////////////////////////
+// BlurShader
+///////////////////////////////////////////////////////////////////////////
+
+BlurShader blurShader;
+
+const char* blurFragShaderSource = R"END_SHADER(
+#version 330 core
+
+uniform sampler2D source;
+
+// Distance between texels along the blur direction, in texture co-ordinates
+uniform vec2 texel_step;
+
+in vec2 uv;
+
+out vec4 frag_color;
+
+// 9-tap Gaussian, folded into 5 bilinear fetches by sampling between texel pairs
+const float offsets[3] = float[](0.f, 1.3846153846f, 3.2307692308f);
+const float weights[3] = float[](0.2270270270f, 0.3162162162f, 0.0702702703f);
+
+void main() {
+    vec3 color = texture(source, uv).rgb * weights[0];
+    for (int i = 1; i < 3; ++i) {
+        vec2 offset = texel_step * offsets[i];
+        color += texture(source, uv + offset).rgb * weights[i];
+        color += texture(source, uv - offset).rgb * weights[i];
+    }
+    frag_color = vec4(color, 1.f);
+}
+)END_SHADER";
+
+void BlurShader::init()
+{
+    GLuint programId = createShader(fullscreenVertShaderSource, blurFragShaderSource);
+
+    blurShader = BlurShader();
+    blurShader.programId = programId;
+    blurShader.sourceUniformLoc = glGetUniformLocation(programId, "source");
+    blurShader.texelStepUniformLoc = glGetUniformLocation(programId, "texel_step");
+
+    if (!blurShader.isValid())
+    {
+        throw std::runtime_error("Failed to create BlurShader");
+    }
+}
+
+bool BlurShader::isValid() const
+{
+    // Validate program ID
+    if (programId == 0)
+    {
+        printf("Could not generate program ID\n");
+        return false;
+    }
+
+    // Validate uniforms
+    return validateUniform(sourceUniformLoc, "source")  //
+            && validateUniform(texelStepUniformLoc, "texel_step");
+}
+
+///////////////////////////////////////////////////////////////////////////
+// CompositeShader
+///////////////////////////////////////////////////////////////////////////
+
+CompositeShader compositeShader;
+
+const char* compositeFragShaderSource = R"END_SHADER(
+#version 330 core
+
+uniform sampler2D scene;
+uniform sampler2D bloom_half;
+uniform sampler2D bloom_quarter;
+uniform float strength;
+
+in vec2 uv;
+
+out vec4 frag_color;
+
+void main() {
+    vec3 bloom = texture(bloom_half, uv).rgb + texture(bloom_quarter, uv).rgb;
+    frag_color = vec4(texture(scene, uv).rgb + bloom * strength, 1.f);
+}
+)END_SHADER";
+
+void CompositeShader::init()
+{
+    GLuint programId = createShader(fullscreenVertShaderSource, compositeFragShaderSource);
+
+    compositeShader = CompositeShader();
+    compositeShader.programId = programId;
+    compositeShader.sceneUniformLoc = glGetUniformLocation(programId, "scene");
+    compositeShader.bloomHalfUniformLoc = glGetUniformLocation(programId, "bloom_half");
+    compositeShader.bloomQuarterUniformLoc = glGetUniformLocation(programId, "bloom_quarter");
+    compositeShader.strengthUniformLoc = glGetUniformLocation(programId, "strength");
+
+    if (!compositeShader.isValid())
+    {
+        throw std::runtime_error("Failed to create CompositeShader");
+    }
+}
+
+bool CompositeShader::isValid() const
+{
+    // Validate program ID
+    if (programId == 0)
+    {
+        printf("Could not generate program ID\n");
+        return false;
+    }
+
+    // Validate uniforms
+    return validateUniform(sceneUniformLoc, "scene")                     //
+            && validateUniform(bloomHalfUniformLoc, "bloom_half")        //
+            && validateUniform(bloomQuarterUniformLoc, "bloom_quarter")  //
+            && validateUniform(strengthUniformLoc, "strength");
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -164,9 +619,17 @@ bool BoxShader::isValid() const
 void initializeShaders()
 {
     BoxShader::init();
+    ParticleShader::init();
+    TrailShader::init();
+    BrightPassShader::init();
+    BlurShader::init();
+    CompositeShader::init();
+
+    std::cout << "Loaded " << ShaderCache::getNumHits() << " shader programs from cache, compiled "
+              << ShaderCache::getNumMisses() << "\n";
 }
 
-GLuint createShader(const char* vertShaderSource, const char* fragShaderSource)
+GLuint compileProgram(const char* vertShaderSource, const char* fragShaderSource)
 {
     GLuint programId = glCreateProgram();
 
@@ -215,6 +678,7 @@ GLuint createShader(const char* vertShaderSource, const char* fragShaderSource)
     glAttachShader(programId, fragmentShader);
 
     // Link program
+    ShaderCache::prepareForLink(programId);
     glLinkProgram(programId);
 
     // Check for errors
@@ -236,4 +700,24 @@ GLuint createShader(const char* vertShaderSource, const char* fragShaderSource)
     return programId;
 }
 
+GLuint createShader(const char* vertShaderSource, const char* fragShaderSource)
+{
+    // Use the cached binary if the driver accepts it
+    uint64_t cacheKey = ShaderCache::makeKey(vertShaderSource, fragShaderSource);
+    GLuint programId = ShaderCache::load(cacheKey);
+    if (programId != 0)
+    {
+        return programId;
+    }
+
+    // Otherwise compile from source, and cache the result for next time
+    programId = compileProgram(vertShaderSource, fragShaderSource);
+    if (programId != 0)
+    {
+        ShaderCache::save(cacheKey, programId);
+    }
+
+    return programId;
+}
+
 }  // namespace Shaders
@@ -0,0 +1,93 @@
+#include "SharedMemory.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <stdexcept>
+
+////////////////////////////////////////////////////////////////////////////////
+// Windows
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef _WIN32
+
+SharedMemory::SharedMemory(const std::string& name, size_t size)
+    : name("Local\\" + name)
+    , size(size)
+{
+    unsigned long long size64 = size;
+    handle = CreateFileMappingA(
+            INVALID_HANDLE_VALUE,
+            nullptr,
+            PAGE_READWRITE,
+            static_cast<DWORD>(size64 >> 32),
+            static_cast<DWORD>(size64 & 0xffffffff),
+            this->name.c_str());
+    if (!handle)
+    {
+        throw std::runtime_error("Failed to create shared memory: " + this->name);
+    }
+
+    data = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!data)
+    {
+        CloseHandle(handle);
+        throw std::runtime_error("Failed to map shared memory: " + this->name);
+    }
+}
+
+SharedMemory::~SharedMemory()
+{
+    UnmapViewOfFile(data);
+    CloseHandle(handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// POSIX
+////////////////////////////////////////////////////////////////////////////////
+
+#else
+
+SharedMemory::SharedMemory(const std::string& name, size_t size)
+    : name("/" + name)
+    , size(size)
+{
+    int fd = shm_open(this->name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd == -1)
+    {
+        throw std::runtime_error("Failed to create shared memory: " + this->name);
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(size)) == -1)
+    {
+        close(fd);
+        shm_unlink(this->name.c_str());
+        throw std::runtime_error("Failed to resize shared memory: " + this->name);
+    }
+
+    data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    // The mapping keeps the memory alive, so we no longer need the descriptor
+    close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        data = nullptr;
+        shm_unlink(this->name.c_str());
+        throw std::runtime_error("Failed to map shared memory: " + this->name);
+    }
+}
+
+SharedMemory::~SharedMemory()
+{
+    munmap(data, size);
+    shm_unlink(name.c_str());
+}
+
+#endif
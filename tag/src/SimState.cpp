@@ -0,0 +1,193 @@
+#include "SimState.h"
+
+#include <algorithm>  // min, max, swap
+#include <cmath>
+
+#include "MathUtils.h"
+#include "TimeUtils.h"
+
+SimState SimState::capture(const World& world)
+{
+    SimState state;
+
+    const std::vector<Player>& worldPlayers = world.getPlayers();
+    state.numPlayers = static_cast<int>(worldPlayers.size());
+    for (int i = 0; i < state.numPlayers; ++i)
+    {
+        const Player& player = worldPlayers[i];
+        state.players[i] = { player.rect.pos, player.dir, player.speed, player.timeRemaining };
+
+        for (int j = 0; j < state.numPlayers; ++j)
+        {
+            if (i != j && player.wasIntersecting(worldPlayers[j]))
+            {
+                state.intersectingLastTick |= 1 << pairIndex(i, j);
+            }
+        }
+    }
+
+    const Player* worldTaggedPlayer = world.getTaggedPlayer();
+    state.taggedPlayer = worldTaggedPlayer ? worldTaggedPlayer->getPlayerId() : noPlayer;
+    state.worldExtents = world.getExtents();
+    state.collisionWorld = world.hasObstacles() ? &world : nullptr;
+    state.gameMode = world.getGameMode();
+    state.tickFunction = state.gameMode == GameMode::Inverted ? &SimState::tickWith<GameModes::Inverted>
+                                                                   : &SimState::tickWith<GameModes::Classic>;
+
+    state.setSeed(0);
+
+    return state;
+}
+
+void SimState::setDir(int playerIndex, Direction dir)
+{
+    players[playerIndex].dir = dir;
+}
+
+void SimState::tick()
+{
+    (this->*tickFunction)();
+}
+
+template <typename Mode>
+void SimState::tickWith()
+{
+    if (isFinished())
+    {
+        return;
+    }
+
+    constexpr float dt = TimeUtils::frameTime;
+
+    // Move all players (see Player::tick)
+    for (int i = 0; i < numPlayers; ++i)
+    {
+        SimPlayer& player = players[i];
+
+        glm::vec2 newPos = player.pos + getDirVector(player.dir) * player.speed * dt;
+        if (collisionWorld)
+        {
+            player.pos = collisionWorld->resolveMovement(player.pos, newPos, Player::extents);
+        }
+        else
+        {
+            player.pos.x = MathUtils::clamp(
+                    newPos.x, -worldExtents.x + Player::extents.x, worldExtents.x - Player::extents.x);
+            player.pos.y = MathUtils::clamp(
+                    newPos.y, -worldExtents.y + Player::extents.y, worldExtents.y - Player::extents.y);
+        }
+
+        if (taggedPlayer == noPlayer)
+        {
+            continue;
+        }
+
+        bool isTagged = taggedPlayer == i;
+        if (Mode::accelerates(isTagged))
+        {
+            player.speed = std::min(player.speed + Player::acceleration * dt, Player::maxSpeed);
+        }
+        if (Mode::countsDown(isTagged))
+        {
+            player.timeRemaining = std::max(player.timeRemaining - dt, 0.f);
+        }
+
+        if (player.timeRemaining == 0.f)
+        {
+            winner = Mode::chooseWinner(i, numPlayers, [&](int j) { return players[j].timeRemaining; });
+            return;
+        }
+    }
+
+    // Check for collisions between all players (see Application::tick)
+    uint16_t intersecting = 0;
+    for (int i = 0; i < numPlayers; ++i)
+    {
+        for (int j = i + 1; j < numPlayers; ++j)
+        {
+            glm::vec2 diff = players[i].pos - players[j].pos;
+            bool intersects = std::abs(diff.x) < 2.f * Player::extents.x && std::abs(diff.y) < 2.f * Player::extents.y;
+            if (!intersects)
+            {
+                continue;
+            }
+
+            uint16_t pairBit = 1 << pairIndex(i, j);
+            intersecting |= pairBit;
+            if (!(intersectingLastTick & pairBit))
+            {
+                tag(i, j);
+            }
+        }
+    }
+    intersectingLastTick = intersecting;
+}
+
+void SimState::setSeed(uint32_t seed)
+{
+    // Scramble the seed so that consecutive seeds give unrelated sequences (murmur3 finalizer)
+    seed ^= seed >> 16;
+    seed *= 0x85ebca6b;
+    seed ^= seed >> 13;
+    seed *= 0xc2b2ae35;
+    seed ^= seed >> 16;
+
+    // xorshift must never be seeded with 0
+    rngState = seed ? seed : 0x9e3779b9;
+}
+
+uint32_t SimState::random(uint32_t max)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState % max;
+}
+
+glm::vec2 SimState::getDirVector(Direction dir)
+{
+    switch (dir)
+    {
+    case Direction::UP:
+        return { 0.f, -1.f };
+    case Direction::DOWN:
+        return { 0.f, 1.f };
+    case Direction::LEFT:
+        return { -1.f, 0.f };
+    case Direction::RIGHT:
+        return { 1.f, 0.f };
+    default:
+        return { 0.f, 0.f };
+    }
+}
+
+void SimState::tag(int a, int b)
+{
+    if (taggedPlayer == noPlayer)
+    {
+        // Pick a player at random
+        taggedPlayer = random(2) == 0 ? a : b;
+        return;
+    }
+
+    players[taggedPlayer].speed = Player::baseSpeed;
+
+    if (taggedPlayer == a)
+    {
+        taggedPlayer = b;
+    }
+    else if (taggedPlayer == b)
+    {
+        taggedPlayer = a;
+    }
+}
+
+int SimState::pairIndex(int a, int b)
+{
+    // Row-major index into the upper triangle of a maxPlayers x maxPlayers matrix
+    if (a > b)
+    {
+        std::swap(a, b);
+    }
+    return a * World::maxPlayers + b;
+}
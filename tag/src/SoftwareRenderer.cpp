@@ -0,0 +1,255 @@
+#include "SoftwareRenderer.h"
+
+#include <algorithm>  // clamp, fill_n, max, min
+#include <cmath>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define TAG_HAS_AVX2_PATH
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#include "Color.h"
+#include "GameRenderer.h"
+#include "Player.h"
+#include "TileMap.h"
+
+namespace {
+
+#ifdef TAG_HAS_AVX2_PATH
+
+#ifdef _MSC_VER
+#define TAG_TARGET_AVX2
+#else
+#define TAG_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+bool cpuSupportsAvx2()
+{
+#ifdef _MSC_VER
+    // The OS must also save the AVX registers on a context switch
+    int info[4];
+    __cpuid(info, 1);
+    bool osSavesAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    if (!osSavesAvx)
+    {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+TAG_TARGET_AVX2 void fillSpanAvx2(uint32_t* dest, int count, uint32_t color)
+{
+    const __m256i colors = _mm256_set1_epi32(static_cast<int>(color));
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), colors);
+    }
+    for (; i < count; ++i)
+    {
+        dest[i] = color;
+    }
+}
+
+const bool useAvx2 = cpuSupportsAvx2();
+
+#endif
+
+/**
+ * Blends a colour towards white, as the box shader does for the screen flash.
+ */
+Color applyFlash(Color color, float flashIntensity)
+{
+    color.r += (1.f - color.r) * flashIntensity;
+    color.g += (1.f - color.g) * flashIntensity;
+    color.b += (1.f - color.b) * flashIntensity;
+    return color;
+}
+
+}  // namespace
+
+SoftwareRenderer::SoftwareRenderer(
+        glm::ivec2 targetSize,
+        const World* world,
+        const std::vector<Camera>* cameras,
+        const ScreenShake* screenShake,
+        ThreadPool* threadPool)
+    : world(world)
+    , cameras(cameras)
+    , screenShake(screenShake)
+    , threadPool(threadPool)
+{
+    updateViewport(targetSize);
+}
+
+void SoftwareRenderer::updateViewport(glm::ivec2 targetSize)
+{
+    image.width = targetSize.x;
+    image.height = targetSize.y;
+    image.pixels.resize(static_cast<size_t>(targetSize.x) * targetSize.y * Image::bytesPerPixel);
+
+    // GameRenderer's viewports start from the bottom, but our rows start from the top
+    auto toPixelRect = [&](const GameRenderer::Viewport& viewport) {
+        int top = targetSize.y - (viewport.y + viewport.height);
+        return PixelRect { viewport.x, top, viewport.x + viewport.width, top + viewport.height };
+    };
+
+    GameRenderer::Layout layout = GameRenderer::makeLayout(targetSize, *cameras);
+    viewAreas.clear();
+    for (const GameRenderer::Viewport& viewport : layout.viewports)
+    {
+        viewAreas.push_back(toPixelRect(viewport));
+    }
+    hudArea = toPixelRect(layout.hudViewport);
+    hudExtents = layout.hudExtents;
+}
+
+void SoftwareRenderer::render(double /*time*/)
+{
+    boxes.clear();
+
+    const Player* taggedPlayer = world->getTaggedPlayer();
+    const Color borderColor = taggedPlayer ? taggedPlayer->getColor() : Color::white;
+    const uint32_t obstacleColor = applyFlash(borderColor, screenShake->getFlashIntensity()).pack();
+    const glm::vec2 shakeOffset = screenShake->getOffset();
+    const auto borderRects = GameRenderer::makeBorderRects(world->getExtents());
+
+    for (size_t i = 0; i < viewAreas.size(); ++i)
+    {
+        // Shaking the camera the opposite way moves everything in the world at once
+        Rect frame = (*cameras)[i].getFrame();
+        frame.pos -= shakeOffset;
+        Rect visibleRect = GameRenderer::makeVisibleRect(frame);
+        ViewTransform transform = makeViewTransform(viewAreas[i], visibleRect);
+
+        // - Border & obstacles
+        for (const Rect& border : borderRects)
+        {
+            addBox(transform, border, obstacleColor);
+        }
+        world->forEachObstacleIn(
+                visibleRect, [&](const Rect& obstacle) { addBox(transform, obstacle, obstacleColor); });
+
+        // - Streamed tiles
+        if (const TileMap* tileMap = world->getTileMap())
+        {
+            tileMap->forEachResidentChunk([&](const Rect& bounds, const std::vector<Rect>& runs) {
+                if (bounds.intersects(visibleRect))
+                {
+                    for (const Rect& run : runs)
+                    {
+                        addBox(transform, run, obstacleColor);
+                    }
+                }
+            });
+        }
+
+        // - Pickups
+        world->getPickups().forEach([&](const Rect& bounds, PowerUp /*powerUp*/) {
+            addBox(transform, bounds, Color::white.pack());
+        });
+
+        // - Players
+        for (const Player& player : world->getPlayers())
+        {
+            addBox(transform, player.getRect(), player.getColor().pack());
+        }
+    }
+
+    // - Scores
+    // The HUD is laid out in a fixed frame, so it stays put when the cameras move or the screen shakes
+    Rect hudVisibleRect = GameRenderer::makeVisibleRect({ { 0.f, 0.f }, hudExtents });
+    ViewTransform hudTransform = makeViewTransform(hudArea, hudVisibleRect);
+    int numPlayers = static_cast<int>(world->getPlayers().size());
+    for (const Player& player : world->getPlayers())
+    {
+        addBox(hudTransform, GameRenderer::makeScoreRect(player, numPlayers, hudExtents), player.getColor().pack());
+    }
+
+    // Fill the image
+    int numBands = (image.height + bandHeight - 1) / bandHeight;
+    if (threadPool)
+    {
+        threadPool->parallelFor(numBands, [&](int band) { fillBand(band); });
+    }
+    else
+    {
+        for (int band = 0; band < numBands; ++band)
+        {
+            fillBand(band);
+        }
+    }
+}
+
+SoftwareRenderer::ViewTransform SoftwareRenderer::makeViewTransform(const PixelRect& area, const Rect& visibleRect)
+{
+    glm::vec2 scale(
+            static_cast<float>(area.right - area.left) / (2.f * visibleRect.extents.x),
+            static_cast<float>(area.bottom - area.top) / (2.f * visibleRect.extents.y));
+    glm::vec2 topLeft = visibleRect.pos - visibleRect.extents;
+    glm::vec2 areaTopLeft(static_cast<float>(area.left), static_cast<float>(area.top));
+    return { area, areaTopLeft - topLeft * scale, scale };
+}
+
+void SoftwareRenderer::addBox(const ViewTransform& transform, const Rect& rect, uint32_t color)
+{
+    // A pixel is covered if its centre lies within the box, matching the GPU's rasterisation rules
+    auto toPixel = [](float coord) { return static_cast<int>(std::ceil(coord - 0.5f)); };
+
+    glm::vec2 topLeft = transform.origin + (rect.pos - rect.extents) * transform.scale;
+    glm::vec2 bottomRight = transform.origin + (rect.pos + rect.extents) * transform.scale;
+
+    PixelRect bounds;
+    bounds.left = std::max(toPixel(topLeft.x), transform.area.left);
+    bounds.top = std::max(toPixel(topLeft.y), transform.area.top);
+    bounds.right = std::min(toPixel(bottomRight.x), transform.area.right);
+    bounds.bottom = std::min(toPixel(bottomRight.y), transform.area.bottom);
+
+    if (bounds.left < bounds.right && bounds.top < bounds.bottom)
+    {
+        boxes.push_back({ bounds, color });
+    }
+}
+
+void SoftwareRenderer::fillBand(int band)
+{
+    const int bandTop = band * bandHeight;
+    const int bandBottom = std::min(bandTop + bandHeight, image.height);
+    uint32_t* pixels = reinterpret_cast<uint32_t*>(image.pixels.data());
+
+    // Clear to black, like the GPU path
+    fillSpan(pixels + static_cast<size_t>(bandTop) * image.width, (bandBottom - bandTop) * image.width, 0);
+
+    for (const ScreenBox& box : boxes)
+    {
+        int top = std::max(box.bounds.top, bandTop);
+        int bottom = std::min(box.bounds.bottom, bandBottom);
+        int width = box.bounds.right - box.bounds.left;
+
+        for (int y = top; y < bottom; ++y)
+        {
+            fillSpan(pixels + static_cast<size_t>(y) * image.width + box.bounds.left, width, box.color);
+        }
+    }
+}
+
+void SoftwareRenderer::fillSpan(uint32_t* dest, int count, uint32_t color)
+{
+#ifdef TAG_HAS_AVX2_PATH
+    if (useAvx2)
+    {
+        fillSpanAvx2(dest, count, color);
+        return;
+    }
+#endif
+
+    std::fill_n(dest, count, color);
+}
@@ -0,0 +1,106 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int numWorkers)
+{
+    if (numWorkers < 0)
+    {
+        int numHardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+        numWorkers = numHardwareThreads > 1 ? numHardwareThreads - 1 : 0;
+    }
+
+    workers.reserve(numWorkers);
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    batchReady.notify_all();
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(int numTasks, const std::function<void(int)>& task)
+{
+    if (numTasks <= 0)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        this->numTasks = numTasks;
+        nextTask = 0;
+        numTasksRemaining = numTasks;
+        ++batchId;
+    }
+    batchReady.notify_all();
+
+    // Help out rather than sitting idle
+    runTasks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    batchDone.wait(lock, [this]() { return numTasksRemaining == 0; });
+    currentTask = nullptr;
+}
+
+void ThreadPool::workerLoop()
+{
+    unsigned int lastBatchId = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            batchReady.wait(lock, [&]() { return stopping || batchId != lastBatchId; });
+            if (stopping)
+            {
+                return;
+            }
+            lastBatchId = batchId;
+        }
+
+        runTasks();
+    }
+}
+
+void ThreadPool::runTasks()
+{
+    while (true)
+    {
+        const std::function<void(int)>* task;
+        int taskIndex;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!currentTask || nextTask >= numTasks)
+            {
+                return;
+            }
+            task = currentTask;
+            taskIndex = nextTask++;
+        }
+
+        (*task)(taskIndex);
+
+        bool finished;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = --numTasksRemaining == 0;
+        }
+        if (finished)
+        {
+            batchDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,223 @@
+#include "TileMap.h"
+
+#include <cstdlib>  // abs
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+TileMap::TileMap(std::unique_ptr<LevelFile> file, int maxFocusPoints)
+    : file(std::move(file))
+    , worldExtents(glm::vec2(this->file->getWidthTiles(), this->file->getHeightTiles()) * this->file->getTileSize()
+                   / 2.f)
+    , tileSize(this->file->getTileSize())
+    , chunkSize(this->file->getChunkSize())
+    , chunkSlots(this->file->getNumChunks(), noChunk)
+{
+    // Each focus point keeps at most this many chunks alive
+    int chunksPerFocusPoint = (2 * evictRadius + 1) * (2 * evictRadius + 1);
+    chunks.resize(std::min(maxFocusPoints * chunksPerFocusPoint, this->file->getNumChunks()));
+
+    // Allocate everything up-front, so that streaming never allocates
+    int maxRunsPerChunk = chunkSize * ((chunkSize + 1) / 2);
+    for (Chunk& chunk : chunks)
+    {
+        chunk.tiles.resize(chunkSize * chunkSize);
+        chunk.runs.reserve(maxRunsPerChunk);
+    }
+    focusChunks.reserve(maxFocusPoints);
+}
+
+void TileMap::update(const std::vector<glm::vec2>& focusPoints)
+{
+    ++updateCount;
+
+    float chunkWorldUnits = chunkSize * tileSize;
+    int numChunksX = file->getNumChunksX();
+    int numChunksY = file->getNumChunksY();
+
+    // Find the chunk containing each focus point
+    focusChunks.clear();
+    for (const glm::vec2& pos : focusPoints)
+    {
+        glm::vec2 chunkPos = (pos + worldExtents) / chunkWorldUnits;
+        focusChunks.emplace_back(
+                std::clamp(static_cast<int>(chunkPos.x), 0, numChunksX - 1),
+                std::clamp(static_cast<int>(chunkPos.y), 0, numChunksY - 1));
+    }
+
+    // Evict chunks that have been left behind
+    for (int slot = 0; slot < static_cast<int>(chunks.size()); ++slot)
+    {
+        Chunk& chunk = chunks[slot];
+        if (chunk.chunkIndex == noChunk)
+        {
+            continue;
+        }
+
+        int chunkX = chunk.chunkIndex % numChunksX;
+        int chunkY = chunk.chunkIndex / numChunksX;
+        bool nearFocus = false;
+        for (const glm::ivec2& focus : focusChunks)
+        {
+            if (std::abs(focus.x - chunkX) <= evictRadius && std::abs(focus.y - chunkY) <= evictRadius)
+            {
+                nearFocus = true;
+                break;
+            }
+        }
+
+        if (!nearFocus)
+        {
+            evictSlot(slot);
+        }
+    }
+
+    // Load chunks that are coming into range
+    for (const glm::ivec2& focus : focusChunks)
+    {
+        int minX = std::max(focus.x - loadRadius, 0);
+        int minY = std::max(focus.y - loadRadius, 0);
+        int maxX = std::min(focus.x + loadRadius, numChunksX - 1);
+        int maxY = std::min(focus.y + loadRadius, numChunksY - 1);
+
+        for (int chunkY = minY; chunkY <= maxY; ++chunkY)
+        {
+            for (int chunkX = minX; chunkX <= maxX; ++chunkX)
+            {
+                int slot = chunkSlots[chunkY * numChunksX + chunkX];
+                if (slot == noChunk)
+                {
+                    loadChunk(chunkX, chunkY);
+                }
+                else
+                {
+                    chunks[slot].lastUsed = updateCount;
+                }
+            }
+        }
+    }
+}
+
+bool TileMap::isSolid(int tileX, int tileY) const
+{
+    if (tileX < 0 || tileY < 0 || tileX >= file->getWidthTiles() || tileY >= file->getHeightTiles())
+    {
+        return true;
+    }
+
+    int chunkIndex = (tileY / chunkSize) * file->getNumChunksX() + (tileX / chunkSize);
+    int slot = chunkSlots[chunkIndex];
+    if (slot == noChunk)
+    {
+        return true;
+    }
+
+    int localX = tileX % chunkSize;
+    int localY = tileY % chunkSize;
+    return chunks[slot].tiles[localY * chunkSize + localX] != LevelFile::emptyTile;
+}
+
+int TileMap::getMaxResidentRuns() const
+{
+    // Worst case is alternating solid and empty tiles
+    return static_cast<int>(chunks.size()) * chunkSize * ((chunkSize + 1) / 2);
+}
+
+void TileMap::loadChunk(int chunkX, int chunkY)
+{
+    int slot = findFreeSlot();
+    Chunk& chunk = chunks[slot];
+
+    // This runs mid-match, so a corrupt chunk must not bring the game down; walling it off keeps players out of it
+    try
+    {
+        file->decodeChunk(chunkX, chunkY, chunk.tiles.data());
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cerr << e.what() << " (" << chunkX << ", " << chunkY << "); treating it as solid\n";
+        std::fill(chunk.tiles.begin(), chunk.tiles.end(), LevelFile::solidTile);
+    }
+
+    chunk.chunkIndex = chunkY * file->getNumChunksX() + chunkX;
+    chunk.lastUsed = updateCount;
+    chunkSlots[chunk.chunkIndex] = slot;
+
+    // Merge each row into runs of solid tiles, so they can be rendered cheaply.
+    // Tiles beyond the edge of the level are not included, since the border is drawn separately.
+    int firstTileX = chunkX * chunkSize;
+    int firstTileY = chunkY * chunkSize;
+    int chunkWidth = std::min(chunkSize, file->getWidthTiles() - firstTileX);
+    int chunkHeight = std::min(chunkSize, file->getHeightTiles() - firstTileY);
+
+    glm::vec2 chunkExtents = glm::vec2(chunkWidth, chunkHeight) * (tileSize / 2.f);
+    chunk.bounds = { glm::vec2(firstTileX, firstTileY) * tileSize + chunkExtents - worldExtents, chunkExtents };
+
+    chunk.runs.clear();
+    for (int y = 0; y < chunkHeight; ++y)
+    {
+        const uint8_t* row = &chunk.tiles[y * chunkSize];
+        int x = 0;
+        while (x < chunkWidth)
+        {
+            if (row[x] == LevelFile::emptyTile)
+            {
+                ++x;
+                continue;
+            }
+
+            int runStart = x;
+            while (x < chunkWidth && row[x] != LevelFile::emptyTile)
+            {
+                ++x;
+            }
+            chunk.runs.push_back(makeTileRect(firstTileX + runStart, firstTileY + y, x - runStart));
+        }
+    }
+
+    ++numResidentChunks;
+    ++numChunksDecoded;
+    ++version;
+}
+
+int TileMap::findFreeSlot()
+{
+    int oldestSlot = 0;
+    uint64_t oldestUse = std::numeric_limits<uint64_t>::max();
+
+    for (int slot = 0; slot < static_cast<int>(chunks.size()); ++slot)
+    {
+        const Chunk& chunk = chunks[slot];
+        if (chunk.chunkIndex == noChunk)
+        {
+            return slot;
+        }
+        if (chunk.lastUsed < oldestUse)
+        {
+            oldestSlot = slot;
+            oldestUse = chunk.lastUsed;
+        }
+    }
+
+    // Only reachable if there are more focus points than we were told to expect
+    evictSlot(oldestSlot);
+    return oldestSlot;
+}
+
+void TileMap::evictSlot(int slot)
+{
+    Chunk& chunk = chunks[slot];
+    chunkSlots[chunk.chunkIndex] = noChunk;
+    chunk.chunkIndex = noChunk;
+    chunk.runs.clear();
+
+    --numResidentChunks;
+    ++version;
+}
+
+Rect TileMap::makeTileRect(int tileX, int tileY, int numTiles) const
+{
+    glm::vec2 extents(numTiles * tileSize / 2.f, tileSize / 2.f);
+    glm::vec2 pos = glm::vec2(tileX * tileSize, tileY * tileSize) + extents - worldExtents;
+    return { pos, extents };
+}
@@ -0,0 +1,124 @@
+#include "TrailRenderable.h"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>  // max, min
+#include <cstddef>    // offsetof
+#include <vector>
+
+#include "Color.h"
+#include "Shaders.h"
+
+TrailRenderable::TrailRenderable(int maxTrails, int segmentsPerTrail)
+    : maxTrails(maxTrails)
+    , segmentsPerTrail(segmentsPerTrail)
+{
+    const int maxSegments = maxTrails * segmentsPerTrail;
+
+    // Generate VAO
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    // Vertex attributes are interleaved, so that each segment can be written with a single upload
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glVertexAttribPointer(
+            Shaders::vertexAttribIndex,
+            2,
+            GL_FLOAT,
+            GL_FALSE,
+            sizeof(Vertex),
+            reinterpret_cast<const void*>(offsetof(Vertex, x)));
+    glVertexAttribPointer(
+            Shaders::colorAttribIndex,
+            4,
+            GL_UNSIGNED_BYTE,
+            GL_TRUE,
+            sizeof(Vertex),
+            reinterpret_cast<const void*>(offsetof(Vertex, color)));
+    glVertexAttribIPointer(
+            Shaders::trailTickAttribIndex,
+            1,
+            GL_UNSIGNED_INT,
+            sizeof(Vertex),
+            reinterpret_cast<const void*>(offsetof(Vertex, tick)));
+    glEnableVertexAttribArray(Shaders::vertexAttribIndex);
+    glEnableVertexAttribArray(Shaders::colorAttribIndex);
+    glEnableVertexAttribArray(Shaders::trailTickAttribIndex);
+    clear();
+
+    // Initialize index buffer - this never needs to change
+    std::vector<GLuint> indexData;
+    indexData.reserve(maxSegments * numIndicesPerSegment);
+    for (int i = 0; i < maxSegments; ++i)
+    {
+        GLuint startIndex = i * numVerticesPerSegment;
+        indexData.push_back(startIndex);
+        indexData.push_back(startIndex + 1);
+        indexData.push_back(startIndex + 2);
+        indexData.push_back(startIndex + 2);
+        indexData.push_back(startIndex + 3);
+        indexData.push_back(startIndex);
+    }
+    glGenBuffers(1, &ibo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexData.size() * sizeof(GLuint), indexData.data(), GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+}
+
+TrailRenderable::~TrailRenderable()
+{
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(1, &ibo);
+    glDeleteVertexArrays(1, &vao);
+}
+
+void TrailRenderable::clear()
+{
+    // Zeroed segments have no area, so they are never visible
+    std::vector<Vertex> emptyData(maxTrails * segmentsPerTrail * numVerticesPerSegment, Vertex {});
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, emptyData.size() * sizeof(Vertex), emptyData.data(), GL_DYNAMIC_DRAW);
+}
+
+void TrailRenderable::addSegment(
+        int trailIndex, uint32_t tick, glm::vec2 from, glm::vec2 to, float halfWidth, const Color& color)
+{
+    const float x1 = std::min(from.x, to.x) - halfWidth;
+    const float y1 = std::min(from.y, to.y) - halfWidth;
+    const float x2 = std::max(from.x, to.x) + halfWidth;
+    const float y2 = std::max(from.y, to.y) + halfWidth;
+    const uint32_t packedColor = color.pack();
+
+    // Same corner order as BoxRenderable
+    Vertex vertices[numVerticesPerSegment] = {
+        { x1, y1, packedColor, tick },
+        { x2, y1, packedColor, tick },
+        { x2, y2, packedColor, tick },
+        { x1, y2, packedColor, tick },
+    };
+
+    // Corners at the `from` end belong to the previous tick
+    for (Vertex& vertex : vertices)
+    {
+        glm::vec2 corner(vertex.x, vertex.y);
+        if (glm::distance(corner, from) < glm::distance(corner, to))
+        {
+            vertex.tick = tick - 1;
+        }
+    }
+
+    // Overwrite the oldest segment in this trail
+    int segmentIndex = trailIndex * segmentsPerTrail + static_cast<int>(tick % segmentsPerTrail);
+    GLintptr offset = segmentIndex * numVerticesPerSegment * sizeof(Vertex);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, offset, sizeof(vertices), vertices);
+}
+
+void TrailRenderable::render() const
+{
+    glBindVertexArray(vao);
+    glDrawElements(GL_TRIANGLES, maxTrails * segmentsPerTrail * numIndicesPerSegment, GL_UNSIGNED_INT, nullptr);
+    glBindVertexArray(0);
+}
@@ -0,0 +1,178 @@
+#include "VideoRecorder.h"
+
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+bool endsWith(const std::string& str, const std::string& suffix)
+{
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+}  // namespace
+
+VideoRecorder::VideoRecorder(const std::string& filename, int width, int height, int fps)
+    : filename(filename)
+    , file(filename, std::ios::binary | std::ios::trunc)
+    , y4m(endsWith(filename, ".y4m"))
+    , width(width)
+    , height(height)
+    , readback(width, height, numReadbackBuffers)
+{
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open video file for writing: " + filename);
+    }
+
+    if (y4m)
+    {
+        file << "YUV4MPEG2 W" << width << " H" << height << " F" << fps << ":1 Ip A1:1 C444\n";
+    }
+
+    freeImages.resize(maxQueuedFrames);
+    for (Image& image : freeImages)
+    {
+        image.width = width;
+        image.height = height;
+        image.pixels.resize(static_cast<size_t>(width) * height * Image::bytesPerPixel);
+    }
+
+    std::cout << "Recording " << width << "x" << height << " at " << fps << " FPS to " << filename
+              << (y4m ? " (Y4M)\n" : " (raw RGBA)\n");
+
+    writer = std::thread(&VideoRecorder::writerLoop, this);
+}
+
+VideoRecorder::~VideoRecorder()
+{
+    collectFrames(true);
+
+    {
+        std::scoped_lock lock(mutex);
+        stopping = true;
+    }
+    frameQueued.notify_one();
+    writer.join();
+
+    int numFramesWritten = numFramesCaptured - numFramesDropped;
+    std::cout << "Recorded " << numFramesWritten << " frames to " << filename << " (" << numFramesDropped
+              << " dropped)\n";
+    if (!file)
+    {
+        std::cerr << "Failed to write video file: " << filename << "\n";
+    }
+}
+
+void VideoRecorder::captureFrame()
+{
+    collectFrames(false);
+
+    ++numFramesCaptured;
+    if (!readback.request())
+    {
+        // The GPU is falling behind, and waiting for it would stall the game
+        ++numFramesDropped;
+    }
+}
+
+void VideoRecorder::collectFrames(bool wait)
+{
+    while (readback.getNumPending() > 0)
+    {
+        Image image;
+        bool dropped = !takeFreeImage(image);
+
+        // A readback must still be collected to free its buffer, even if there is nowhere to put the frame
+        if (!readback.poll(image, wait))
+        {
+            if (!dropped)
+            {
+                std::scoped_lock lock(mutex);
+                freeImages.push_back(std::move(image));
+            }
+            return;
+        }
+
+        if (dropped)
+        {
+            // The writer thread is falling behind
+            ++numFramesDropped;
+            continue;
+        }
+
+        {
+            std::scoped_lock lock(mutex);
+            queuedFrames.push_back(std::move(image));
+        }
+        frameQueued.notify_one();
+    }
+}
+
+bool VideoRecorder::takeFreeImage(Image& image)
+{
+    std::scoped_lock lock(mutex);
+    if (freeImages.empty())
+    {
+        return false;
+    }
+
+    image = std::move(freeImages.back());
+    freeImages.pop_back();
+    return true;
+}
+
+void VideoRecorder::writerLoop()
+{
+    while (true)
+    {
+        Image image;
+        {
+            std::unique_lock lock(mutex);
+            frameQueued.wait(lock, [&] { return stopping || !queuedFrames.empty(); });
+
+            // Keep going until every queued frame has been written
+            if (queuedFrames.empty())
+            {
+                return;
+            }
+
+            image = std::move(queuedFrames.front());
+            queuedFrames.pop_front();
+        }
+
+        writeFrame(image);
+
+        std::scoped_lock lock(mutex);
+        freeImages.push_back(std::move(image));
+    }
+}
+
+void VideoRecorder::writeFrame(const Image& image)
+{
+    const size_t numPixels = static_cast<size_t>(image.width) * image.height;
+
+    if (!y4m)
+    {
+        file.write(reinterpret_cast<const char*>(image.pixels.data()), numPixels * Image::bytesPerPixel);
+        return;
+    }
+
+    // Convert to planar YUV, using the BT.601 limited-range matrix that players assume for Y4M
+    frameData.resize(numPixels * 3);
+    uint8_t* yPlane = frameData.data();
+    uint8_t* uPlane = yPlane + numPixels;
+    uint8_t* vPlane = uPlane + numPixels;
+    for (size_t i = 0; i < numPixels; ++i)
+    {
+        int r = image.pixels[i * Image::bytesPerPixel + 0];
+        int g = image.pixels[i * Image::bytesPerPixel + 1];
+        int b = image.pixels[i * Image::bytesPerPixel + 2];
+        yPlane[i] = static_cast<uint8_t>(16 + ((66 * r + 129 * g + 25 * b + 128) >> 8));
+        uPlane[i] = static_cast<uint8_t>(128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8));
+        vPlane[i] = static_cast<uint8_t>(128 + ((112 * r - 94 * g - 18 * b + 128) >> 8));
+    }
+
+    file << "FRAME\n";
+    file.write(reinterpret_cast<const char*>(frameData.data()), frameData.size());
+}
@@ -1,11 +1,20 @@
 #include "World.h"
 
+#include <algorithm>  // min, max
+#include <cmath>
+
 #include "MathUtils.h"
 
-World::World(glm::vec2 size, int numPlayers)
+World::World(glm::vec2 size, int numPlayers, std::vector<Rect> obstacles, std::unique_ptr<TileMap> tileMap)
     : size(size)
     , extents(size.x / 2.f, size.y / 2.f)
+    , tileMap(std::move(tileMap))
+    , navGrid(size, std::max(navCellSize, std::max(size.x, size.y) / maxNavGridSize))
+    , flowFields(maxPlayers, FlowField(navGrid))
 {
+    setObstacles(std::move(obstacles));
+    pickups.reserve(maxPickups);
+    focusPoints.reserve(maxPlayers);
     reset(numPlayers);
 }
 
@@ -21,6 +30,117 @@ glm::vec2 World::keepInBounds(const glm::vec2& objPos, const glm::vec2& objExten
     return { x, y };
 }
 
+glm::vec2 World::resolveMovement(const glm::vec2& oldPos, const glm::vec2& newPos, const glm::vec2& objExtents) const
+{
+    glm::vec2 pos = keepInBounds(newPos, objExtents);
+    if (!hasObstacles())
+    {
+        return pos;
+    }
+
+    pos.x = sweepAxis(oldPos, pos.x, 0, objExtents);
+    pos.y = sweepAxis({ pos.x, oldPos.y }, pos.y, 1, objExtents);
+    return pos;
+}
+
+float World::sweepAxis(const glm::vec2& from, float to, int axis, const glm::vec2& objExtents) const
+{
+    // Tolerance used to stop objects resting against a wall from "catching" on it when sliding along it
+    static constexpr float skin = 0.001f;
+
+    float delta = to - from[axis];
+    if (delta == 0.f)
+    {
+        return to;
+    }
+
+    // Find everything in the area covered by the movement
+    int otherAxis = 1 - axis;
+    Rect sweptArea;
+    sweptArea.pos[axis] = from[axis] + delta / 2.f;
+    sweptArea.pos[otherAxis] = from[otherAxis];
+    sweptArea.extents[axis] = objExtents[axis] + std::abs(delta) / 2.f;
+    sweptArea.extents[otherAxis] = objExtents[otherAxis] - skin;
+
+    float result = to;
+    auto clipToObstacle = [&](const Rect& obstacle) {
+        if (delta > 0.f)
+        {
+            float limit = obstacle.pos[axis] - obstacle.extents[axis] - objExtents[axis];
+
+            // Ignore anything we are already overlapping, so that we can escape from it
+            if (limit >= from[axis] - skin)
+            {
+                result = std::min(result, limit);
+            }
+        }
+        else
+        {
+            float limit = obstacle.pos[axis] + obstacle.extents[axis] + objExtents[axis];
+            if (limit <= from[axis] + skin)
+            {
+                result = std::max(result, limit);
+            }
+        }
+    };
+
+    obstacleTree.query(sweptArea, clipToObstacle);
+    if (tileMap)
+    {
+        tileMap->forEachSolidTile(sweptArea, clipToObstacle);
+    }
+
+    return result;
+}
+
+void World::setObstacles(std::vector<Rect> newObstacles)
+{
+    obstacles = std::move(newObstacles);
+    obstacleTree.build(obstacles);
+    ++obstacleVersion;
+
+    // Block any cells that a player couldn't occupy
+    navGrid.clear();
+    for (const Rect& obstacle : obstacles)
+    {
+        navGrid.blockArea({ obstacle.pos, obstacle.extents + Player::extents });
+    }
+}
+
+bool World::isBlocked(const Rect& area) const
+{
+    bool blocked = false;
+    obstacleTree.query(area, [&](const Rect&) { blocked = true; });
+    if (tileMap && !blocked)
+    {
+        tileMap->forEachSolidTile(area, [&](const Rect&) { blocked = true; });
+    }
+    return blocked;
+}
+
+void World::updateTileMap()
+{
+    if (!tileMap)
+    {
+        return;
+    }
+
+    focusPoints.clear();
+    for (const Player& player : players)
+    {
+        focusPoints.push_back(player.getRect().pos);
+    }
+    tileMap->update(focusPoints);
+}
+
+void World::updateFlowFields()
+{
+    for (const Player& player : players)
+    {
+        flowFields[player.getPlayerId()].update(player.getRect().pos);
+    }
+}
+
 void World::reset()
 {
     reset(static_cast<int>(players.size()));
@@ -31,6 +151,8 @@ void World::reset(int numPlayers)
     taggedPlayer = nullptr;
 
     players.clear();
+    pickups.clear();
+    timers.clear();
 
     // Player 1
     float p1x = numPlayers == 3 ? 0.f : -playerOrigin.x;
@@ -50,4 +172,7 @@ void World::reset(int numPlayers)
     {
         players.emplace_back(3, this, glm::vec2(playerOrigin.x, -playerOrigin.y), Color::yellow);
     }
+
+    // Make sure the tiles around the spawn points are ready before anyone moves
+    updateTileMap();
 }
@@ -0,0 +1,69 @@
+#include "WorldFeed.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "Player.h"
+#include "World.h"
+
+WorldFeed::WorldFeed(const std::string& name)
+    : sharedMemory(name, sizeof(TagFeedHeader))
+    , header(static_cast<TagFeedHeader*>(sharedMemory.getData()))
+{
+    // Readers check the magic number last, so write everything else first
+    std::memset(header, 0, sizeof(TagFeedHeader));
+    header->version = TAG_FEED_VERSION;
+    header->frameSize = sizeof(TagFeedFrame);
+    header->ringSize = TAG_FEED_RING_SIZE;
+    std::atomic_ref<uint32_t>(header->magic).store(TAG_FEED_MAGIC, std::memory_order_release);
+}
+
+void WorldFeed::publish(const World& world)
+{
+    ++tick;
+
+    // Build the new frame locally so that the shared copy is held "open" for as short a time as possible
+    TagFeedFrame newFrame {};
+    const std::vector<Player>& players = world.getPlayers();
+    newFrame.tick = tick;
+    newFrame.numPlayers = static_cast<int32_t>(std::min(players.size(), size_t(TAG_FEED_MAX_PLAYERS)));
+
+    const Player* taggedPlayer = world.getTaggedPlayer();
+    newFrame.taggedPlayerId = taggedPlayer ? taggedPlayer->getPlayerId() : TAG_FEED_NO_PLAYER;
+
+    for (int i = 0; i < newFrame.numPlayers; ++i)
+    {
+        const Player& player = players[i];
+        const Rect rect = player.getRect();
+        const Color col = player.getColor();
+
+        TagFeedPlayer& feedPlayer = newFrame.players[i];
+        feedPlayer.playerId = player.getPlayerId();
+        feedPlayer.x = rect.pos.x;
+        feedPlayer.y = rect.pos.y;
+        feedPlayer.r = col.r;
+        feedPlayer.g = col.g;
+        feedPlayer.b = col.b;
+        feedPlayer.a = col.a;
+        feedPlayer.timeRemainingRatio = player.getTimeRemainingRatio();
+    }
+
+    // Seqlock write: odd sequence, frame data, even sequence.
+    // The release fence stops the frame data being written before readers can see the odd sequence.
+    TagFeedFrame& frame = header->frames[tick & (TAG_FEED_RING_SIZE - 1)];
+    std::atomic_ref<uint32_t> sequence(frame.sequence);
+    uint32_t seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    frame.numPlayers = newFrame.numPlayers;
+    frame.tick = newFrame.tick;
+    frame.taggedPlayerId = newFrame.taggedPlayerId;
+    std::memcpy(frame.players, newFrame.players, sizeof(frame.players));
+
+    sequence.store(seq + 2, std::memory_order_release);
+
+    // Let readers know that a new frame is available
+    std::atomic_ref<uint64_t>(header->latestTick).store(tick, std::memory_order_release);
+}